@@ -0,0 +1,241 @@
+#ifndef ALLOCX_BENCH_REPORT_HPP
+#define ALLOCX_BENCH_REPORT_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef ALLOCX_BUILD_FLAGS
+#define ALLOCX_BUILD_FLAGS "unknown"
+#endif
+
+namespace allocx {
+namespace bench {
+
+/**
+ * @brief One benchmark measurement from one repetition
+ *
+ * Metrics are kept in insertion order so that reports list columns in the
+ * order the harness produced them (avg_ns, p50_ns, ...).
+ */
+struct Sample {
+  std::string benchmark;
+  size_t run = 0;
+  std::vector<std::pair<std::string, double>> metrics;
+
+  /**
+   * @brief Look up a metric by name
+   * @return true and sets value if present
+   */
+  bool get(const std::string &name, double &value) const {
+    for (const auto &metric : metrics) {
+      if (metric.first == name) {
+        value = metric.second;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * @brief Build and host description attached to every report
+ */
+struct Environment {
+  std::string cpu;
+  std::string compiler;
+  std::string flags;
+  std::string timestamp;
+
+  static Environment capture() {
+    Environment env;
+    env.cpu = "unknown";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+      if (line.compare(0, 10, "model name") == 0) {
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+          env.cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+        break;
+      }
+    }
+#if defined(__clang__)
+    env.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    env.compiler = std::string("gcc ") + __VERSION__;
+#else
+    env.compiler = "unknown";
+#endif
+    env.flags = ALLOCX_BUILD_FLAGS;
+
+    char buffer[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ",
+                  std::gmtime(&now));
+    env.timestamp = buffer;
+    return env;
+  }
+};
+
+/**
+ * @brief Collects samples and writes them as JSON or CSV
+ *
+ * CSV layout (consumed by allocx_bench_compare):
+ *   # key=value environment lines
+ *   benchmark,run,<metric>,<metric>,...
+ * Benchmark names must not contain commas or double quotes.
+ */
+class Report {
+public:
+  Report() : m_env(Environment::capture()) {}
+
+  void add(Sample sample) { m_samples.push_back(std::move(sample)); }
+
+  const std::vector<Sample> &samples() const noexcept { return m_samples; }
+  const Environment &environment() const noexcept { return m_env; }
+
+  bool write_json(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out)
+      return false;
+
+    out << "{\n  \"environment\": {\n";
+    out << "    \"cpu\": \"" << escape(m_env.cpu) << "\",\n";
+    out << "    \"compiler\": \"" << escape(m_env.compiler) << "\",\n";
+    out << "    \"flags\": \"" << escape(m_env.flags) << "\",\n";
+    out << "    \"timestamp\": \"" << escape(m_env.timestamp) << "\"\n";
+    out << "  },\n  \"results\": [";
+    for (size_t i = 0; i < m_samples.size(); ++i) {
+      const Sample &sample = m_samples[i];
+      out << (i ? ",\n" : "\n") << "    {\"benchmark\": \""
+          << escape(sample.benchmark) << "\", \"run\": " << sample.run;
+      for (const auto &metric : sample.metrics) {
+        out << ", \"" << escape(metric.first) << "\": " << metric.second;
+      }
+      out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+  }
+
+  bool write_csv(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out)
+      return false;
+
+    out << "# cpu=" << m_env.cpu << "\n";
+    out << "# compiler=" << m_env.compiler << "\n";
+    out << "# flags=" << m_env.flags << "\n";
+    out << "# timestamp=" << m_env.timestamp << "\n";
+
+    std::vector<std::string> columns = metric_names();
+    out << "benchmark,run";
+    for (const std::string &column : columns) {
+      out << "," << column;
+    }
+    out << "\n";
+
+    for (const Sample &sample : m_samples) {
+      out << sample.benchmark << "," << sample.run;
+      for (const std::string &column : columns) {
+        double value = 0;
+        out << ",";
+        if (sample.get(column, value)) {
+          out << value;
+        }
+      }
+      out << "\n";
+    }
+    return static_cast<bool>(out);
+  }
+
+  /**
+   * @brief Load samples from a CSV file written by write_csv()
+   */
+  static bool read_csv(const std::string &path, std::vector<Sample> &out) {
+    std::ifstream in(path);
+    if (!in)
+      return false;
+
+    std::string line;
+    std::vector<std::string> columns;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#')
+        continue;
+      std::vector<std::string> fields = split(line);
+      if (columns.empty()) {
+        columns = fields;
+        if (columns.size() < 2 || columns[0] != "benchmark")
+          return false;
+        continue;
+      }
+
+      Sample sample;
+      sample.benchmark = fields[0];
+      sample.run = fields.size() > 1 ? std::stoul(fields[1]) : 0;
+      for (size_t i = 2; i < fields.size() && i < columns.size(); ++i) {
+        if (!fields[i].empty()) {
+          sample.metrics.emplace_back(columns[i], std::stod(fields[i]));
+        }
+      }
+      out.push_back(std::move(sample));
+    }
+    return !columns.empty();
+  }
+
+private:
+  std::vector<std::string> metric_names() const {
+    std::vector<std::string> names;
+    for (const Sample &sample : m_samples) {
+      for (const auto &metric : sample.metrics) {
+        if (std::find(names.begin(), names.end(), metric.first) ==
+            names.end()) {
+          names.push_back(metric.first);
+        }
+      }
+    }
+    return names;
+  }
+
+  static std::vector<std::string> split(const std::string &line) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+      fields.push_back(field);
+    }
+    return fields;
+  }
+
+  static std::string escape(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+      if (c == '"' || c == '\\') {
+        escaped += '\\';
+        escaped += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+        escaped += buffer;
+      } else {
+        escaped += c;
+      }
+    }
+    return escaped;
+  }
+
+  Environment m_env;
+  std::vector<Sample> m_samples;
+};
+
+} // namespace bench
+} // namespace allocx
+
+#endif // ALLOCX_BENCH_REPORT_HPP
@@ -1,14 +1,38 @@
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <sched.h>
+#include <unistd.h>
+
+#include "bench_report.hpp"
+#include "perf_counters.hpp"
+
+#include "allocx/bitmap_pool_allocator.hpp"
+#include "allocx/buddy_allocator.hpp"
 #include "allocx/freelist_allocator.hpp"
+#include "allocx/handle_pool.hpp"
+#include "allocx/numa_pool_selector.hpp"
+#include "allocx/offset_ptr.hpp"
+#include "allocx/large_object_allocator.hpp"
+#include "allocx/persistent_arena.hpp"
 #include "allocx/pool_allocator.hpp"
+#include "allocx/shared_pool_allocator.hpp"
+#include "allocx/slab_cache.hpp"
 #include "allocx/stack_allocator.hpp"
+#include "allocx/thread_local_arena.hpp"
+#include "allocx/thread_safe.hpp"
+#include "allocx/trim_service.hpp"
 
 using namespace allocx;
 using Clock = std::chrono::high_resolution_clock;
@@ -23,8 +47,94 @@ struct BenchmarkResult {
   double p99_ns;
   double min_ns;
   double max_ns;
+  std::vector<bench::PerfCounters::Value> counters; // Per-op, if available
 };
 
+// Harness state shared by all benchmarks
+struct Harness {
+  bench::Report report;
+  std::string section; // Prefix for recorded benchmark names
+  size_t run = 0;      // Current repetition
+  bool verbose = true; // Human-readable output (first repetition only)
+  std::unique_ptr<bench::PerfCounters> perf; // Null or unavailable: wall clock only
+};
+
+Harness g_harness;
+
+// Human-readable output sink; silent after the first repetition
+std::ostream &out() {
+  static std::ostream null_stream(nullptr);
+  return g_harness.verbose ? std::cout : null_stream;
+}
+
+BenchmarkResult summarize(std::vector<double> &times) {
+  std::sort(times.begin(), times.end());
+
+  size_t n = times.size();
+  BenchmarkResult result;
+  result.avg_ns = std::accumulate(times.begin(), times.end(), 0.0) / n;
+  result.p50_ns = times[n / 2];
+  result.p99_ns = times[n * 99 / 100];
+  result.min_ns = times.front();
+  result.max_ns = times.back();
+  return result;
+}
+
+void start_counters() {
+  if (g_harness.perf && g_harness.perf->available()) {
+    g_harness.perf->start();
+  }
+}
+
+// Counts since start_counters(), divided by the number of operations. Call
+// right after the timed loop, before any post-processing such as summarize().
+std::vector<bench::PerfCounters::Value> stop_counters(size_t operations) {
+  std::vector<bench::PerfCounters::Value> counters;
+  if (!g_harness.perf || !g_harness.perf->available())
+    return counters;
+  g_harness.perf->stop();
+  for (const auto &value : g_harness.perf->values()) {
+    counters.push_back(
+        {value.name, value.count / static_cast<double>(operations)});
+  }
+  return counters;
+}
+
+void print_counters(const BenchmarkResult &result) {
+  if (result.counters.empty())
+    return;
+  double cycles = 0;
+  double instructions = 0;
+  out() << "    Counters/op:";
+  for (const auto &counter : result.counters) {
+    out() << " " << counter.name << "=" << counter.count;
+    if (std::strcmp(counter.name, "cycles") == 0)
+      cycles = counter.count;
+    if (std::strcmp(counter.name, "instructions") == 0)
+      instructions = counter.count;
+  }
+  if (cycles > 0 && instructions > 0) {
+    out() << " ipc=" << instructions / cycles;
+  }
+  out() << "\n";
+}
+
+void record_result(const char *name, const BenchmarkResult &result) {
+  bench::Sample sample;
+  sample.benchmark = g_harness.section + "/" + name;
+  sample.run = g_harness.run;
+  sample.metrics = {{"avg_ns", result.avg_ns},
+                    {"p50_ns", result.p50_ns},
+                    {"p99_ns", result.p99_ns},
+                    {"min_ns", result.min_ns},
+                    {"max_ns", result.max_ns}};
+  for (const auto &counter : result.counters) {
+    sample.metrics.emplace_back(std::string(counter.name) + "_per_op",
+                                counter.count);
+  }
+  g_harness.report.add(std::move(sample));
+}
+
 template <typename Func>
 BenchmarkResult run_benchmark(const char *name, size_t iterations,
                               Func &&func) {
@@ -36,7 +146,8 @@ BenchmarkResult run_benchmark(const char *name, size_t iterations,
     func();
   }
 
-  // Actual benchmark
+  // Actual benchmark (counters include the clock reads around each call)
+  start_counters();
   for (size_t i = 0; i < iterations; ++i) {
     auto start = Clock::now();
     func();
@@ -45,21 +156,18 @@ BenchmarkResult run_benchmark(const char *name, size_t iterations,
         std::chrono::duration<double, std::nano>(end - start).count());
   }
 
-  std::sort(times.begin(), times.end());
+  auto counters = stop_counters(iterations);
+  BenchmarkResult result = summarize(times);
+  result.counters = std::move(counters);
+  record_result(name, result);
 
-  BenchmarkResult result;
-  result.avg_ns = std::accumulate(times.begin(), times.end(), 0.0) / iterations;
-  result.p50_ns = times[iterations / 2];
-  result.p99_ns = times[iterations * 99 / 100];
-  result.min_ns = times.front();
-  result.max_ns = times.back();
-
-  std::cout << "  " << name << ":\n";
-  std::cout << "    Avg: " << result.avg_ns << " ns\n";
-  std::cout << "    P50: " << result.p50_ns << " ns\n";
-  std::cout << "    P99: " << result.p99_ns << " ns\n";
-  std::cout << "    Min: " << result.min_ns << " ns, Max: " << result.max_ns
-            << " ns\n";
+  out() << "  " << name << ":\n";
+  out() << "    Avg: " << result.avg_ns << " ns\n";
+  out() << "    P50: " << result.p50_ns << " ns\n";
+  out() << "    P99: " << result.p99_ns << " ns\n";
+  out() << "    Min: " << result.min_ns << " ns, Max: " << result.max_ns
+        << " ns\n";
+  print_counters(result);
 
   return result;
 }
@@ -69,7 +177,8 @@ BenchmarkResult run_benchmark(const char *name, size_t iterations,
 // ============================================================================
 
 void benchmark_stack_allocator() {
-  std::cout << "\n=== Stack Allocator Benchmarks ===\n";
+  out() << "\n=== Stack Allocator Benchmarks ===\n";
+  g_harness.section = "Stack";
 
   constexpr size_t POOL_SIZE = 1024 * 1024; // 1MB
   constexpr size_t ITERATIONS = 100000;
@@ -84,8 +193,16 @@ void benchmark_stack_allocator() {
     stack.reset();
   });
 
+  // Same pattern through the per-thread registry accessor
+  run_benchmark("tls_frame() Alloc (64B)", ITERATIONS, [&]() {
+    StackAllocator &frame = tls_frame();
+    void *ptr = frame.allocate(ALLOC_SIZE);
+    (void)ptr;
+    frame.reset();
+  });
+
   // Burst allocation benchmark
-  std::cout << "\n  Burst Alloc (1000 x 64B):\n";
+  out() << "\n  Burst Alloc (1000 x 64B):\n";
   {
     auto start = Clock::now();
     for (size_t i = 0; i < 1000; ++i) {
@@ -95,7 +212,7 @@ void benchmark_stack_allocator() {
     auto end = Clock::now();
     double total_ns =
         std::chrono::duration<double, std::nano>(end - start).count();
-    std::cout << "    Total: " << total_ns / 1000 << " ns/alloc\n";
+    out() << "    Total: " << total_ns / 1000 << " ns/alloc\n";
     stack.reset();
   }
 
@@ -108,7 +225,8 @@ void benchmark_stack_allocator() {
 // ============================================================================
 
 void benchmark_pool_allocator() {
-  std::cout << "\n=== Pool Allocator Benchmarks ===\n";
+  out() << "\n=== Pool Allocator Benchmarks ===\n";
+  g_harness.section = "Pool";
 
   constexpr size_t CHUNK_SIZE = 64;
   constexpr size_t CHUNK_COUNT = 10000;
@@ -123,7 +241,7 @@ void benchmark_pool_allocator() {
   });
 
   // Multiple alloc then dealloc
-  std::cout << "\n  Burst Alloc + Dealloc (1000 chunks):\n";
+  out() << "\n  Burst Alloc + Dealloc (1000 chunks):\n";
   {
     std::vector<void *> ptrs;
     ptrs.reserve(1000);
@@ -143,9 +261,37 @@ void benchmark_pool_allocator() {
     double dealloc_ns =
         std::chrono::duration<double, std::nano>(dealloc_end - alloc_end)
             .count();
-    std::cout << "    Alloc: " << alloc_ns / 1000 << " ns/op\n";
-    std::cout << "    Dealloc: " << dealloc_ns / 1000 << " ns/op\n";
+    out() << "    Alloc: " << alloc_ns / 1000 << " ns/op\n";
+    out() << "    Dealloc: " << dealloc_ns / 1000 << " ns/op\n";
+  }
+
+  // Enumerating live chunks: occupancy bitmap vs a side vector of pointers
+  PoolOptions options;
+  options.track_occupancy = true;
+  PoolAllocator tracked(CHUNK_SIZE, CHUNK_COUNT, alignof(std::max_align_t),
+                        options);
+  std::vector<void *> live;
+  for (size_t i = 0; i < CHUNK_COUNT; ++i) {
+    live.push_back(std::memset(tracked.allocate(), 1, CHUNK_SIZE));
+  }
+  std::mt19937 rng(42);
+  std::shuffle(live.begin(), live.end(), rng);
+  for (size_t i = CHUNK_COUNT / 2; i < CHUNK_COUNT; ++i) {
+    tracked.deallocate(live[i]);
   }
+  live.resize(CHUNK_COUNT / 2);
+
+  size_t touched = 0; // Read each chunk as a real iteration would
+  run_benchmark("Iterate Live (occupancy bitmap)", 100, [&]() {
+    tracked.for_each_allocated(
+        [&](void *ptr) { touched += *static_cast<volatile char *>(ptr); });
+  });
+  run_benchmark("Iterate Live (pointer vector)", 100, [&]() {
+    for (void *ptr : live) {
+      touched += *static_cast<volatile char *>(ptr);
+    }
+  });
+  out() << "    Touched: " << touched << "\n";
 }
 
 // ============================================================================
@@ -153,7 +299,8 @@ void benchmark_pool_allocator() {
 // ============================================================================
 
 void benchmark_freelist_allocator() {
-  std::cout << "\n=== Free-List Allocator Benchmarks ===\n";
+  out() << "\n=== Free-List Allocator Benchmarks ===\n";
+  g_harness.section = "FreeList";
 
   constexpr size_t POOL_SIZE = 1024 * 1024; // 1MB
   constexpr size_t ITERATIONS = 10000;
@@ -167,7 +314,7 @@ void benchmark_freelist_allocator() {
   });
 
   // Variable size allocations
-  std::cout << "\n  Variable Size Alloc (16B-256B):\n";
+  out() << "\n  Variable Size Alloc (16B-256B):\n";
   {
     std::mt19937 rng(42);
     std::vector<void *> ptrs;
@@ -190,9 +337,869 @@ void benchmark_freelist_allocator() {
     double dealloc_ns =
         std::chrono::duration<double, std::nano>(dealloc_end - alloc_end)
             .count();
-    std::cout << "    Alloc: " << alloc_ns / 500 << " ns/op\n";
-    std::cout << "    Dealloc: " << dealloc_ns / 500 << " ns/op\n";
+    out() << "    Alloc: " << alloc_ns / 500 << " ns/op\n";
+    out() << "    Dealloc: " << dealloc_ns / 500 << " ns/op\n";
+  }
+
+  // Recovering contiguous space from relocatable blocks in 16KB steps
+  out() << "\n  Incremental Defragment (16KB budget per step):\n";
+  {
+    FreeListAllocator handles(POOL_SIZE);
+    std::mt19937 rng(42);
+    std::vector<FreeListAllocator::Handle> live;
+    while (auto handle = handles.allocate_handle(16 + (rng() % 240))) {
+      live.push_back(handle);
+    }
+    for (size_t i = 0; i < live.size(); i += 2) {
+      handles.deallocate_handle(live[i]);
+    }
+    size_t before = handles.largest_free_block();
+
+    size_t steps = 0;
+    double worst_us = 0;
+    auto start = Clock::now();
+    for (;;) {
+      auto step_start = Clock::now();
+      size_t moved = handles.defragment(16 * 1024);
+      worst_us = std::max(worst_us, std::chrono::duration<double, std::micro>(
+                                        Clock::now() - step_start)
+                                        .count());
+      if (moved == 0)
+        break;
+      ++steps;
+    }
+    double total_us =
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count();
+    out() << "    Largest free block: " << before << " -> "
+          << handles.largest_free_block() << " bytes\n";
+    out() << "    Steps: " << steps << ", worst step: " << worst_us
+          << " us, total: " << total_us << " us\n";
+  }
+
+  // Fragmentation left behind by each strategy under the same churn
+  out() << "\n  Fragmentation after churn (16B-1KB, 50k ops):\n";
+  const std::pair<FreeListAllocator::Strategy, const char *> strategies[] = {
+      {FreeListAllocator::Strategy::FirstFit, "FirstFit"},
+      {FreeListAllocator::Strategy::BestFit, "BestFit"},
+      {FreeListAllocator::Strategy::WorstFit, "WorstFit"}};
+  for (const auto &strategy : strategies) {
+    FreeListAllocator churn(POOL_SIZE, strategy.first);
+    std::mt19937 rng(42);
+    std::vector<void *> live(512, nullptr);
+    size_t failures = 0;
+    for (size_t i = 0; i < 50000; ++i) {
+      void *&slot = live[rng() % live.size()];
+      churn.deallocate(slot);
+      slot = churn.allocate(16 + rng() % 1008);
+      failures += slot == nullptr;
+    }
+    FreeListAllocator::Metrics m = churn.metrics();
+    out() << "    " << strategy.second << ": " << m.free_blocks
+          << " free blocks, largest " << m.largest_free_block
+          << " B, fragmentation " << m.external_fragmentation
+          << ", failed allocs " << failures << "\n";
+    for (void *ptr : live) {
+      churn.deallocate(ptr);
+    }
+  }
+}
+
+// ============================================================================
+// Bitmap Pool Allocator Benchmarks
+// ============================================================================
+
+// Replace a random live chunk with a new one
+template <typename Allocator>
+void pool_churn_step(Allocator &alloc, std::vector<void *> &live,
+                     std::mt19937 &rng) {
+  void *&slot = live[rng() % live.size()];
+  alloc.deallocate(slot);
+  slot = alloc.allocate();
+}
+
+void benchmark_bitmap_pool_allocator() {
+  out() << "\n=== Bitmap Pool Allocator Benchmarks ===\n";
+  g_harness.section = "BitmapPool";
+
+  constexpr size_t CHUNK_SIZE = 64;
+  constexpr size_t CHUNK_COUNT = 10000;
+  constexpr size_t ITERATIONS = 100000;
+  constexpr size_t LIVE_CHUNKS = CHUNK_COUNT / 2;
+
+  BitmapPoolAllocator bitmap(CHUNK_SIZE, CHUNK_COUNT);
+
+  run_benchmark("Alloc + Dealloc (64B)", ITERATIONS, [&]() {
+    void *ptr = bitmap.allocate();
+    bitmap.deallocate(ptr);
+  });
+
+  // Random churn at 50% occupancy on both pools
+  std::vector<void *> live(LIVE_CHUNKS);
+  for (void *&ptr : live) {
+    ptr = bitmap.allocate();
+  }
+  std::mt19937 rng(42);
+  run_benchmark("Churn (50% live) Bitmap", ITERATIONS,
+                [&]() { pool_churn_step(bitmap, live, rng); });
+
+  // Visit every live object in address order
+  size_t visited = 0;
+  run_benchmark("Iterate Live (5000 chunks)", 100, [&]() {
+    bitmap.for_each_allocated([&](void *) { ++visited; });
+  });
+  out() << "    Visited: " << visited << " chunks\n";
+
+  PoolAllocator pool(CHUNK_SIZE, CHUNK_COUNT);
+  for (void *&ptr : live) {
+    ptr = pool.allocate();
+  }
+  rng.seed(42);
+  run_benchmark("Churn (50% live) Pool", ITERATIONS,
+                [&]() { pool_churn_step(pool, live, rng); });
+}
+
+// ============================================================================
+// Large Object Allocator Benchmarks
+// ============================================================================
+
+void benchmark_large_object_allocator() {
+  out() << "\n=== Large Object Allocator Benchmarks ===\n";
+  g_harness.section = "LargeObject";
+
+  constexpr size_t SIZE = 4 * 1024 * 1024;
+  constexpr size_t ITERATIONS = 1000;
+
+  // Touch one byte per page so page-fault costs are included
+  auto touch = [](void *ptr, size_t size) {
+    char *bytes = static_cast<char *>(ptr);
+    for (size_t i = 0; i < size; i += 4096)
+      bytes[i] = 1;
+  };
+
+  LargeObjectOptions uncached_options;
+  uncached_options.cache_entries = 0;
+  LargeObjectAllocator uncached(uncached_options);
+  run_benchmark("Alloc + Touch + Free 4MB (mmap)", ITERATIONS, [&]() {
+    void *ptr = uncached.allocate(SIZE);
+    touch(ptr, SIZE);
+    uncached.deallocate(ptr);
+  });
+
+  LargeObjectAllocator cached;
+  run_benchmark("Alloc + Touch + Free 4MB (cached)", ITERATIONS, [&]() {
+    void *ptr = cached.allocate(SIZE);
+    touch(ptr, SIZE);
+    cached.deallocate(ptr);
+  });
+
+  run_benchmark("Alloc + Touch + Free 4MB (malloc)", ITERATIONS, [&]() {
+    void *ptr = std::malloc(SIZE);
+    touch(ptr, SIZE);
+    std::free(ptr);
+  });
+
+  // Doubling growth from 64KB to 32MB with the data kept intact
+  constexpr size_t GROW_FROM = 64 * 1024;
+  constexpr size_t GROW_TO = 32 * 1024 * 1024;
+  run_benchmark("Grow 64KB-32MB (mremap)", 50, [&]() {
+    void *ptr = cached.allocate(GROW_FROM);
+    for (size_t size = GROW_FROM; size < GROW_TO; size *= 2) {
+      touch(ptr, size);
+      ptr = cached.reallocate(ptr, size, size * 2);
+    }
+    cached.deallocate(ptr);
+  });
+
+  run_benchmark("Grow 64KB-32MB (malloc + copy)", 50, [&]() {
+    void *ptr = std::malloc(GROW_FROM);
+    for (size_t size = GROW_FROM; size < GROW_TO; size *= 2) {
+      touch(ptr, size);
+      void *moved = std::malloc(size * 2);
+      std::memcpy(moved, ptr, size);
+      std::free(ptr);
+      ptr = moved;
+    }
+    std::free(ptr);
+  });
+}
+
+// ============================================================================
+// Shared Pool Allocator Benchmarks
+// ============================================================================
+
+void benchmark_shared_pool_allocator() {
+  out() << "\n=== Shared Pool Allocator Benchmarks ===\n";
+  g_harness.section = "SharedPool";
+
+  constexpr size_t MESSAGE_SIZE = 32 * 1024;
+  constexpr size_t ITERATIONS = 100000;
+
+  auto pool = SharedPoolAllocator::create(64, 10000);
+  if (!pool) {
+    out() << "  (shared memory unavailable, skipped)\n";
+    return;
+  }
+
+  run_benchmark("Alloc + Dealloc (64B)", ITERATIONS, [&]() {
+    void *ptr = pool->allocate();
+    pool->deallocate(ptr);
+  });
+
+  // Producer -> consumer hand-off through a pipe, as between two
+  // processes: copying the message vs sending its chunk offset
+  int fds[2];
+  if (::pipe(fds) != 0)
+    return;
+
+  std::vector<char> message(MESSAGE_SIZE, 'q');
+  std::vector<char> received(MESSAGE_SIZE);
+  run_benchmark("Pass 32KB Message (pipe copy)", ITERATIONS, [&]() {
+    message[0] = 'a';
+    if (::write(fds[1], message.data(), MESSAGE_SIZE) != MESSAGE_SIZE ||
+        ::read(fds[0], received.data(), MESSAGE_SIZE) != MESSAGE_SIZE)
+      std::abort();
+  });
+
+  auto messages = SharedPoolAllocator::create(MESSAGE_SIZE, 64);
+  run_benchmark("Pass 32KB Message (shared offset)", ITERATIONS, [&]() {
+    char *chunk = static_cast<char *>(messages->allocate());
+    chunk[0] = 'a';
+    SharedPoolAllocator::offset_type offset = messages->offset_of(chunk);
+    if (::write(fds[1], &offset, sizeof(offset)) != sizeof(offset) ||
+        ::read(fds[0], &offset, sizeof(offset)) != sizeof(offset))
+      std::abort();
+    messages->deallocate(messages->from_offset(offset));
+  });
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+// ============================================================================
+// Persistent Arena Benchmarks
+// ============================================================================
+
+struct RefDataNode {
+  uint64_t key;
+  double values[6];
+  offset_ptr<RefDataNode> next;
+};
+
+void benchmark_persistent_arena() {
+  out() << "\n=== Persistent Arena Benchmarks ===\n";
+  g_harness.section = "Persistent";
+
+  constexpr size_t NODES = 200000;
+  const char *path = "allocx_bench.arena";
+
+  // Cold start: rebuild the object graph on the heap
+  run_benchmark("Rebuild 200k Nodes (new) + Traverse", 20, [&]() {
+    RefDataNode *head = nullptr;
+    for (size_t i = 0; i < NODES; ++i) {
+      head = new RefDataNode{i, {double(i)}, head};
+    }
+    uint64_t sum = 0;
+    for (RefDataNode *node = head; node;) {
+      sum += node->key;
+      RefDataNode *next = node->next.get();
+      delete node;
+      node = next;
+    }
+    if (sum == 0)
+      std::abort();
+  });
+
+  {
+    auto arena = PersistentArena::create(path, NODES * sizeof(RefDataNode) * 2);
+    if (!arena) {
+      out() << "  (cannot create " << path << ", skipped)\n";
+      return;
+    }
+    RefDataNode *head = nullptr;
+    for (size_t i = 0; i < NODES; ++i) {
+      void *mem = arena->allocate(sizeof(RefDataNode), alignof(RefDataNode));
+      head = new (mem) RefDataNode{i, {double(i)}, head};
+    }
+    arena->set_root(head);
+    arena->checkpoint();
+  }
+
+  // Warm start: map the checkpoint; nodes fault in as they are visited
+  run_benchmark("Open Snapshot", 20, [&]() {
+    auto arena = PersistentArena::open(path);
+    if (!arena || !arena->root<RefDataNode>())
+      std::abort();
+  });
+
+  run_benchmark("Open Snapshot + Traverse", 20, [&]() {
+    auto arena = PersistentArena::open(path);
+    uint64_t sum = 0;
+    for (RefDataNode *node = arena->root<RefDataNode>(); node;
+         node = node->next.get()) {
+      sum += node->key;
+    }
+    if (sum == 0)
+      std::abort();
+  });
+
+  std::remove(path);
+}
+
+// ============================================================================
+// NUMA Benchmarks
+// ============================================================================
+
+void benchmark_numa() {
+  out() << "\n=== NUMA Benchmarks ===\n";
+  g_harness.section = "NUMA";
+
+  constexpr size_t CHASE_BYTES = 64 * 1024 * 1024;
+  constexpr size_t LINE = 64;
+  constexpr size_t HOPS = 100000;
+
+  // Stay on one CPU so "local" keeps meaning the same node
+  cpu_set_t saved;
+  bool pinned = ::sched_getaffinity(0, sizeof(saved), &saved) == 0;
+  if (pinned) {
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(::sched_getcpu(), &one);
+    pinned = ::sched_setaffinity(0, sizeof(one), &one) == 0;
+  }
+
+  size_t nodes = os::numa_node_count();
+  int local = os::current_numa_node();
+  out() << "  " << nodes << " NUMA node(s), running on node " << local
+        << "\n";
+  if (nodes == 1)
+    out() << "  (single node: only local access can be measured)\n";
+
+  // Dependent loads over a random cycle of cache lines bound to each node
+  for (size_t node = 0; node < nodes; ++node) {
+    void *memory = os::map(CHASE_BYTES);
+    if (!memory)
+      continue;
+    bool bound = os::set_numa_policy(memory, CHASE_BYTES, os::NumaPolicy::bind,
+                                     static_cast<int>(node));
+
+    size_t lines = CHASE_BYTES / LINE;
+    std::vector<size_t> order(lines);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(42));
+    char *base = static_cast<char *>(memory);
+    for (size_t i = 0; i < lines; ++i) {
+      *reinterpret_cast<void **>(base + order[i] * LINE) =
+          base + order[(i + 1) % lines] * LINE;
+    }
+
+    std::string name = "Pointer Chase Node " + std::to_string(node) +
+                       (static_cast<int>(node) == local ? " (local)"
+                                                        : " (remote)");
+    if (!bound)
+      name += " (unbound)";
+    void *cursor = base;
+    BenchmarkResult result = run_benchmark(name.c_str(), 20, [&]() {
+      for (size_t i = 0; i < HOPS; ++i) {
+        cursor = *static_cast<void **>(cursor);
+      }
+    });
+    out() << "    Per access: " << result.avg_ns / HOPS << " ns\n";
+    if (cursor == nullptr)
+      std::abort();
+    os::unmap(memory, CHASE_BYTES);
   }
+
+  if (pinned)
+    ::sched_setaffinity(0, sizeof(saved), &saved);
+
+  // Selector overhead vs a single locked pool
+  constexpr size_t ITERATIONS = 100000;
+  NumaPoolSelector selector(64, 10000);
+  run_benchmark("NumaPoolSelector Alloc + Dealloc (64B)", ITERATIONS, [&]() {
+    selector.deallocate(selector.allocate());
+  });
+
+  PoolAllocator pool(64, 10000);
+  ThreadSafeAllocator<PoolAllocator> locked(pool);
+  run_benchmark("Pool + Mutex Alloc + Dealloc (64B)", ITERATIONS, [&]() {
+    locked.deallocate(locked.allocate(64));
+  });
+}
+
+// ============================================================================
+// Prefault Benchmarks
+// ============================================================================
+
+/**
+ * @brief Time only the first use of freshly constructed allocators
+ *
+ * make() builds a new allocator per trial (untimed); use() runs the
+ * first allocation and write on it. Allocators stay alive until the end
+ * so the heap cannot hand recycled, already-faulted pages to the next
+ * trial. No hardware counters are attached, since they would include
+ * construction.
+ */
+template <typename Make, typename Use>
+BenchmarkResult run_first_use(const char *name, size_t trials, Make &&make,
+                              Use &&use) {
+  std::vector<double> times;
+  times.reserve(trials);
+  std::vector<decltype(make())> allocators;
+  allocators.reserve(trials);
+  for (size_t i = 0; i < trials; ++i) {
+    allocators.push_back(make());
+    auto start = Clock::now();
+    use(*allocators.back());
+    auto end = Clock::now();
+    times.push_back(
+        std::chrono::duration<double, std::nano>(end - start).count());
+  }
+
+  BenchmarkResult result = summarize(times);
+  record_result(name, result);
+  out() << "  " << name << ":\n";
+  out() << "    Avg: " << result.avg_ns << " ns\n";
+  out() << "    P50: " << result.p50_ns << " ns\n";
+  out() << "    P99: " << result.p99_ns << " ns\n";
+  return result;
+}
+
+void benchmark_prefault() {
+  out() << "\n=== Prefault Benchmarks ===\n";
+  g_harness.section = "Prefault";
+
+  constexpr size_t TRIALS = 200;
+  constexpr size_t STACK_SIZE = 256 * 1024;
+  constexpr size_t FIRST_BYTES = 64 * 1024;
+  constexpr size_t PACKET_SIZE = 16 * 1024;
+
+  // First 64KB of a fresh stack: 16 page faults unless prefaulted
+  auto stack_use = [&](StackAllocator &stack) {
+    std::memset(stack.allocate(FIRST_BYTES), 1, FIRST_BYTES);
+  };
+  run_first_use("Stack First 64KB (cold)", TRIALS,
+                [&]() { return std::make_unique<StackAllocator>(STACK_SIZE); },
+                stack_use);
+  run_first_use("Stack First 64KB (prefault)", TRIALS, [&]() {
+    StackOptions options;
+    options.prefault = true;
+    return std::make_unique<StackAllocator>(STACK_SIZE, options);
+  }, stack_use);
+
+  // First 16KB packet buffer: building the free list only touches the
+  // first page of each chunk
+  auto pool_use = [&](PoolAllocator &pool) {
+    std::memset(pool.allocate(), 1, PACKET_SIZE);
+  };
+  run_first_use("Pool First 16KB Chunk (cold)", TRIALS,
+                [&]() { return std::make_unique<PoolAllocator>(PACKET_SIZE, 16); },
+                pool_use);
+  run_first_use("Pool First 16KB Chunk (prefault)", TRIALS, [&]() {
+    PoolOptions options;
+    options.prefault = true;
+    return std::make_unique<PoolAllocator>(
+        PACKET_SIZE, 16, alignof(std::max_align_t), options);
+  }, pool_use);
+  run_first_use("Pool First 16KB Chunk (prefault + mlock)", TRIALS, [&]() {
+    PoolOptions options;
+    options.prefault = true;
+    options.lock_memory = true;
+    return std::make_unique<PoolAllocator>(
+        PACKET_SIZE, 16, alignof(std::max_align_t), options);
+  }, pool_use);
+}
+
+// ============================================================================
+// Trim Benchmarks
+// ============================================================================
+
+// Resident set size of this process in bytes (from /proc/self/statm)
+size_t resident_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total = 0, resident = 0;
+  statm >> total >> resident;
+  return resident * os::page_size();
+}
+
+void benchmark_trim() {
+  out() << "\n=== Trim Benchmarks ===\n";
+  g_harness.section = "Trim";
+
+  // Idle footprint after a burst: every chunk touched, then all freed
+  constexpr size_t CHUNK = 4096;
+  constexpr size_t CHUNKS = 16384; // 64MB
+  void *buffer = os::map(CHUNK * CHUNKS);
+  PoolOptions trimmable;
+  trimmable.trimmable = true;
+  PoolAllocator pool(buffer, CHUNK * CHUNKS, CHUNK, CHUNK, trimmable);
+  std::vector<void *> chunks;
+  chunks.reserve(CHUNKS);
+  while (void *chunk = pool.allocate()) {
+    std::memset(chunk, 1, CHUNK);
+    chunks.push_back(chunk);
+  }
+  for (void *chunk : chunks)
+    pool.deallocate(chunk);
+
+  size_t before = resident_bytes();
+  auto start = Clock::now();
+  size_t released = pool.trim();
+  double trim_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  size_t after = resident_bytes();
+  out() << "  Idle RSS after 64MB pool burst:\n";
+  out() << "    Before trim: " << before / (1024 * 1024) << " MB\n";
+  out() << "    After trim: " << after / (1024 * 1024) << " MB ("
+        << released / (1024 * 1024) << " MB released in " << trim_ms
+        << " ms)\n";
+
+  // Cost of reusing released memory: a zero-fill fault per page. Chunks
+  // are kept, so every iteration takes a page not touched before.
+  pool.prefault();
+  run_benchmark("Pool Alloc + Touch 4KB (resident)", 1000, [&]() {
+    std::memset(pool.allocate(), 2, CHUNK);
+  });
+  pool.reset();
+  pool.trim();
+  run_benchmark("Pool Alloc + Touch 4KB (after trim)", 1000, [&]() {
+    std::memset(pool.allocate(), 2, CHUNK);
+  });
+
+  // Hot path with the trimmer running, then stopped. Both run after the
+  // thread has been created: glibc locks mutexes more cheaply while a
+  // process has never had a second thread, which would skew the baseline.
+  constexpr size_t ITERATIONS = 100000;
+  PoolAllocator small_pool(64, 10000, alignof(std::max_align_t), trimmable);
+  ThreadSafeAllocator<PoolAllocator> safe_pool(small_pool);
+  TrimOptions options;
+  options.interval = std::chrono::milliseconds(10);
+  TrimService trimmer(options);
+  trimmer.add(safe_pool);
+  trimmer.start();
+  run_benchmark("Pool + Mutex Alloc + Dealloc 64B (trimmer every 10ms)", ITERATIONS,
+                [&]() { safe_pool.deallocate(safe_pool.allocate(64)); });
+  trimmer.stop();
+  out() << "    Trimmer passes: " << trimmer.passes()
+        << ", busy skips: " << trimmer.busy_skips() << "\n";
+  run_benchmark("Pool + Mutex Alloc + Dealloc 64B (trimmer stopped)", ITERATIONS,
+                [&]() { safe_pool.deallocate(safe_pool.allocate(64)); });
+
+  trimmer.remove(small_pool);
+  os::unmap(buffer, CHUNK * CHUNKS);
+
+  // One budgeted pass over a large pool with a single free chunk, so
+  // nothing is released: the work the trimmer does while holding the
+  // owner's lock
+  constexpr size_t LARGE_CHUNKS = 1 << 20;
+  PoolAllocator large_pool(64, LARGE_CHUNKS, alignof(std::max_align_t), trimmable);
+  void *first = large_pool.allocate();
+  while (large_pool.allocate() != nullptr) {
+  }
+  large_pool.deallocate(first);
+  run_benchmark("Pool Trim Pass 4KB Budget (1M chunks in use)", 1000,
+                [&]() { large_pool.trim(4096); });
+}
+
+// ============================================================================
+// Free-List Prefetch Benchmarks
+// ============================================================================
+
+void benchmark_pool_prefetch() {
+  out() << "\n=== Pool Prefetch Benchmarks ===\n";
+  g_harness.section = "Pool Prefetch";
+
+  // 64MB of 64B chunks, far larger than the last-level cache, freed in
+  // random order so consecutive free-list links point anywhere
+  constexpr size_t CHUNK = 64;
+  constexpr size_t CHUNKS = 1024 * 1024;
+  constexpr size_t ITERATIONS = 200000;
+  constexpr size_t EVICT_BYTES = 64 * 1024 * 1024;
+  std::vector<char> evict(EVICT_BYTES);
+
+  uint64_t sink = 0;
+  auto run = [&](const char *name, bool prefetch) {
+    PoolOptions options;
+    options.prefetch = prefetch;
+    PoolAllocator pool(CHUNK, CHUNKS, alignof(std::max_align_t), options);
+    std::vector<void *> chunks;
+    chunks.reserve(CHUNKS);
+    while (void *chunk = pool.allocate())
+      chunks.push_back(chunk);
+    std::mt19937 rng(42);
+    std::shuffle(chunks.begin(), chunks.end(), rng);
+    for (void *chunk : chunks)
+      pool.deallocate(chunk);
+    std::memset(evict.data(), 1, EVICT_BYTES);
+
+    // Each op initializes the object and does a little dependent work,
+    // the window in which a prefetched next head can arrive
+    run_benchmark(name, ITERATIONS, [&]() {
+      auto *object = static_cast<uint64_t *>(pool.allocate());
+      uint64_t h = sink;
+      for (size_t i = 0; i < CHUNK / sizeof(uint64_t); ++i) {
+        h = h * 0x9E3779B97F4A7C15ull + i;
+        object[i] = h;
+      }
+      sink = h;
+    });
+  };
+  run("Cold Shuffled Alloc + Init 64B (no prefetch)", false);
+  run("Cold Shuffled Alloc + Init 64B (prefetch)", true);
+  out() << "    Checksum: " << sink % 997 << "\n";
+}
+
+// ============================================================================
+// Address-Ordered Pool Benchmarks
+// ============================================================================
+
+void benchmark_pool_address_order() {
+  out() << "\n=== Address-Ordered Pool Benchmarks ===\n";
+  g_harness.section = "Pool Address Order";
+
+  // 16MB of 64B chunks kept half full by random frees and refills
+  constexpr size_t CHUNK = 64;
+  constexpr size_t CHUNKS = 256 * 1024;
+  constexpr size_t ITERATIONS = 200000;
+  constexpr size_t BATCH = 4096;
+  const size_t page = os::page_size();
+
+  auto run = [&](const char *label, bool ordered) {
+    PoolOptions options;
+    options.address_ordered = ordered;
+    options.trimmable = true; // The LIFO pool is trimmed below too
+    PoolAllocator pool(CHUNK, CHUNKS, alignof(std::max_align_t), options);
+    std::vector<void *> live;
+    live.reserve(CHUNKS);
+    while (void *chunk = pool.allocate())
+      live.push_back(std::memset(chunk, 1, CHUNK));
+    std::mt19937 rng(42);
+    std::shuffle(live.begin(), live.end(), rng);
+    for (size_t i = CHUNKS / 2; i < CHUNKS; ++i)
+      pool.deallocate(live[i]);
+    live.resize(CHUNKS / 2);
+
+    // Long enough for every object to be replaced several times
+    auto churn = [&]() {
+      size_t victim = rng() % live.size();
+      pool.deallocate(live[victim]);
+      live[victim] = pool.allocate();
+    };
+    for (size_t i = 0; i < 10 * CHUNKS; ++i)
+      churn();
+    std::string name = std::string("Churn Free Random + Alloc 64B (") + label + ")";
+    run_benchmark(name.c_str(), ITERATIONS, churn);
+
+    // Objects allocated together, e.g. the nodes of one new structure
+    std::vector<char *> batch;
+    for (size_t i = 0; i < BATCH; ++i)
+      batch.push_back(static_cast<char *>(pool.allocate()));
+    size_t adjacent = 0;
+    for (size_t i = 1; i < BATCH; ++i)
+      adjacent += batch[i] == batch[i - 1] + CHUNK;
+    std::vector<uintptr_t> pages;
+    for (char *chunk : batch)
+      pages.push_back(reinterpret_cast<uintptr_t>(chunk) / page);
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+    out() << "    Next " << BATCH << " allocations: " << adjacent
+          << " adjacent pairs, " << pages.size() << " pages\n";
+    for (char *chunk : batch)
+      pool.deallocate(chunk);
+
+    // Shrink to a quarter: how much can be returned to the OS
+    for (size_t i = CHUNKS / 4; i < live.size(); ++i)
+      pool.deallocate(live[i]);
+    size_t released = pool.trim();
+    out() << "    Trim at 25% occupancy: " << released / 1024 << " KB of "
+          << CHUNK * CHUNKS / 1024 << " KB released\n";
+  };
+  run("LIFO", false);
+  run("address-ordered", true);
+}
+
+// ============================================================================
+// Slab Cache Benchmarks
+// ============================================================================
+
+void benchmark_slab_cache() {
+  out() << "\n=== Slab Cache Benchmarks ===\n";
+  g_harness.section = "SlabCache";
+
+  // Order-like object whose constructor dominates the cost of allocation
+  struct Order {
+    std::mutex lock;
+    std::vector<char> fills;
+    Order() { fills.reserve(256); }
+  };
+
+  constexpr size_t COUNT = 1024;
+  constexpr size_t ITERATIONS = 100000;
+
+  run_benchmark("new + delete", ITERATIONS, [&]() {
+    Order *order = new Order();
+    delete order;
+  });
+
+  PoolAllocator pool(sizeof(Order), COUNT, alignof(Order));
+  run_benchmark("Pool + construct/destroy", ITERATIONS, [&]() {
+    Order *order = new (pool.allocate()) Order();
+    order->~Order();
+    pool.deallocate(order);
+  });
+
+  SlabCache<Order> cache(COUNT);
+  run_benchmark("SlabCache acquire/release", ITERATIONS, [&]() {
+    Order *order = cache.acquire();
+    order->fills.clear();
+    cache.release(order);
+  });
+}
+
+// ============================================================================
+// Handle Pool Benchmarks
+// ============================================================================
+
+void benchmark_handle_pool() {
+  out() << "\n=== Handle Pool Benchmarks ===\n";
+  g_harness.section = "HandlePool";
+
+  struct Particle {
+    float position[3];
+    float velocity[3];
+  };
+
+  constexpr size_t CAPACITY = 100000;
+  constexpr size_t ITERATIONS = 100000;
+
+  HandlePool<Particle> pool(CAPACITY);
+
+  run_benchmark("Create + Destroy", ITERATIONS, [&]() {
+    pool.destroy(pool.create(Particle{{0, 0, 0}, {1, 1, 1}}));
+  });
+
+  // Fill, then destroy 3 of every 4 objects to leave a sparse span
+  std::vector<HandlePool<Particle>::handle_type> handles;
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    handles.push_back(pool.create(Particle{{0, 0, 0}, {1, 1, 1}}));
+  }
+  std::mt19937 rng(42);
+  std::shuffle(handles.begin(), handles.end(), rng);
+  for (size_t i = CAPACITY / 4; i < CAPACITY; ++i) {
+    pool.destroy(handles[i]);
+  }
+  handles.resize(CAPACITY / 4);
+
+  auto step = [&]() {
+    pool.for_each([](Particle &p) {
+      for (int axis = 0; axis < 3; ++axis)
+        p.position[axis] += p.velocity[axis];
+    });
+  };
+  run_benchmark("Iterate (25% density)", 100, step);
+
+  auto start = Clock::now();
+  size_t moved = pool.compact();
+  double compact_us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  out() << "  Compact: moved " << moved << " objects in " << compact_us
+        << " us\n";
+
+  run_benchmark("Iterate (compacted)", 100, step);
+}
+
+// ============================================================================
+// Buddy Allocator Benchmarks
+// ============================================================================
+
+// Replace a random live block with a new power-of-two block (64B-4KB)
+template <typename Allocator>
+void mixed_pow2_step(Allocator &alloc, std::vector<void *> &live,
+                     std::mt19937 &rng) {
+  void *&slot = live[rng() % live.size()];
+  alloc.deallocate(slot);
+  slot = alloc.allocate(size_t(64) << (rng() % 7));
+}
+
+void benchmark_buddy_allocator() {
+  out() << "\n=== Buddy Allocator Benchmarks ===\n";
+  g_harness.section = "Buddy";
+
+  constexpr size_t POOL_SIZE = 4 * 1024 * 1024; // 4MB
+  constexpr size_t ITERATIONS = 10000;
+  constexpr size_t LIVE_BLOCKS = 256;
+
+  BuddyAllocator buddy(POOL_SIZE, 64);
+
+  run_benchmark("Alloc + Dealloc (64B)", ITERATIONS, [&]() {
+    void *ptr = buddy.allocate(64);
+    buddy.deallocate(ptr);
+  });
+
+  // Same mixed power-of-two workload on both allocators
+  std::vector<void *> live(LIVE_BLOCKS, nullptr);
+  std::mt19937 rng(42);
+  run_benchmark("Mixed Pow2 (64B-4KB) Buddy", ITERATIONS,
+                [&]() { mixed_pow2_step(buddy, live, rng); });
+  for (void *ptr : live) {
+    buddy.deallocate(ptr);
+  }
+
+  FreeListAllocator freelist(POOL_SIZE);
+  std::fill(live.begin(), live.end(), nullptr);
+  rng.seed(42);
+  run_benchmark("Mixed Pow2 (64B-4KB) FreeList", ITERATIONS,
+                [&]() { mixed_pow2_step(freelist, live, rng); });
+  for (void *ptr : live) {
+    freelist.deallocate(ptr);
+  }
+}
+
+// ============================================================================
+// Buffer Growth Benchmarks
+// ============================================================================
+
+// Grow a buffer from 64B to 16KB in 64B steps, as a message is appended
+template <typename Grow> void grow_buffer(IAllocator &alloc, Grow grow) {
+  size_t size = 64;
+  void *buffer = alloc.allocate(size);
+  while (size < 16 * 1024) {
+    buffer = grow(buffer, size, size + 64);
+    size += 64;
+  }
+  alloc.deallocate(buffer, size);
+}
+
+void benchmark_buffer_growth() {
+  out() << "\n=== Buffer Growth Benchmarks ===\n";
+  g_harness.section = "Growth";
+
+  constexpr size_t POOL_SIZE = 1024 * 1024;
+  constexpr size_t ITERATIONS = 200;
+
+  FreeListAllocator freelist(POOL_SIZE);
+  auto copy_grow = [&](void *ptr, size_t old_size, size_t new_size) {
+    void *moved = freelist.allocate(new_size);
+    std::memcpy(moved, ptr, old_size);
+    freelist.deallocate(ptr);
+    return moved;
+  };
+  auto realloc_grow = [&](void *ptr, size_t old_size, size_t new_size) {
+    return freelist.reallocate(ptr, old_size, new_size);
+  };
+
+  run_benchmark("FreeList Allocate+Copy (64B-16KB)", ITERATIONS,
+                [&]() { grow_buffer(freelist, copy_grow); });
+  run_benchmark("FreeList Reallocate (64B-16KB)", ITERATIONS,
+                [&]() { grow_buffer(freelist, realloc_grow); });
+
+  StackAllocator stack(POOL_SIZE);
+  run_benchmark("Stack Reallocate (64B-16KB)", ITERATIONS, [&]() {
+    grow_buffer(stack, [&](void *ptr, size_t old_size, size_t new_size) {
+      return stack.reallocate(ptr, old_size, new_size);
+    });
+    stack.reset();
+  });
 }
 
 // ============================================================================
@@ -200,7 +1207,8 @@ void benchmark_freelist_allocator() {
 // ============================================================================
 
 void benchmark_malloc_comparison() {
-  std::cout << "\n=== Comparison: Custom Allocators vs malloc ===\n";
+  out() << "\n=== Comparison: Custom Allocators vs malloc ===\n";
+  g_harness.section = "Compare";
 
   constexpr size_t ITERATIONS = 100000;
   constexpr size_t ALLOC_SIZE = 64;
@@ -211,6 +1219,7 @@ void benchmark_malloc_comparison() {
     std::vector<double> times;
     times.reserve(ITERATIONS);
 
+    start_counters();
     for (size_t i = 0; i < ITERATIONS; ++i) {
       auto start = Clock::now();
       void *ptr = std::malloc(ALLOC_SIZE);
@@ -219,10 +1228,13 @@ void benchmark_malloc_comparison() {
       times.push_back(
           std::chrono::duration<double, std::nano>(end - start).count());
     }
-    std::sort(times.begin(), times.end());
-    malloc_avg = std::accumulate(times.begin(), times.end(), 0.0) / ITERATIONS;
-    std::cout << "  malloc (64B): Avg " << malloc_avg << " ns, P99 "
-              << times[ITERATIONS * 99 / 100] << " ns\n";
+    auto counters = stop_counters(ITERATIONS);
+    BenchmarkResult result = summarize(times);
+    result.counters = std::move(counters);
+    record_result("malloc (64B)", result);
+    malloc_avg = result.avg_ns;
+    out() << "  malloc (64B): Avg " << malloc_avg << " ns, P99 "
+          << result.p99_ns << " ns\n";
   }
 
   // Pool allocator benchmark
@@ -232,6 +1244,7 @@ void benchmark_malloc_comparison() {
     std::vector<double> times;
     times.reserve(ITERATIONS);
 
+    start_counters();
     for (size_t i = 0; i < ITERATIONS; ++i) {
       auto start = Clock::now();
       void *ptr = pool.allocate();
@@ -240,10 +1253,13 @@ void benchmark_malloc_comparison() {
       times.push_back(
           std::chrono::duration<double, std::nano>(end - start).count());
     }
-    std::sort(times.begin(), times.end());
-    pool_avg = std::accumulate(times.begin(), times.end(), 0.0) / ITERATIONS;
-    std::cout << "  PoolAllocator (64B): Avg " << pool_avg << " ns, P99 "
-              << times[ITERATIONS * 99 / 100] << " ns\n";
+    auto counters = stop_counters(ITERATIONS);
+    BenchmarkResult result = summarize(times);
+    result.counters = std::move(counters);
+    record_result("PoolAllocator (64B)", result);
+    pool_avg = result.avg_ns;
+    out() << "  PoolAllocator (64B): Avg " << pool_avg << " ns, P99 "
+          << result.p99_ns << " ns\n";
   }
 
   // Stack allocator benchmark
@@ -253,6 +1269,7 @@ void benchmark_malloc_comparison() {
     std::vector<double> times;
     times.reserve(ITERATIONS);
 
+    start_counters();
     for (size_t i = 0; i < ITERATIONS; ++i) {
       auto start = Clock::now();
       void *ptr = stack.allocate(ALLOC_SIZE);
@@ -261,31 +1278,153 @@ void benchmark_malloc_comparison() {
       times.push_back(
           std::chrono::duration<double, std::nano>(end - start).count());
     }
-    std::sort(times.begin(), times.end());
-    stack_avg = std::accumulate(times.begin(), times.end(), 0.0) / ITERATIONS;
-    std::cout << "  StackAllocator (64B): Avg " << stack_avg << " ns, P99 "
-              << times[ITERATIONS * 99 / 100] << " ns\n";
+    auto counters = stop_counters(ITERATIONS);
+    BenchmarkResult result = summarize(times);
+    result.counters = std::move(counters);
+    record_result("StackAllocator (64B)", result);
+    stack_avg = result.avg_ns;
+    out() << "  StackAllocator (64B): Avg " << stack_avg << " ns, P99 "
+          << result.p99_ns << " ns\n";
     stack.reset();
   }
 
-  std::cout << "\n  Speedup vs malloc:\n";
-  std::cout << "    Pool: " << (malloc_avg / pool_avg) << "x\n";
-  std::cout << "    Stack: " << (malloc_avg / stack_avg) << "x\n";
+  out() << "\n  Speedup vs malloc:\n";
+  out() << "    Pool: " << (malloc_avg / pool_avg) << "x\n";
+  out() << "    Stack: " << (malloc_avg / stack_avg) << "x\n";
 }
 
 // ============================================================================
 // Main
 // ============================================================================
 
-int main() {
+/**
+ * @brief Check median results against a latency budget file
+ *
+ * Budget lines are "benchmark,metric,max_value"; '#' starts a comment.
+ * Returns false if any budget is exceeded or names an unknown benchmark.
+ */
+bool check_budget(const std::string &path) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Cannot read budget file: " << path << "\n";
+    return false;
+  }
+
+  std::cout << "\n=== Latency Budget (" << path << ") ===\n";
+  bool ok = true;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    size_t c1 = line.find(',');
+    size_t c2 = line.find(',', c1 + 1);
+    if (c1 == std::string::npos || c2 == std::string::npos) {
+      std::cerr << "Malformed budget line: " << line << "\n";
+      ok = false;
+      continue;
+    }
+    std::string name = line.substr(0, c1);
+    std::string metric = line.substr(c1 + 1, c2 - c1 - 1);
+    double limit = std::strtod(line.c_str() + c2 + 1, nullptr);
+
+    std::vector<double> values;
+    for (const bench::Sample &sample : g_harness.report.samples()) {
+      double value = 0;
+      if (sample.benchmark == name && sample.get(metric, value)) {
+        values.push_back(value);
+      }
+    }
+    if (values.empty()) {
+      std::cout << "  MISSING " << name << " " << metric << "\n";
+      ok = false;
+      continue;
+    }
+
+    std::sort(values.begin(), values.end());
+    double median = values[values.size() / 2];
+    bool pass = median <= limit;
+    ok = ok && pass;
+    std::cout << "  " << (pass ? "ok      " : "EXCEEDED") << " " << name << " "
+              << metric << ": median " << median << " (budget " << limit
+              << ")\n";
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  size_t repeat = 1;
+  std::string json_path;
+  std::string csv_path;
+  std::string budget_path;
+  bool use_perf = true;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+    } else if (arg == "--json" && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (arg == "--csv" && i + 1 < argc) {
+      csv_path = argv[++i];
+    } else if (arg == "--budget" && i + 1 < argc) {
+      budget_path = argv[++i];
+    } else if (arg == "--no-perf") {
+      use_perf = false;
+    } else {
+      std::cerr << "Usage: allocx_benchmark [--repeat N] [--json FILE] "
+                   "[--csv FILE] [--budget FILE] [--no-perf]\n";
+      return 1;
+    }
+  }
+
   std::cout << "╔════════════════════════════════════════════════╗\n";
   std::cout << "║      AllocX - Memory Allocator Benchmarks      ║\n";
   std::cout << "╚════════════════════════════════════════════════╝\n";
 
-  benchmark_stack_allocator();
-  benchmark_pool_allocator();
-  benchmark_freelist_allocator();
-  benchmark_malloc_comparison();
+  if (use_perf) {
+    g_harness.perf = std::make_unique<bench::PerfCounters>();
+    if (!g_harness.perf->available()) {
+      std::cout << "\nHardware counters unavailable ("
+                << g_harness.perf->error() << "); wall-clock only.\n";
+    }
+  }
+
+  for (size_t run = 0; run < repeat; ++run) {
+    g_harness.run = run;
+    g_harness.verbose = run == 0;
+    benchmark_stack_allocator();
+    benchmark_pool_allocator();
+    benchmark_shared_pool_allocator();
+    benchmark_freelist_allocator();
+    benchmark_bitmap_pool_allocator();
+    benchmark_slab_cache();
+    benchmark_large_object_allocator();
+    benchmark_persistent_arena();
+    benchmark_numa();
+    benchmark_prefault();
+    benchmark_trim();
+    benchmark_pool_prefetch();
+    benchmark_pool_address_order();
+    benchmark_handle_pool();
+    benchmark_buddy_allocator();
+    benchmark_buffer_growth();
+    benchmark_malloc_comparison();
+  }
+  if (repeat > 1) {
+    std::cout << "\n(" << repeat << " repetitions recorded)\n";
+  }
+
+  if (!json_path.empty() && !g_harness.report.write_json(json_path)) {
+    std::cerr << "Cannot write " << json_path << "\n";
+    return 1;
+  }
+  if (!csv_path.empty() && !g_harness.report.write_csv(csv_path)) {
+    std::cerr << "Cannot write " << csv_path << "\n";
+    return 1;
+  }
+  if (!budget_path.empty() && !check_budget(budget_path)) {
+    std::cout << "\n✗ Latency budget exceeded.\n";
+    return 1;
+  }
 
   std::cout << "\n✓ Benchmarks completed.\n";
   return 0;
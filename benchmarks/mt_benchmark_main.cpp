@@ -0,0 +1,625 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocx/concurrent_stack_allocator.hpp"
+#include "allocx/freelist_allocator.hpp"
+#include "allocx/instrumented_allocator.hpp"
+#include "allocx/latency_histogram.hpp"
+#include "allocx/pool_allocator.hpp"
+#include "allocx/stack_allocator.hpp"
+#include "allocx/thread_safe.hpp"
+#include "allocx/tracing_allocator.hpp"
+#include "allocx/utils.hpp"
+
+using namespace allocx;
+
+// ============================================================================
+// Benchmark Configuration
+// ============================================================================
+
+constexpr size_t MIN_SIZE = 16;
+constexpr size_t MAX_SIZE = 128;
+constexpr size_t LIVE_PER_THREAD = 256; // Live objects per thread
+constexpr size_t OPS_PER_THREAD = 100000;
+
+// ============================================================================
+// Backends
+// ============================================================================
+
+// Uniform interface over malloc and the (wrapped) AllocX allocators
+class Backend {
+public:
+  virtual ~Backend() = default;
+  virtual void *allocate(size_t size) = 0;
+  virtual void deallocate(void *ptr, size_t size) = 0;
+};
+
+class MallocBackend : public Backend {
+public:
+  void *allocate(size_t size) override { return std::malloc(size); }
+  void deallocate(void *ptr, size_t) override { std::free(ptr); }
+};
+
+// Owns an allocator plus any wrapper chain and exposes the outermost layer
+template <typename Inner, typename Outer>
+class OwningBackend : public Backend {
+public:
+  template <typename... Args>
+  explicit OwningBackend(Args &&...args)
+      : m_inner(std::forward<Args>(args)...), m_outer(m_inner) {}
+  void *allocate(size_t size) override { return m_outer.allocate(size); }
+  void deallocate(void *ptr, size_t size) override {
+    m_outer.deallocate(ptr, size);
+  }
+
+protected:
+  Inner m_inner;
+  Outer m_outer;
+};
+
+TraceWriter &null_trace() {
+  static TraceWriter writer("/dev/null");
+  return writer;
+}
+
+// Instrumented/traced wrappers layered over a locked pool
+struct InstrumentedPool {
+  explicit InstrumentedPool(size_t count)
+      : pool(MAX_SIZE, count), safe(pool), timed(safe, 64) {}
+  void *allocate(size_t size) { return timed.allocate(size); }
+  void deallocate(void *ptr, size_t size) { timed.deallocate(ptr, size); }
+  PoolAllocator pool;
+  ThreadSafeAllocator<PoolAllocator> safe;
+  InstrumentedAllocator<ThreadSafeAllocator<PoolAllocator>> timed;
+};
+
+struct TracedPool {
+  explicit TracedPool(size_t count)
+      : pool(MAX_SIZE, count), safe(pool), traced(safe, null_trace()) {}
+  void *allocate(size_t size) { return traced.allocate(size); }
+  void deallocate(void *ptr, size_t size) { traced.deallocate(ptr, size); }
+  PoolAllocator pool;
+  ThreadSafeAllocator<PoolAllocator> safe;
+  TracingAllocator<ThreadSafeAllocator<PoolAllocator>> traced;
+};
+
+template <typename Wrapper> class WrapperBackend : public Backend {
+public:
+  explicit WrapperBackend(size_t count) : m_wrapper(count) {}
+  void *allocate(size_t size) override { return m_wrapper.allocate(size); }
+  void deallocate(void *ptr, size_t size) override {
+    m_wrapper.deallocate(ptr, size);
+  }
+
+private:
+  Wrapper m_wrapper;
+};
+
+using SafePool = OwningBackend<PoolAllocator, ThreadSafeAllocator<PoolAllocator>>;
+using SafeFreeList =
+    OwningBackend<FreeListAllocator, ThreadSafeAllocator<FreeListAllocator>>;
+
+/**
+ * @brief Create a backend able to hold `live` objects at once
+ */
+std::unique_ptr<Backend> make_backend(const std::string &name, size_t live) {
+  if (name == "malloc")
+    return std::make_unique<MallocBackend>();
+  if (name == "Pool+Lock")
+    return std::make_unique<SafePool>(MAX_SIZE, live);
+  if (name == "FreeList+Lock")
+    return std::make_unique<SafeFreeList>(live * (MAX_SIZE + 64) * 2);
+  if (name == "Pool+Lock+Instr")
+    return std::make_unique<WrapperBackend<InstrumentedPool>>(live);
+  if (name == "Pool+Lock+Trace")
+    return std::make_unique<WrapperBackend<TracedPool>>(live);
+  return nullptr;
+}
+
+const std::vector<std::string> &shared_backends() {
+  static const std::vector<std::string> names = {
+      "malloc", "Pool+Lock", "FreeList+Lock", "Pool+Lock+Instr",
+      "Pool+Lock+Trace"};
+  return names;
+}
+
+const std::vector<std::string> &local_backends() {
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> list = shared_backends();
+    list.push_back("Stack");
+    return list;
+  }();
+  return names;
+}
+
+const std::vector<std::string> &layout_backends() {
+  static const std::vector<std::string> names = {"malloc", "Pool",
+                                                 "Pool+Padded"};
+  return names;
+}
+
+const std::vector<std::string> &arena_backends() {
+  static const std::vector<std::string> names = {"malloc", "Stack+Lock",
+                                                 "ConcurrentStack"};
+  return names;
+}
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+struct Result {
+  size_t threads = 0;
+  uint64_t ops = 0;
+  double seconds = 0;
+  LatencyHistogram latency; // Per-op latency in TSC ticks
+};
+
+// Reusable barrier (std::barrier is C++20)
+class Barrier {
+public:
+  explicit Barrier(size_t count) : m_count(count), m_waiting(0), m_phase(0) {}
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t phase = m_phase;
+    if (++m_waiting == m_count) {
+      m_waiting = 0;
+      ++m_phase;
+      m_cv.notify_all();
+    } else {
+      m_cv.wait(lock, [&] { return phase != m_phase; });
+    }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  size_t m_count;
+  size_t m_waiting;
+  size_t m_phase;
+};
+
+// Per-thread context handed to each worker
+struct Worker {
+  size_t index;
+  std::mt19937 rng;
+  LatencyHistogram latency;
+  uint64_t ops = 0;
+
+  size_t random_size() {
+    return MIN_SIZE + rng() % (MAX_SIZE - MIN_SIZE + 1);
+  }
+};
+
+template <typename Func>
+void timed_op(Worker &worker, Func &&func) {
+  uint64_t start = utils::read_tsc();
+  func();
+  worker.latency.record(utils::read_tsc() - start);
+  ++worker.ops;
+}
+
+/**
+ * @brief Run `body` on `threads` workers after a common start line
+ */
+void run_workers(size_t threads, Result &result,
+                 const std::function<void(Worker &)> &body) {
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (size_t i = 0; i < threads; ++i) {
+    workers.push_back(std::make_unique<Worker>());
+    workers.back()->index = i;
+    workers.back()->rng.seed(static_cast<unsigned>(i + 1));
+  }
+
+  Barrier start_line(threads + 1);
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < threads; ++i) {
+    pool.emplace_back([&, i] {
+      start_line.wait();
+      body(*workers[i]);
+    });
+  }
+
+  start_line.wait();
+  uint64_t begin = utils::read_tsc();
+  for (auto &t : pool) {
+    t.join();
+  }
+  uint64_t end = utils::read_tsc();
+
+  result.threads = threads;
+  result.seconds =
+      static_cast<double>(end - begin) / utils::tsc_ticks_per_ns() / 1e9;
+  for (auto &worker : workers) {
+    result.ops += worker->ops;
+    result.latency.merge(worker->latency);
+  }
+}
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+/**
+ * Thread-local churn: every thread owns a private allocator and repeatedly
+ * allocates a batch then frees it. Measures uncontended cost (including the
+ * price of an uncontended lock for wrapped allocators).
+ */
+void thread_local_churn(const std::string &name, size_t threads,
+                        Result &result) {
+  std::vector<std::unique_ptr<Backend>> backends;
+  std::vector<std::unique_ptr<StackAllocator>> stacks;
+  for (size_t i = 0; i < threads; ++i) {
+    if (name == "Stack") {
+      stacks.push_back(
+          std::make_unique<StackAllocator>(LIVE_PER_THREAD * MAX_SIZE * 2));
+    } else {
+      backends.push_back(make_backend(name, LIVE_PER_THREAD));
+    }
+  }
+
+  run_workers(threads, result, [&](Worker &w) {
+    std::vector<std::pair<void *, size_t>> batch;
+    batch.reserve(LIVE_PER_THREAD);
+    for (size_t done = 0; done < OPS_PER_THREAD; done += 2 * LIVE_PER_THREAD) {
+      if (name == "Stack") {
+        StackAllocator &stack = *stacks[w.index];
+        for (size_t i = 0; i < LIVE_PER_THREAD; ++i) {
+          size_t size = w.random_size();
+          timed_op(w, [&] { stack.allocate(size); });
+        }
+        timed_op(w, [&] { stack.reset(); });
+        continue;
+      }
+
+      Backend &backend = *backends[w.index];
+      for (size_t i = 0; i < LIVE_PER_THREAD; ++i) {
+        size_t size = w.random_size();
+        void *ptr = nullptr;
+        timed_op(w, [&] { ptr = backend.allocate(size); });
+        batch.emplace_back(ptr, size);
+      }
+      for (auto &entry : batch) {
+        timed_op(w, [&] { backend.deallocate(entry.first, entry.second); });
+      }
+      batch.clear();
+    }
+  });
+}
+
+/**
+ * Shared-pool contention: all threads hammer one allocator with tight
+ * allocate/free pairs while holding a small working set.
+ */
+void shared_contention(const std::string &name, size_t threads,
+                       Result &result) {
+  auto backend = make_backend(name, threads * LIVE_PER_THREAD);
+
+  run_workers(threads, result, [&](Worker &w) {
+    std::vector<std::pair<void *, size_t>> live(16, {nullptr, 0});
+    for (size_t i = 0; i < OPS_PER_THREAD / 2; ++i) {
+      auto &slot = live[i % live.size()];
+      if (slot.first) {
+        timed_op(w, [&] { backend->deallocate(slot.first, slot.second); });
+      }
+      slot.second = w.random_size();
+      timed_op(w, [&] { slot.first = backend->allocate(slot.second); });
+    }
+    for (auto &slot : live) {
+      backend->deallocate(slot.first, slot.second);
+    }
+  });
+}
+
+// Bounded single-producer/single-consumer ring of blocks
+class SpscRing {
+public:
+  explicit SpscRing(size_t capacity) : m_slots(capacity) {}
+
+  bool push(void *ptr) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t next = (head + 1) % m_slots.size();
+    if (next == m_tail.load(std::memory_order_acquire))
+      return false;
+    m_slots[head] = ptr;
+    m_head.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(void *&ptr) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return false;
+    ptr = m_slots[tail];
+    m_tail.store((tail + 1) % m_slots.size(), std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<void *> m_slots;
+  alignas(64) std::atomic<size_t> m_head{0};
+  alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+/**
+ * Producer/consumer: threads are paired; producers allocate and hand blocks
+ * through a ring, consumers free them. Every block is freed by a thread
+ * other than the one that allocated it.
+ */
+void producer_consumer(const std::string &name, size_t threads,
+                       Result &result) {
+  size_t pairs = std::max<size_t>(threads / 2, 1);
+  auto backend = make_backend(name, pairs * LIVE_PER_THREAD * 2);
+  std::vector<std::unique_ptr<SpscRing>> rings;
+  for (size_t i = 0; i < pairs; ++i) {
+    rings.push_back(std::make_unique<SpscRing>(LIVE_PER_THREAD));
+  }
+
+  constexpr size_t BLOCK_SIZE = 64;
+  run_workers(pairs * 2, result, [&](Worker &w) {
+    SpscRing &ring = *rings[w.index / 2];
+    bool producer = w.index % 2 == 0;
+    for (size_t i = 0; i < OPS_PER_THREAD / 2; ++i) {
+      if (producer) {
+        void *ptr = nullptr;
+        timed_op(w, [&] { ptr = backend->allocate(BLOCK_SIZE); });
+        while (!ring.push(ptr)) {
+          std::this_thread::yield();
+        }
+      } else {
+        void *ptr = nullptr;
+        while (!ring.pop(ptr)) {
+          std::this_thread::yield();
+        }
+        timed_op(w, [&] { backend->deallocate(ptr, BLOCK_SIZE); });
+      }
+    }
+  });
+}
+
+/**
+ * Larson-style: each thread replaces random slots of a slot array, and the
+ * arrays rotate between threads each round so that most frees hit blocks
+ * allocated by another thread.
+ */
+void larson(const std::string &name, size_t threads, Result &result) {
+  constexpr size_t ROUNDS = 8;
+  auto backend = make_backend(name, threads * LIVE_PER_THREAD * 2);
+
+  struct Slot {
+    void *ptr;
+    size_t size;
+  };
+  std::vector<std::vector<Slot>> arrays(threads);
+  std::mt19937 seed_rng(7);
+  for (auto &array : arrays) {
+    for (size_t i = 0; i < LIVE_PER_THREAD; ++i) {
+      size_t size = MIN_SIZE + seed_rng() % (MAX_SIZE - MIN_SIZE + 1);
+      array.push_back({backend->allocate(size), size});
+    }
+  }
+
+  Barrier round_end(threads);
+  run_workers(threads, result, [&](Worker &w) {
+    for (size_t round = 0; round < ROUNDS; ++round) {
+      std::vector<Slot> &array = arrays[(w.index + round) % threads];
+      for (size_t i = 0; i < OPS_PER_THREAD / ROUNDS / 2; ++i) {
+        Slot &slot = array[w.rng() % array.size()];
+        timed_op(w, [&] { backend->deallocate(slot.ptr, slot.size); });
+        slot.size = w.random_size();
+        timed_op(w, [&] { slot.ptr = backend->allocate(slot.size); });
+      }
+      round_end.wait();
+    }
+  });
+
+  for (auto &array : arrays) {
+    for (Slot &slot : array) {
+      backend->deallocate(slot.ptr, slot.size);
+    }
+  }
+}
+
+/**
+ * Shared arena bump: all threads fill one arena with a batch of objects,
+ * then meet at a barrier where a single thread resets it (the fork/join
+ * frame pattern). malloc frees each thread's batch instead of resetting.
+ */
+void shared_arena(const std::string &name, size_t threads, Result &result) {
+  constexpr size_t ROUNDS = 32;
+  size_t arena_size = threads * (LIVE_PER_THREAD * MAX_SIZE * 2 +
+                                 ConcurrentStackAllocator::DEFAULT_SUB_BLOCK_SIZE);
+  ConcurrentStackAllocator concurrent(name == "ConcurrentStack" ? arena_size
+                                                                : 0);
+  StackAllocator stack(name == "Stack+Lock" ? arena_size : 0);
+  ThreadSafeAllocator<StackAllocator> locked(stack);
+
+  Barrier phase(threads);
+  run_workers(threads, result, [&](Worker &w) {
+    std::vector<std::pair<void *, size_t>> batch;
+    batch.reserve(LIVE_PER_THREAD);
+    for (size_t round = 0; round < ROUNDS; ++round) {
+      for (size_t i = 0; i < LIVE_PER_THREAD; ++i) {
+        size_t size = w.random_size();
+        void *ptr = nullptr;
+        if (name == "ConcurrentStack") {
+          timed_op(w, [&] { ptr = concurrent.allocate(size); });
+        } else if (name == "Stack+Lock") {
+          timed_op(w, [&] { ptr = locked.allocate(size); });
+        } else {
+          timed_op(w, [&] { ptr = std::malloc(size); });
+          batch.emplace_back(ptr, size);
+        }
+      }
+      for (auto &entry : batch) {
+        timed_op(w, [&] { std::free(entry.first); });
+      }
+      batch.clear();
+
+      // Quiescent point: nobody allocates between the two barriers
+      phase.wait();
+      if (w.index == 0) {
+        if (name == "ConcurrentStack") {
+          timed_op(w, [&] { concurrent.reset(); });
+        } else if (name == "Stack+Lock") {
+          timed_op(w, [&] { locked.reset(); });
+        }
+      }
+      phase.wait();
+    }
+  });
+}
+
+/**
+ * False sharing: every thread takes one small counter from a shared
+ * allocator (handed out back to back before the threads start) and
+ * increments it. Packed 16-byte chunks put several threads' counters on
+ * one cache line, which then bounces between cores on every write;
+ * cache-line padding gives each counter its own line. An op is a burst of
+ * increments, since a single store is too short to time.
+ */
+void false_sharing(const std::string &name, size_t threads, Result &result) {
+  constexpr size_t COUNTER_SIZE = 16;
+  constexpr size_t BURST = 16;
+  PoolOptions padded;
+  padded.cache_line_padding = true;
+  PoolAllocator pool(COUNTER_SIZE, threads, alignof(std::max_align_t),
+                     name == "Pool+Padded" ? padded : PoolOptions());
+
+  std::vector<volatile uint64_t *> counters;
+  for (size_t i = 0; i < threads; ++i) {
+    void *memory = name == "malloc" ? std::malloc(COUNTER_SIZE) : pool.allocate();
+    counters.push_back(new (memory) uint64_t(0));
+  }
+
+  run_workers(threads, result, [&](Worker &w) {
+    volatile uint64_t *counter = counters[w.index];
+    for (size_t op = 0; op < OPS_PER_THREAD; ++op) {
+      timed_op(w, [&] {
+        for (size_t i = 0; i < BURST; ++i)
+          *counter = *counter + 1;
+      });
+    }
+  });
+
+  if (name == "malloc") {
+    for (volatile uint64_t *counter : counters)
+      std::free(const_cast<uint64_t *>(counter));
+  }
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+struct ScenarioSpec {
+  const char *name;
+  void (*run)(const std::string &, size_t, Result &);
+  size_t min_threads;
+  const std::vector<std::string> &(*backends)();
+};
+
+void print_header() {
+  std::cout << "  " << std::left << std::setw(18) << "Allocator"
+            << std::right << std::setw(8) << "Threads" << std::setw(12)
+            << "Mops/s" << std::setw(10) << "P50 ns" << std::setw(10)
+            << "P99 ns" << std::setw(11) << "P999 ns" << std::setw(12)
+            << "vs malloc" << "\n";
+}
+
+void print_row(const std::string &name, const Result &result,
+               double malloc_mops) {
+  double ticks_per_ns = utils::tsc_ticks_per_ns();
+  double mops = result.seconds > 0
+                    ? static_cast<double>(result.ops) / result.seconds / 1e6
+                    : 0;
+  auto ns = [&](double pct) {
+    return static_cast<double>(result.latency.percentile(pct)) / ticks_per_ns;
+  };
+  std::cout << "  " << std::left << std::setw(18) << name << std::right
+            << std::setw(8) << result.threads << std::fixed << std::setprecision(2)
+            << std::setw(12) << mops << std::setprecision(1) << std::setw(10)
+            << ns(50.0) << std::setw(10) << ns(99.0) << std::setw(11)
+            << ns(99.9) << std::setprecision(2) << std::setw(11)
+            << (malloc_mops > 0 ? mops / malloc_mops : 0) << "x\n";
+  std::cout.unsetf(std::ios::fixed);
+}
+
+std::vector<size_t> thread_counts(size_t max_threads) {
+  std::vector<size_t> counts;
+  for (size_t n = 1; n <= max_threads; n *= 2) {
+    counts.push_back(n);
+  }
+  if (counts.back() != max_threads) {
+    counts.push_back(max_threads);
+  }
+  return counts;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+  size_t max_threads =
+      std::max<size_t>(std::thread::hardware_concurrency(), 4);
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      max_threads = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+    } else {
+      std::cerr << "Usage: allocx_mt_benchmark [--threads MAX]\n";
+      return 1;
+    }
+  }
+
+  std::cout << "╔════════════════════════════════════════════════╗\n";
+  std::cout << "║    AllocX - Multi-Threaded Scaling Benchmarks  ║\n";
+  std::cout << "╚════════════════════════════════════════════════╝\n";
+
+  const ScenarioSpec scenarios[] = {
+      {"Thread-Local Churn", thread_local_churn, 1, local_backends},
+      {"Shared-Pool Contention", shared_contention, 1, shared_backends},
+      {"Producer/Consumer", producer_consumer, 2, shared_backends},
+      {"Larson Cross-Thread Free", larson, 1, shared_backends},
+      {"Shared Arena Bump", shared_arena, 1, arena_backends},
+      {"False Sharing (16B counters)", false_sharing, 1, layout_backends},
+  };
+
+  for (const ScenarioSpec &scenario : scenarios) {
+    std::cout << "\n=== " << scenario.name << " ===\n";
+    print_header();
+
+    const std::vector<std::string> &names = scenario.backends();
+
+    for (size_t threads : thread_counts(max_threads)) {
+      if (threads < scenario.min_threads)
+        continue;
+      double malloc_mops = 0;
+      for (const std::string &name : names) {
+        Result result;
+        scenario.run(name, threads, result);
+        if (name == "malloc") {
+          malloc_mops = static_cast<double>(result.ops) / result.seconds / 1e6;
+        }
+        print_row(name, result, malloc_mops);
+      }
+    }
+  }
+
+  std::cout << "\n✓ Benchmarks completed.\n";
+  return 0;
+}
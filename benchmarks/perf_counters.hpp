@@ -0,0 +1,162 @@
+#ifndef ALLOCX_PERF_COUNTERS_HPP
+#define ALLOCX_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace allocx {
+namespace bench {
+
+/**
+ * @brief Hardware performance counters around a code region (Linux only)
+ *
+ * Opens one perf_event_open counter per event for the calling thread,
+ * user space only. Events the kernel or CPU does not support are skipped
+ * individually; if none can be opened (non-Linux, containers, or
+ * perf_event_paranoid too strict) available() is false and the harness
+ * falls back to wall-clock timing only.
+ *
+ * Counts are scaled for multiplexing using time enabled / time running.
+ *
+ * Usage:
+ *   PerfCounters counters;
+ *   counters.start();
+ *   run_workload();
+ *   counters.stop();
+ *   for (auto& value : counters.values()) { ... }
+ */
+class PerfCounters {
+public:
+  struct Value {
+    const char *name;
+    double count;
+  };
+
+  PerfCounters() {
+#ifdef __linux__
+    add("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    add("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    add("l1d_misses", PERF_TYPE_HW_CACHE,
+        cache_config(PERF_COUNT_HW_CACHE_L1D));
+    add("llc_misses", PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_LL));
+    add("dtlb_misses", PERF_TYPE_HW_CACHE,
+        cache_config(PERF_COUNT_HW_CACHE_DTLB));
+    add("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#else
+    m_error = "perf_event_open is Linux-only";
+#endif
+  }
+
+  ~PerfCounters() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      close(counter.fd);
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /**
+   * @brief True if at least one counter could be opened
+   */
+  bool available() const noexcept { return !m_counters.empty(); }
+
+  /**
+   * @brief Why the first failing counter could not be opened
+   *
+   * Empty if every counter opened.
+   */
+  const std::string &error() const noexcept { return m_error; }
+
+  void start() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  void stop() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+  }
+
+  /**
+   * @brief Read counts accumulated between start() and stop()
+   */
+  std::vector<Value> values() const {
+    std::vector<Value> result;
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      uint64_t data[3] = {0, 0, 0}; // value, time enabled, time running
+      if (read(counter.fd, data, sizeof(data)) != sizeof(data))
+        continue;
+      double count = static_cast<double>(data[0]);
+      if (data[2] > 0 && data[2] < data[1]) {
+        count *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+      }
+      result.push_back({counter.name, count});
+    }
+#endif
+    return result;
+  }
+
+private:
+#ifdef __linux__
+  struct Counter {
+    const char *name;
+    int fd;
+  };
+
+  static uint64_t cache_config(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+
+  void add(const char *name, uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+      if (m_error.empty()) {
+        m_error = std::string("perf_event_open failed: ") + std::strerror(errno);
+      }
+      return;
+    }
+    m_counters.push_back({name, static_cast<int>(fd)});
+  }
+
+  std::vector<Counter> m_counters;
+#endif
+  std::string m_error;
+};
+
+} // namespace bench
+} // namespace allocx
+
+#endif // ALLOCX_PERF_COUNTERS_HPP
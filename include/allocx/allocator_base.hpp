@@ -1,7 +1,10 @@
 #ifndef ALLOCX_ALLOCATOR_BASE_HPP
 #define ALLOCX_ALLOCATOR_BASE_HPP
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace allocx {
 
@@ -38,6 +41,72 @@ public:
      */
     virtual void reset() {}
 
+    /**
+     * @brief Resize an allocation in place
+     * 
+     * Allocators that can grow or shrink a block without moving it
+     * override this. Default implementation never succeeds.
+     * 
+     * @param ptr Pointer returned by allocate()
+     * @param new_size Requested size in bytes
+     * @return true if ptr now has at least new_size usable bytes
+     */
+    virtual bool try_expand(void* ptr, size_t new_size) {
+        (void)ptr;
+        (void)new_size;
+        return false;
+    }
+
+    /**
+     * @brief Resize an allocation, moving it only if necessary
+     * 
+     * Tries try_expand() first; otherwise allocates a new block, copies
+     * min(old_size, new_size) bytes and frees the old block. On failure
+     * returns nullptr and leaves the original block untouched.
+     * 
+     * @param ptr Pointer returned by allocate() (nullptr to allocate)
+     * @param old_size Current size of the allocation
+     * @param new_size Requested size in bytes
+     * @param alignment Required alignment if the block has to move
+     * @return Pointer to the resized allocation, or nullptr on failure
+     */
+    virtual void* reallocate(void* ptr, size_t old_size, size_t new_size,
+                             size_t alignment = alignof(std::max_align_t)) {
+        if (ptr == nullptr) {
+            return allocate(new_size, alignment);
+        }
+        if (try_expand(ptr, new_size)) {
+            return ptr;
+        }
+
+        void* moved = allocate(new_size, alignment);
+        if (moved == nullptr) {
+            return nullptr;
+        }
+        std::memcpy(moved, ptr, std::min(old_size, new_size));
+        deallocate(ptr, old_size);
+        return moved;
+    }
+
+    /**
+     * @brief Return unused backing pages to the OS
+     * 
+     * Releases whole pages that hold no live data while keeping them
+     * mapped; they fault back in (zeroed) when reused. Allocators that can
+     * tell which of their pages are free override this. Default
+     * implementation releases nothing.
+     * 
+     * @param max_bytes Stop once about this many bytes were released
+     * @param lazy Let the kernel reclaim pages under memory pressure only
+     *             (MADV_FREE) instead of dropping them now (MADV_DONTNEED)
+     * @return Bytes released
+     */
+    virtual size_t trim(size_t max_bytes = SIZE_MAX, bool lazy = false) {
+        (void)max_bytes;
+        (void)lazy;
+        return 0;
+    }
+
     /**
      * @brief Check if allocator owns a pointer
      * @param ptr Pointer to check
@@ -0,0 +1,147 @@
+#ifndef ALLOCX_BUDDY_ALLOCATOR_HPP
+#define ALLOCX_BUDDY_ALLOCATOR_HPP
+
+#include "allocator_base.hpp"
+#include "utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Binary buddy allocator for power-of-two blocks
+ *
+ * Manages a power-of-two arena as a binary tree of blocks. Requests are
+ * rounded up to a power of two; larger free blocks are split in halves
+ * ("buddies") on allocation and buddies are merged again on free.
+ *
+ * Block state lives in two side bitmaps (one "split" bit and one "free"
+ * bit per tree node) plus one intrusive free list per order threaded
+ * through free blocks only. Allocated blocks carry no header, so every
+ * block of size 2^k is aligned to 2^k (up to MAX_ARENA_ALIGNMENT).
+ *
+ * Time Complexity:
+ * - Allocation: O(log n) splits, O(1) free-list lookup
+ * - Deallocation: O(log n) tree walk and merges
+ *
+ * Use Cases:
+ * - Staging buffers that need power-of-two sizes and natural alignment
+ * - Page/texture-style allocations with predictable worst-case cost
+ */
+class BuddyAllocator : public IAllocator {
+public:
+  /// Arenas are aligned to their size, capped at this value
+  static constexpr size_t MAX_ARENA_ALIGNMENT = size_t(2) << 20; // 2 MiB
+
+  /**
+   * @brief Construct a buddy allocator
+   * @param size Arena size (rounded up to a power of two)
+   * @param min_block_size Smallest block (power of two, >= 2 pointers)
+   */
+  explicit BuddyAllocator(size_t size, size_t min_block_size = 64);
+
+  /**
+   * @brief Construct using external memory buffer
+   *
+   * Uses the largest power-of-two prefix of the buffer. Block alignment
+   * is limited by the buffer's own alignment.
+   *
+   * @param buffer Pre-allocated memory buffer
+   * @param size Size of the buffer
+   * @param min_block_size Smallest block (power of two, >= 2 pointers)
+   */
+  BuddyAllocator(void *buffer, size_t size, size_t min_block_size = 64);
+
+  ~BuddyAllocator() override;
+
+  // Move semantics
+  BuddyAllocator(BuddyAllocator &&other) noexcept;
+  BuddyAllocator &operator=(BuddyAllocator &&other) noexcept;
+
+  /**
+   * @brief Allocate a power-of-two block
+   * @param size Number of bytes (rounded up to a power of two)
+   * @param alignment Required alignment (satisfied by block size)
+   * @return Pointer to block, or nullptr if no block is large enough
+   */
+  void *allocate(size_t size,
+                 size_t alignment = alignof(std::max_align_t)) override;
+
+  /**
+   * @brief Free a block and merge it with free buddies
+   * @param ptr Pointer returned by allocate()
+   * @param size Ignored (block order recovered from the split bitmap)
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  /**
+   * @brief Resize in place (succeeds while new_size fits the block)
+   */
+  bool try_expand(void *ptr, size_t new_size) override;
+
+  /**
+   * @brief Reset to a single free block covering the arena
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+  size_t total_size() const override;
+  size_t used_size() const override;
+
+  /**
+   * @brief Get the smallest block size
+   */
+  size_t min_block_size() const noexcept;
+
+  /**
+   * @brief Get the size of the block backing an allocation
+   * @param ptr Pointer returned by allocate()
+   */
+  size_t block_size(void *ptr) const noexcept;
+
+  /**
+   * @brief Get the largest block that can currently be allocated
+   */
+  size_t largest_free_block() const noexcept;
+
+  /**
+   * @brief Get number of free blocks of a given order
+   * @param order Block order (size = min_block_size() << order)
+   */
+  size_t free_block_count(size_t order) const noexcept;
+
+private:
+  // Intrusive links stored inside free blocks only
+  struct FreeBlock {
+    FreeBlock *next;
+    FreeBlock *prev;
+  };
+
+  static constexpr size_t MAX_ORDERS = 64;
+
+  void init(size_t min_block_size);
+  size_t node_index(size_t offset, size_t order) const noexcept;
+  bool test(const std::vector<uint64_t> &bits, size_t node) const noexcept;
+  void set(std::vector<uint64_t> &bits, size_t node, bool value) noexcept;
+  void push_free(size_t order, size_t offset) noexcept;
+  void remove_free(size_t order, FreeBlock *block) noexcept;
+  size_t order_of(size_t offset, size_t &node) const noexcept;
+
+  void *m_memory;          // Base pointer to arena
+  size_t m_size;           // Arena size (power of two)
+  size_t m_used;           // Bytes in allocated blocks
+  size_t m_min_shift;      // log2(min block size)
+  size_t m_max_order;      // Order of the whole arena
+  size_t m_base_alignment; // Guaranteed alignment of the arena base
+  uint64_t m_nonempty;     // Bit k set if free list k is non-empty
+  FreeBlock *m_free_lists[MAX_ORDERS]; // Per-order free lists
+  std::vector<uint64_t> m_split;       // Node has been split into buddies
+  std::vector<uint64_t> m_free;        // Node is on a free list
+  bool m_owns_memory;                  // Whether we should free m_memory
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_BUDDY_ALLOCATOR_HPP
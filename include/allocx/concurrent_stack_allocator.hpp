@@ -0,0 +1,112 @@
+#ifndef ALLOCX_CONCURRENT_STACK_ALLOCATOR_HPP
+#define ALLOCX_CONCURRENT_STACK_ALLOCATOR_HPP
+
+#include "allocator_base.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace allocx {
+
+/**
+ * @brief Lock-free bump allocator shared by many threads
+ *
+ * Threads reserve sub-blocks of `sub_block_size` bytes from a shared
+ * arena with a single atomic fetch_add and then bump-allocate inside
+ * their sub-block without any synchronization. Requests larger than half
+ * a sub-block are reserved from the arena directly. Sub-blocks start on
+ * cache-line boundaries so threads never write to the same line. The
+ * sub-block size is clamped to the arena, and the thread whose
+ * reservation crosses the end of the arena gets the remaining tail.
+ *
+ * Each thread caches the sub-block of the last ConcurrentStackAllocator
+ * it used; switching between several instances on one thread abandons
+ * the rest of the cached sub-block.
+ *
+ * reset() frees everything at once and must only be called at a
+ * quiescent point (no thread inside allocate()). Threads notice the
+ * reset through an epoch counter and drop their stale sub-blocks.
+ *
+ * Time Complexity:
+ * - Allocation: O(1), one atomic add per sub-block
+ * - Reset: O(1)
+ *
+ * Use Cases:
+ * - Parallel parsers/jobs sharing one per-frame arena
+ * - Fork/join phases followed by a bulk reset
+ */
+class ConcurrentStackAllocator : public IAllocator {
+public:
+  static constexpr size_t DEFAULT_SUB_BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * @brief Construct a concurrent stack allocator
+   * @param size Total arena size
+   * @param sub_block_size Bytes reserved per thread at a time
+   */
+  explicit ConcurrentStackAllocator(
+      size_t size, size_t sub_block_size = DEFAULT_SUB_BLOCK_SIZE);
+
+  /**
+   * @brief Construct using external memory buffer
+   * @param buffer Pre-allocated memory buffer
+   * @param size Size of the buffer
+   * @param sub_block_size Bytes reserved per thread at a time
+   */
+  ConcurrentStackAllocator(void *buffer, size_t size,
+                           size_t sub_block_size = DEFAULT_SUB_BLOCK_SIZE);
+
+  ~ConcurrentStackAllocator() override;
+
+  /**
+   * @brief Allocate memory (thread-safe, lock-free)
+   * @param size Number of bytes to allocate
+   * @param alignment Required alignment (at most the cache-line size for
+   *        sub-block allocations, any power of two for large ones)
+   * @return Pointer to allocated memory, or nullptr if the arena is full
+   */
+  void *allocate(size_t size,
+                 size_t alignment = alignof(std::max_align_t)) override;
+
+  /**
+   * @brief Deallocate is a no-op; use reset()
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  /**
+   * @brief Free everything (call only when no thread is allocating)
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+  size_t total_size() const override;
+
+  /**
+   * @brief Bytes reserved from the arena
+   *
+   * Includes the unused tails of sub-blocks still cached by threads.
+   */
+  size_t used_size() const override;
+
+  size_t sub_block_size() const noexcept;
+
+private:
+  static constexpr size_t CACHE_LINE = 64;
+
+  void init();
+  char *reserve(size_t bytes, size_t &granted) noexcept;
+
+  char *m_memory;                 // Base of the arena (cache-line aligned)
+  void *m_allocation;             // Pointer to free (if owned)
+  size_t m_size;                  // Usable arena size
+  size_t m_sub_block_size;        // Per-thread reservation size
+  uint64_t m_id;                  // Unique id for thread-local caches
+  std::atomic<uint64_t> m_epoch;  // Bumped by reset()
+  alignas(CACHE_LINE) std::atomic<size_t> m_offset; // Shared bump offset
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_CONCURRENT_STACK_ALLOCATOR_HPP
@@ -3,17 +3,25 @@
 
 #include "allocator_base.hpp"
 #include "utils.hpp"
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <ostream>
+#include <vector>
 
 namespace allocx {
 
 /**
  * @brief Free-List Allocator for variable-size allocations
  *
- * Manages a linked list of free blocks with size metadata. Supports
- * first-fit allocation strategy, block splitting, and adjacent
- * block coalescing to reduce fragmentation.
+ * Manages an address-ordered linked list of free blocks with size
+ * metadata. Supports first/best/worst-fit strategies, block splitting,
+ * and coalescing of physically adjacent free blocks.
+ *
+ * Allocations made through allocate_handle() are relocatable: callers
+ * keep a Handle and resolve it to a pointer when needed, which lets
+ * defragment() slide those blocks toward the start of the arena in small
+ * budgeted steps. Plain allocate() blocks are pinned and are never moved.
  *
  * Time Complexity:
  * - Allocation: O(n) worst case (linear search)
@@ -26,6 +34,26 @@ namespace allocx {
  */
 class FreeListAllocator : public IAllocator {
 public:
+  /// Relocatable allocation; 0 is never a valid handle
+  using Handle = uint32_t;
+  static constexpr Handle NULL_HANDLE = 0;
+
+  /// Free-block histogram buckets (bucket k counts sizes in [2^k, 2^(k+1)))
+  static constexpr size_t HISTOGRAM_BUCKETS = 64;
+
+  /**
+   * @brief Fragmentation snapshot
+   *
+   * Sizes are usable bytes (block headers excluded).
+   */
+  struct Metrics {
+    size_t free_bytes;             // Total bytes in free blocks
+    size_t free_blocks;            // Number of free blocks
+    size_t largest_free_block;     // Largest single free block
+    double external_fragmentation; // 1 - largest / free_bytes (0 if empty)
+    size_t histogram[HISTOGRAM_BUCKETS]; // Free blocks by floor(log2(size))
+  };
+
   /**
    * @brief Allocation strategy for finding free blocks
    */
@@ -74,6 +102,19 @@ public:
    */
   void deallocate(void *ptr, size_t size = 0) override;
 
+  /**
+   * @brief Resize in place, absorbing the following free block if needed
+   *
+   * Shrinking always succeeds (surplus large enough for a block is
+   * returned to the free list). Growing succeeds when the block is
+   * physically followed by a free block with enough space.
+   *
+   * @param ptr Pointer returned by allocate()
+   * @param new_size Requested size in bytes
+   * @return true if ptr now has at least new_size usable bytes
+   */
+  bool try_expand(void *ptr, size_t new_size) override;
+
   /**
    * @brief Reset allocator to initial state
    */
@@ -91,39 +132,142 @@ public:
   size_t free_block_count() const noexcept;
 
   /**
-   * @brief Get largest available block size
+   * @brief Get largest available block size (O(1))
    * @return Size of largest free block
    */
   size_t largest_free_block() const noexcept;
 
+  /**
+   * @brief Get free-space metrics (maintained incrementally)
+   */
+  Metrics metrics() const noexcept;
+
+  /**
+   * @brief Write the physical block layout for offline visualization
+   *
+   * Emits "# key=value" lines (arena size, header size, strategy), a
+   * column header and one "offset,size,state" line per block in address
+   * order. Offsets are from the arena start; sizes include the header.
+   * State is F (free), A (allocated) or R (allocated, relocatable).
+   */
+  void dump_heap_map(std::ostream &os) const;
+
+  /**
+   * @brief Return the pages inside free blocks to the OS
+   *
+   * Releases the whole pages of each free block's data (its header stays
+   * resident), skipping blocks already trimmed. Works a block at a time,
+   * so it may overshoot max_bytes by up to one block.
+   */
+  size_t trim(size_t max_bytes = SIZE_MAX, bool lazy = false) override;
+
+  /**
+   * @brief Allocate a relocatable block
+   * @param size Number of bytes to allocate
+   * @param alignment Required alignment (kept across relocation)
+   * @return Handle to the block, or NULL_HANDLE if none available
+   */
+  Handle allocate_handle(size_t size,
+                         size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @brief Free a block obtained from allocate_handle()
+   * @param handle Handle to free (NULL_HANDLE is ignored)
+   */
+  void deallocate_handle(Handle handle);
+
+  /**
+   * @brief Get the current address of a relocatable block
+   *
+   * The pointer stays valid until the next defragment() call.
+   *
+   * @param handle Live handle from allocate_handle()
+   * @return Pointer to the block data, or nullptr for NULL_HANDLE
+   */
+  void *resolve(Handle handle) const noexcept;
+
+  /**
+   * @brief Incrementally compact relocatable blocks
+   *
+   * Walks free blocks from the lowest address and slides each
+   * relocatable block that directly follows one down into it, merging
+   * the free space upward. Stops once either budget is used up, so it
+   * can be called every frame/tick without long pauses. Pinned blocks
+   * (from allocate()) stay in place and split the arena into regions
+   * that are compacted independently.
+   *
+   * @param max_bytes Stop after moving at least this many bytes
+   * @param max_time Stop once this much time has elapsed
+   * @return Bytes moved; 0 means nothing more can be compacted
+   */
+  size_t defragment(size_t max_bytes, std::chrono::nanoseconds max_time =
+                                          std::chrono::nanoseconds::max());
+
 private:
-  // Block header stored before each allocation
+  // Block header stored before each allocation. `padding` is the last
+  // byte of the header, and allocate() also stores the padding in the byte
+  // just before the returned pointer, so data[-1] always holds it. Padding
+  // of LONG_PADDING bytes or more (alignments above 256) is stored as
+  // LONG_PADDING, with the full value in the size_t just before that byte.
   struct BlockHeader {
     size_t size;       // Size of data (not including header)
     BlockHeader *next; // Next free block (if free)
+    uint32_t handle;   // Handle table index, or NO_HANDLE if pinned;
+                       // m_free_heap slot while free
     bool is_free;      // Block status
-    uint8_t padding;   // Alignment padding used
+    bool trimmed;      // Free block whose pages trim() already released
+    uint8_t reserved;
+    uint8_t padding; // Alignment padding used, capped at LONG_PADDING
+  };
+
+  // Free block in the size heap (size copied so sifting stays in the array)
+  struct HeapEntry {
+    size_t size;
+    BlockHeader *block;
+  };
+
+  // Handle table entry; free entries are chained through next_free
+  struct HandleEntry {
+    void *data;        // Current data pointer (nullptr if free)
+    size_t alignment;  // Alignment to preserve when relocating
+    uint32_t next_free;
   };
 
   static constexpr size_t HEADER_SIZE = sizeof(BlockHeader);
   static constexpr size_t MIN_BLOCK_SIZE =
       sizeof(void *); // Minimum usable block
+  static constexpr uint32_t NO_HANDLE = ~uint32_t(0);
+  static constexpr size_t LONG_PADDING = 255;
 
   void init();
   BlockHeader *find_first_fit(size_t size, size_t alignment) const;
   BlockHeader *find_best_fit(size_t size, size_t alignment) const;
   BlockHeader *find_worst_fit(size_t size, size_t alignment) const;
   void split_block(BlockHeader *block, size_t size, size_t padding);
-  void coalesce();
+  void coalesce(BlockHeader *prev, BlockHeader *block);
   void insert_free_block(BlockHeader *block);
   void remove_free_block(BlockHeader *block);
+  size_t slide_down(BlockHeader *prev, BlockHeader *free_block);
+  static void store_padding(BlockHeader *block, uint8_t *data,
+                            size_t padding) noexcept;
+  BlockHeader *header_of(void *ptr) const noexcept;
+  BlockHeader *next_physical(BlockHeader *block) const noexcept;
+  void track_free(BlockHeader *block);
+  void untrack_free(BlockHeader *block) noexcept;
+  void resize_free(BlockHeader *block, size_t size) noexcept;
+  size_t sift_up(size_t slot) noexcept;
+  void sift_down(size_t slot) noexcept;
 
   void *m_memory;           // Base pointer to memory block
   size_t m_size;            // Total size of block
   size_t m_used;            // Currently used bytes
   Strategy m_strategy;      // Allocation strategy
-  BlockHeader *m_free_list; // Head of free block list
+  BlockHeader *m_free_list; // Head of free block list (address order)
   bool m_owns_memory;       // Whether we should free m_memory
+  std::vector<HandleEntry> m_handles; // Relocatable block table
+  uint32_t m_free_handle;             // Head of free handle entries
+  Metrics m_metrics;                  // Free-space counters
+  std::vector<HeapEntry> m_free_heap; // Free blocks, max-heap by size
 };
 
 } // namespace allocx
@@ -0,0 +1,289 @@
+#ifndef ALLOCX_HANDLE_POOL_HPP
+#define ALLOCX_HANDLE_POOL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Fixed-capacity object pool addressed by generational handles
+ *
+ * Objects are referred to by handles instead of raw pointers. A handle
+ * packs an index into an indirection table with a generation counter;
+ * the table maps the index to the object's current storage position.
+ * Because nobody holds a pointer into storage, compact() can move live
+ * objects into a dense prefix after churn has left holes, and destroyed
+ * objects are detected because their slot's generation has moved on.
+ *
+ * Handle layout (index | generation << INDEX_BITS):
+ * - uint32_t: 20-bit index (1M objects), 12-bit generation
+ * - uint64_t: 32-bit index, 32-bit generation
+ *
+ * Generation 0 is never issued, so a zero handle (NULL_HANDLE) is always
+ * invalid. Generations wrap after 2^GENERATION_BITS - 1 reuses of a slot,
+ * after which a very old stale handle can alias a new object.
+ *
+ * Pointers returned by get() are invalidated by compact().
+ *
+ * Usage:
+ *   HandlePool<Particle> particles(10000);
+ *   auto h = particles.create(position, velocity);
+ *   particles.get(h)->update();
+ *   particles.destroy(h);
+ *   particles.get(h);  // nullptr
+ *   particles.compact();
+ */
+template <typename T, typename Handle = uint32_t> class HandlePool {
+  static_assert(std::is_same<Handle, uint32_t>::value ||
+                    std::is_same<Handle, uint64_t>::value,
+                "Handle must be uint32_t or uint64_t");
+
+public:
+  using handle_type = Handle;
+
+  static constexpr unsigned INDEX_BITS = sizeof(Handle) == 4 ? 20 : 32;
+  static constexpr unsigned GENERATION_BITS = sizeof(Handle) * 8 - INDEX_BITS;
+  static constexpr size_t MAX_CAPACITY = (size_t(1) << INDEX_BITS) - 1;
+  static constexpr Handle NULL_HANDLE = 0;
+
+  /**
+   * @brief Construct a pool
+   * @param capacity Maximum number of live objects (<= MAX_CAPACITY)
+   */
+  explicit HandlePool(size_t capacity)
+      : m_storage(nullptr), m_capacity(capacity), m_size(0), m_end(0),
+        m_free_slot(NO_SLOT), m_slots(), m_owner(), m_holes() {
+    assert(capacity <= MAX_CAPACITY && "Capacity exceeds handle index bits");
+    if (m_capacity > MAX_CAPACITY)
+      m_capacity = MAX_CAPACITY;
+
+    if (m_capacity > 0) {
+      m_storage = static_cast<T *>(::operator new(
+          m_capacity * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    m_slots.resize(m_capacity);
+    m_owner.assign(m_capacity, NO_SLOT);
+
+    // Chain all slots into the free list, lowest index first
+    for (size_t i = 0; i < m_capacity; ++i) {
+      m_slots[i].position =
+          i + 1 < m_capacity ? static_cast<uint32_t>(i + 1) : NO_SLOT;
+      m_slots[i].generation = 1;
+    }
+    m_free_slot = m_capacity > 0 ? 0 : NO_SLOT;
+  }
+
+  ~HandlePool() {
+    clear();
+    if (m_storage) {
+      ::operator delete(m_storage, std::align_val_t(alignof(T)));
+    }
+  }
+
+  // Prevent copying
+  HandlePool(const HandlePool &) = delete;
+  HandlePool &operator=(const HandlePool &) = delete;
+
+  /**
+   * @brief Construct a new object
+   * @param args Constructor arguments forwarded to T
+   * @return Handle to the object, or NULL_HANDLE if the pool is full
+   */
+  template <typename... Args> Handle create(Args &&...args) {
+    if (m_free_slot == NO_SLOT)
+      return NULL_HANDLE;
+
+    // Fill holes before growing the used prefix
+    uint32_t position;
+    if (!m_holes.empty()) {
+      position = m_holes.back();
+      m_holes.pop_back();
+    } else {
+      position = static_cast<uint32_t>(m_end++);
+    }
+    new (m_storage + position) T(std::forward<Args>(args)...);
+
+    uint32_t index = m_free_slot;
+    Slot &slot = m_slots[index];
+    m_free_slot = slot.position;
+    slot.position = position;
+    m_owner[position] = index;
+    ++m_size;
+
+    return make_handle(index, slot.generation);
+  }
+
+  /**
+   * @brief Destroy the object a handle refers to
+   * @param handle Handle from create(); stale handles are ignored
+   */
+  void destroy(Handle handle) {
+    T *object = get(handle);
+    if (object == nullptr)
+      return;
+
+    uint32_t index = index_of(handle);
+    Slot &slot = m_slots[index];
+    object->~T();
+
+    if (slot.position + 1 == m_end) {
+      --m_end;
+    } else {
+      m_holes.push_back(slot.position);
+    }
+    m_owner[slot.position] = NO_SLOT;
+
+    // Retire the generation so outstanding handles become stale
+    slot.generation = next_generation(slot.generation);
+    slot.position = m_free_slot;
+    m_free_slot = index;
+    --m_size;
+  }
+
+  /**
+   * @brief Resolve a handle
+   * @return Pointer to the object, or nullptr if the handle is stale
+   */
+  T *get(Handle handle) const noexcept {
+    uint32_t index = index_of(handle);
+    if (index >= m_capacity)
+      return nullptr;
+    const Slot &slot = m_slots[index];
+    // Free slots reuse `position` as a free-list link, so also confirm
+    // the position is owned by this slot
+    if (slot.generation != generation_of(handle) || slot.position >= m_end ||
+        m_owner[slot.position] != index)
+      return nullptr;
+    return m_storage + slot.position;
+  }
+
+  /**
+   * @brief Check whether a handle refers to a live object
+   */
+  bool valid(Handle handle) const noexcept { return get(handle) != nullptr; }
+
+  /**
+   * @brief Move live objects into a dense prefix of storage
+   *
+   * Repeatedly moves the highest-addressed live object into the lowest
+   * hole, updating the indirection table. Handles stay valid; pointers
+   * from get() do not.
+   *
+   * @return Number of objects moved
+   */
+  size_t compact() {
+    size_t moved = 0;
+    size_t low = 0;
+    size_t high = m_end;
+    for (;;) {
+      while (low < high && m_owner[low] != NO_SLOT)
+        ++low;
+      while (high > low && m_owner[high - 1] == NO_SLOT)
+        --high;
+      if (low >= high)
+        break;
+
+      // low is a hole, high - 1 is live and above it
+      uint32_t index = m_owner[high - 1];
+      T *source = m_storage + (high - 1);
+      new (m_storage + low) T(std::move(*source));
+      source->~T();
+
+      m_owner[low] = index;
+      m_owner[high - 1] = NO_SLOT;
+      m_slots[index].position = static_cast<uint32_t>(low);
+      ++moved;
+    }
+
+    m_end = m_size;
+    m_holes.clear();
+    return moved;
+  }
+
+  /**
+   * @brief Destroy all objects (all outstanding handles become stale)
+   */
+  void clear() {
+    for (size_t index = 0; index < m_capacity; ++index) {
+      destroy(make_handle(static_cast<uint32_t>(index),
+                          m_slots[index].generation));
+    }
+    m_end = 0;
+    m_holes.clear();
+  }
+
+  /**
+   * @brief Visit live objects in storage order
+   * @param func Callable invoked as func(T&)
+   */
+  template <typename Func> void for_each(Func &&func) {
+    for (size_t position = 0; position < m_end; ++position) {
+      if (m_owner[position] != NO_SLOT)
+        func(m_storage[position]);
+    }
+  }
+
+  size_t size() const noexcept { return m_size; }
+  size_t capacity() const noexcept { return m_capacity; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  /**
+   * @brief Length of the used storage prefix, including holes
+   */
+  size_t span() const noexcept { return m_end; }
+
+  /**
+   * @brief Fraction of the used storage prefix holding live objects
+   */
+  double density() const noexcept {
+    return m_end ? static_cast<double>(m_size) / static_cast<double>(m_end)
+                 : 1.0;
+  }
+
+private:
+  struct Slot {
+    uint32_t position;   // Storage position, or next free slot when free
+    uint32_t generation; // Current generation (never 0)
+  };
+
+  static constexpr uint32_t NO_SLOT = ~uint32_t(0);
+  static constexpr Handle INDEX_MASK = (Handle(1) << INDEX_BITS) - 1;
+  static constexpr uint32_t GENERATION_MASK =
+      static_cast<uint32_t>((uint64_t(1) << GENERATION_BITS) - 1);
+
+  static Handle make_handle(uint32_t index, uint32_t generation) noexcept {
+    return static_cast<Handle>(Handle(generation) << INDEX_BITS | index);
+  }
+
+  static uint32_t index_of(Handle handle) noexcept {
+    return static_cast<uint32_t>(handle & INDEX_MASK);
+  }
+
+  static uint32_t generation_of(Handle handle) noexcept {
+    return static_cast<uint32_t>(handle >> INDEX_BITS);
+  }
+
+  static uint32_t next_generation(uint32_t generation) noexcept {
+    generation = (generation + 1) & GENERATION_MASK;
+    return generation ? generation : 1;
+  }
+
+  T *m_storage;                 // Object storage (capacity elements)
+  size_t m_capacity;            // Maximum live objects
+  size_t m_size;                // Live objects
+  size_t m_end;                 // Storage positions [0, m_end) in use
+  uint32_t m_free_slot;         // Head of free slot list
+  std::vector<Slot> m_slots;    // Indirection table, indexed by handle
+  std::vector<uint32_t> m_owner; // Slot owning each storage position
+  std::vector<uint32_t> m_holes; // Free positions below m_end
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_HANDLE_POOL_HPP
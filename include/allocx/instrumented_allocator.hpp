@@ -0,0 +1,228 @@
+#ifndef ALLOCX_INSTRUMENTED_ALLOCATOR_HPP
+#define ALLOCX_INSTRUMENTED_ALLOCATOR_HPP
+
+#include "latency_histogram.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Sampling latency instrumentation for any allocator
+ *
+ * Times one in every `sample_period` allocate()/deallocate() calls with
+ * the CPU timestamp counter and records the result into a log-linear
+ * histogram. Unsampled calls only pay for a countdown, so the wrapper
+ * can stay enabled in production to watch p99/p999 live.
+ *
+ * Each thread keeps its own countdown and histograms for each wrapper,
+ * found through a small thread-local table keyed by a wrapper id that is
+ * never reused. Calls therefore write no memory shared between threads:
+ * wrappers never sample each other's calls, every thread samples exactly
+ * one call in sample_period, and the per-thread histograms are merged
+ * only when read. The wrapper is otherwise as thread-safe as the wrapped
+ * allocator.
+ *
+ * Usage:
+ *   PoolAllocator pool(64, 1000);
+ *   InstrumentedAllocator<PoolAllocator> timed(pool, 128);
+ *   void* ptr = timed.allocate(64);
+ *   timed.dump(std::cout);
+ */
+template <typename Allocator> class InstrumentedAllocator {
+public:
+  /**
+   * @brief Construct with reference to underlying allocator
+   * @param allocator Allocator to instrument
+   * @param sample_period Time one call in every sample_period (>= 1)
+   */
+  explicit InstrumentedAllocator(Allocator &allocator,
+                                 uint32_t sample_period = 64) noexcept
+      : m_allocator(&allocator),
+        m_sample_period(sample_period ? sample_period : 1), m_id(next_id()) {}
+
+  /**
+   * @brief Allocate, timing the call if it is sampled
+   */
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    Shard &shard = local_shard();
+    if (!should_sample(shard)) {
+      return m_allocator->allocate(size, alignment);
+    }
+    uint64_t start = utils::read_tsc();
+    void *ptr = m_allocator->allocate(size, alignment);
+    shard.allocate_latency.record(utils::read_tsc() - start);
+    return ptr;
+  }
+
+  /**
+   * @brief Deallocate, timing the call if it is sampled
+   */
+  void deallocate(void *ptr, size_t size = 0) {
+    Shard &shard = local_shard();
+    if (!should_sample(shard)) {
+      m_allocator->deallocate(ptr, size);
+      return;
+    }
+    uint64_t start = utils::read_tsc();
+    m_allocator->deallocate(ptr, size);
+    shard.deallocate_latency.record(utils::read_tsc() - start);
+  }
+
+  void reset() { m_allocator->reset(); }
+  bool owns(void *ptr) const { return m_allocator->owns(ptr); }
+  size_t total_size() const { return m_allocator->total_size(); }
+  size_t used_size() const { return m_allocator->used_size(); }
+
+  /**
+   * @brief Sampled allocate() latencies in TSC ticks, from all threads
+   *
+   * Merged on each call into a snapshot owned by the wrapper, which the
+   * next call to this function replaces.
+   */
+  const LatencyHistogram &allocate_latency() const {
+    return merge(&Shard::allocate_latency, m_allocate_snapshot);
+  }
+
+  /**
+   * @brief Sampled deallocate() latencies in TSC ticks, from all threads
+   *
+   * Merged on each call like allocate_latency().
+   */
+  const LatencyHistogram &deallocate_latency() const {
+    return merge(&Shard::deallocate_latency, m_deallocate_snapshot);
+  }
+
+  uint32_t sample_period() const noexcept { return m_sample_period; }
+
+  /**
+   * @brief Discard all recorded samples
+   */
+  void clear_latency() {
+    std::lock_guard<std::mutex> guard(m_shards_lock);
+    for (const auto &shard : m_shards) {
+      shard->allocate_latency.clear();
+      shard->deallocate_latency.clear();
+    }
+  }
+
+  /**
+   * @brief Print sampled latency percentiles in nanoseconds
+   */
+  void dump(std::ostream &os) const {
+    double ticks_per_ns = utils::tsc_ticks_per_ns();
+    os << "allocate:   ";
+    allocate_latency().dump(os, ticks_per_ns, "ns");
+    os << "\ndeallocate: ";
+    deallocate_latency().dump(os, ticks_per_ns, "ns");
+    os << "\n";
+  }
+
+  /**
+   * @brief Get reference to underlying allocator
+   */
+  Allocator &get_underlying() noexcept { return *m_allocator; }
+
+  // Prevent copying
+  InstrumentedAllocator(const InstrumentedAllocator &) = delete;
+  InstrumentedAllocator &operator=(const InstrumentedAllocator &) = delete;
+
+private:
+  // One thread's view of one wrapper; only that thread writes to it
+  struct alignas(utils::CACHE_LINE_SIZE) Shard {
+    uint32_t countdown = 0; // Calls left until the next sample
+    std::thread::id thread;
+    LatencyHistogram allocate_latency;
+    LatencyHistogram deallocate_latency;
+  };
+
+  // Thread-local table entry: the shard of wrapper `id` (0 = empty). The
+  // shard of an evicted entry may belong to a destroyed wrapper, so only
+  // a matching id makes it usable.
+  struct Slot {
+    uint64_t id;
+    Shard *shard;
+  };
+
+  // Wrappers a thread can use in turn without a lookup; more still work,
+  // sharing entries at the cost of a locked lookup when they alternate
+  static constexpr size_t SLOTS = 16;
+
+  static uint64_t next_id() noexcept {
+    static std::atomic<uint64_t> last{0};
+    return last.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static Slot *slots() noexcept {
+    static thread_local Slot t_slots[SLOTS] = {};
+    return t_slots;
+  }
+
+  Shard &local_shard() {
+    Slot &slot = slots()[m_id % SLOTS];
+    if (slot.id != m_id) {
+      attach(slot);
+    }
+    return *slot.shard;
+  }
+
+  // Point slot at this thread's shard, creating it on first use. Shards
+  // live as long as the wrapper; a thread reusing a finished thread's id
+  // takes over its shard.
+  void attach(Slot &slot) {
+    std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> guard(m_shards_lock);
+    Shard *found = nullptr;
+    for (const auto &shard : m_shards) {
+      if (shard->thread == self) {
+        found = shard.get();
+        break;
+      }
+    }
+    if (found == nullptr) {
+      m_shards.push_back(std::unique_ptr<Shard>(new Shard()));
+      found = m_shards.back().get();
+      found->thread = self;
+    }
+    slot.id = m_id;
+    slot.shard = found;
+  }
+
+  bool should_sample(Shard &shard) const noexcept {
+    if (shard.countdown == 0) {
+      shard.countdown = m_sample_period - 1;
+      return true;
+    }
+    --shard.countdown;
+    return false;
+  }
+
+  const LatencyHistogram &merge(LatencyHistogram Shard::*member,
+                                LatencyHistogram &snapshot) const {
+    std::lock_guard<std::mutex> guard(m_shards_lock);
+    snapshot.clear();
+    for (const auto &shard : m_shards) {
+      snapshot.merge((*shard).*member);
+    }
+    return snapshot;
+  }
+
+  Allocator *m_allocator;
+  uint32_t m_sample_period;
+  uint64_t m_id; // Key into the thread-local slot tables
+  mutable std::mutex m_shards_lock;
+  std::vector<std::unique_ptr<Shard>> m_shards; // One per thread that called
+  mutable LatencyHistogram m_allocate_snapshot;
+  mutable LatencyHistogram m_deallocate_snapshot;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_INSTRUMENTED_ALLOCATOR_HPP
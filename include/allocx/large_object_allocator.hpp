@@ -0,0 +1,142 @@
+#ifndef ALLOCX_LARGE_OBJECT_ALLOCATOR_HPP
+#define ALLOCX_LARGE_OBJECT_ALLOCATOR_HPP
+
+#include "allocator_base.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Tuning for LargeObjectAllocator
+ */
+struct LargeObjectOptions {
+  /// Requests below this go to the fallback allocator (if one is given)
+  size_t threshold = 256 * 1024;
+  /// Freed mappings kept for reuse
+  size_t cache_entries = 8;
+  /// Upper bound on bytes held by the cache
+  size_t cache_bytes = 64 * 1024 * 1024;
+};
+
+/**
+ * @brief Allocator that maps each large request directly from the OS
+ *
+ * Every allocation at or above the threshold gets its own mmap'd region,
+ * so multi-MiB buffers never fragment a fixed arena and requests are only
+ * limited by address space. Recently freed mappings are cached (most
+ * recent first) and reused by requests that fit them with at most 25%
+ * slack, avoiding munmap/mmap churn and repeated page faults.
+ *
+ * Live mappings are kept in an address-ordered map, so owns() and
+ * deallocate() cost one O(log n) lookup. reallocate() grows mappings
+ * with mremap, extending them in place or moving their pages instead of
+ * copying the data.
+ *
+ * Requests below the threshold are forwarded to an optional fallback
+ * allocator (e.g. a FreeListAllocator); without one they are mapped too.
+ *
+ * Time Complexity:
+ * - Allocation: one mmap, or O(cache_entries) on a cache hit
+ * - Deallocation: O(log n) plus munmap when the cache is full
+ *
+ * Use Cases:
+ * - Multi-MiB I/O, image and mesh buffers
+ * - Growable buffers with unpredictable final size
+ */
+class LargeObjectAllocator : public IAllocator {
+public:
+  /**
+   * @brief Construct a large-object allocator
+   * @param options Threshold and cache limits
+   * @param fallback Allocator for requests below the threshold (optional)
+   */
+  explicit LargeObjectAllocator(
+      const LargeObjectOptions &options = LargeObjectOptions(),
+      IAllocator *fallback = nullptr);
+
+  ~LargeObjectAllocator() override;
+
+  // Prevent copying
+  LargeObjectAllocator(const LargeObjectAllocator &) = delete;
+  LargeObjectAllocator &operator=(const LargeObjectAllocator &) = delete;
+
+  /**
+   * @brief Allocate from a mapping (or the fallback below the threshold)
+   * @param size Number of bytes to allocate
+   * @param alignment Required alignment (page-aligned or stricter)
+   * @return Pointer to memory, or nullptr on failure
+   */
+  void *allocate(size_t size,
+                 size_t alignment = alignof(std::max_align_t)) override;
+
+  /**
+   * @brief Release a mapping to the cache (or the OS) or the fallback
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  /**
+   * @brief Grow in place within the mapping or by extending it
+   */
+  bool try_expand(void *ptr, size_t new_size) override;
+
+  /**
+   * @brief Resize with mremap; may move the mapping without copying
+   */
+  void *reallocate(void *ptr, size_t old_size, size_t new_size,
+                   size_t alignment = alignof(std::max_align_t)) override;
+
+  /**
+   * @brief Unmap every live and cached mapping
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+
+  /**
+   * @brief Bytes mapped by live and cached mappings
+   */
+  size_t total_size() const override;
+
+  /**
+   * @brief Bytes mapped by live mappings
+   */
+  size_t used_size() const override;
+
+  size_t mapping_count() const noexcept { return m_mappings.size(); }
+  size_t cached_count() const noexcept { return m_cache.size(); }
+
+  /**
+   * @brief Allocations served from the mapping cache
+   */
+  size_t cache_hits() const noexcept { return m_cache_hits; }
+
+  const LargeObjectOptions &options() const noexcept { return m_options; }
+
+private:
+  struct CachedMapping {
+    void *base;
+    size_t size;
+  };
+
+  // Mapping containing ptr, or end()
+  std::map<uintptr_t, size_t>::const_iterator find(const void *ptr) const;
+
+  void *take_cached(size_t &size, size_t alignment);
+  void release(void *base, size_t size);
+
+  LargeObjectOptions m_options;
+  IAllocator *m_fallback;                // Below-threshold requests
+  std::map<uintptr_t, size_t> m_mappings; // Live mapping base -> size
+  std::vector<CachedMapping> m_cache;     // Freed mappings, newest first
+  size_t m_mapped_bytes;                  // Bytes in live mappings
+  size_t m_cached_bytes;                  // Bytes in cached mappings
+  size_t m_cache_hits;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_LARGE_OBJECT_ALLOCATOR_HPP
@@ -0,0 +1,191 @@
+#ifndef ALLOCX_LATENCY_HISTOGRAM_HPP
+#define ALLOCX_LATENCY_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+namespace allocx {
+
+/**
+ * @brief Log-linear (HDR-style) latency histogram
+ *
+ * Values below SUB_BUCKETS are counted exactly. Larger values are grouped
+ * by their most significant bit, and each power-of-two range is split into
+ * SUB_BUCKETS linear sub-buckets, giving a fixed relative error of about
+ * 1 / SUB_BUCKETS (~6%) across the full 64-bit range.
+ *
+ * Counters are relaxed atomics, so record() may be called concurrently
+ * from several threads. Per-thread histograms can be combined with merge().
+ *
+ * Usage:
+ *   LatencyHistogram hist;
+ *   hist.record(cycles);
+ *   uint64_t p99 = hist.percentile(99.0);
+ */
+class LatencyHistogram {
+public:
+  static constexpr unsigned SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  LatencyHistogram() noexcept { clear(); }
+
+  /**
+   * @brief Record a single value
+   * @param value Latency sample (any unit, typically TSC ticks)
+   */
+  void record(uint64_t value) noexcept {
+    m_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    update_min(value);
+    update_max(value);
+  }
+
+  /**
+   * @brief Add all samples of another histogram into this one
+   * @param other Histogram to merge (may be concurrently recorded into)
+   */
+  void merge(const LatencyHistogram &other) noexcept {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+      uint64_t n = other.m_buckets[i].load(std::memory_order_relaxed);
+      if (n) {
+        m_buckets[i].fetch_add(n, std::memory_order_relaxed);
+      }
+    }
+    m_count.fetch_add(other.count(), std::memory_order_relaxed);
+    m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    if (other.count()) {
+      update_min(other.min());
+      update_max(other.max());
+    }
+  }
+
+  /**
+   * @brief Discard all samples
+   */
+  void clear() noexcept {
+    for (auto &bucket : m_buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const noexcept {
+    return m_count.load(std::memory_order_relaxed);
+  }
+
+  uint64_t min() const noexcept {
+    return count() ? m_min.load(std::memory_order_relaxed) : 0;
+  }
+
+  uint64_t max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+
+  double mean() const noexcept {
+    uint64_t n = count();
+    return n ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / n
+             : 0.0;
+  }
+
+  /**
+   * @brief Get the value at a given percentile
+   * @param pct Percentile in [0, 100]
+   * @return Highest value equivalent to the bucket holding that rank
+   */
+  uint64_t percentile(double pct) const noexcept {
+    uint64_t n = count();
+    if (n == 0)
+      return 0;
+
+    uint64_t rank = static_cast<uint64_t>(pct / 100.0 * static_cast<double>(n));
+    if (rank >= n)
+      rank = n - 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+      seen += m_buckets[i].load(std::memory_order_relaxed);
+      if (seen > rank) {
+        uint64_t upper = bucket_upper_bound(i);
+        return upper < max() ? upper : max();
+      }
+    }
+    return max();
+  }
+
+  /**
+   * @brief Write a one-line summary
+   * @param os Output stream
+   * @param ticks_per_unit Divisor applied to every value (e.g. TSC ticks/ns)
+   * @param unit Unit suffix to print
+   */
+  void dump(std::ostream &os, double ticks_per_unit = 1.0,
+            const char *unit = "ticks") const {
+    auto scaled = [&](double v) { return v / ticks_per_unit; };
+    os << "n=" << count() << " mean=" << scaled(mean()) << unit
+       << " min=" << scaled(static_cast<double>(min())) << unit
+       << " p50=" << scaled(static_cast<double>(percentile(50.0))) << unit
+       << " p90=" << scaled(static_cast<double>(percentile(90.0))) << unit
+       << " p99=" << scaled(static_cast<double>(percentile(99.0))) << unit
+       << " p999=" << scaled(static_cast<double>(percentile(99.9))) << unit
+       << " max=" << scaled(static_cast<double>(max())) << unit;
+  }
+
+  /**
+   * @brief Map a value to its bucket index
+   */
+  static size_t bucket_index(uint64_t value) noexcept {
+    if (value < SUB_BUCKETS)
+      return static_cast<size_t>(value);
+
+    unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) - SUB_BUCKETS;
+    return (shift + 1) * SUB_BUCKETS + sub;
+  }
+
+  /**
+   * @brief Largest value that maps to a bucket
+   */
+  static uint64_t bucket_upper_bound(size_t index) noexcept {
+    if (index < SUB_BUCKETS)
+      return index;
+
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    uint64_t top = SUB_BUCKETS + index % SUB_BUCKETS;
+    return (top << shift) + ((uint64_t(1) << shift) - 1);
+  }
+
+private:
+  void update_min(uint64_t value) noexcept {
+    uint64_t current = m_min.load(std::memory_order_relaxed);
+    while (value < current &&
+           !m_min.compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  void update_max(uint64_t value) noexcept {
+    uint64_t current = m_max.load(std::memory_order_relaxed);
+    while (value > current &&
+           !m_max.compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+  std::atomic<uint64_t> m_count;
+  std::atomic<uint64_t> m_sum;
+  std::atomic<uint64_t> m_min;
+  std::atomic<uint64_t> m_max;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,116 @@
+#ifndef ALLOCX_NUMA_POOL_SELECTOR_HPP
+#define ALLOCX_NUMA_POOL_SELECTOR_HPP
+
+#include "allocator_base.hpp"
+#include "os_memory.hpp"
+#include "pool_allocator.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief One PoolAllocator per NUMA node, chosen by the calling thread
+ *
+ * Each node gets its own pool, backed by memory mapped with the
+ * requested placement policy and created lazily by the first thread that
+ * allocates on that node. With NumaPolicy::first_touch no policy is set
+ * and building the pool's free list on that thread faults the pages in
+ * locally; bind/preferred pin them with mbind regardless of who touches
+ * them first.
+ *
+ * allocate() uses the pool of the node the caller is running on and
+ * falls back to other nodes only when it is exhausted; deallocate()
+ * returns a chunk to the pool it came from. Each pool has its own lock,
+ * so threads on different nodes never contend. On single-node machines
+ * this is one locked pool.
+ *
+ * Time Complexity:
+ * - Allocation: O(1) (plus O(nodes) when the local pool is exhausted)
+ * - Deallocation: O(nodes) to find the home pool
+ *
+ * Use Cases:
+ * - Worker threads spread over sockets sharing one allocator object
+ * - Replacing pools created by a main thread on node 0
+ */
+class NumaPoolSelector : public IAllocator {
+public:
+  /**
+   * @brief Construct a selector (no memory is mapped until first use)
+   * @param chunk_size Size of each chunk
+   * @param chunks_per_node Chunks in each node's pool
+   * @param policy Placement of each node's pool memory
+   * @param alignment Chunk alignment
+   */
+  NumaPoolSelector(size_t chunk_size, size_t chunks_per_node,
+                   os::NumaPolicy policy = os::NumaPolicy::bind,
+                   size_t alignment = alignof(std::max_align_t));
+
+  ~NumaPoolSelector() override;
+
+  // Prevent copying
+  NumaPoolSelector(const NumaPoolSelector &) = delete;
+  NumaPoolSelector &operator=(const NumaPoolSelector &) = delete;
+
+  /**
+   * @brief Allocate a chunk from the calling thread's node
+   * @param size Must not exceed the chunk size
+   * @param alignment Ignored (alignment set at construction)
+   * @return Pointer to a chunk, or nullptr if every pool is exhausted
+   */
+  void *allocate(size_t size = 0, size_t alignment = 0) override;
+
+  /**
+   * @brief Return a chunk to its home node's pool (any thread)
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  /**
+   * @brief Reset every node's pool (all chunks free)
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+  size_t total_size() const override;
+  size_t used_size() const override;
+
+  size_t node_count() const noexcept { return m_nodes.size(); }
+
+  /**
+   * @brief Node whose pool contains ptr, or -1
+   */
+  int node_of(const void *ptr) const noexcept;
+
+  /**
+   * @brief Whether a node's pool has been created
+   */
+  bool has_pool(int node) const noexcept;
+
+  /**
+   * @brief Whether the kernel accepted the placement policy for a node
+   *
+   * False when the pool does not exist yet or mbind is unavailable; the
+   * pool then falls back to first-touch placement.
+   */
+  bool placement_applied(int node) const noexcept;
+
+  os::NumaPolicy policy() const noexcept { return m_policy; }
+
+private:
+  struct Node;
+
+  // Pool of a node, created on first use; nullptr if mapping fails
+  PoolAllocator *pool_for(Node &node, int index);
+
+  size_t m_chunk_size;
+  size_t m_chunks_per_node;
+  size_t m_alignment;
+  os::NumaPolicy m_policy;
+  std::vector<std::unique_ptr<Node>> m_nodes;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_NUMA_POOL_SELECTOR_HPP
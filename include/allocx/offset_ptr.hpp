@@ -0,0 +1,76 @@
+#ifndef ALLOCX_OFFSET_PTR_HPP
+#define ALLOCX_OFFSET_PTR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace allocx {
+
+/**
+ * @brief Self-relative pointer for memory mapped at varying addresses
+ *
+ * Stores the distance from its own address to the target instead of an
+ * absolute address, so object graphs built inside a file or shared
+ * mapping stay valid when the region is mapped somewhere else. Both the
+ * offset_ptr and its target must live in the same mapping.
+ *
+ * Copying recomputes the distance for the new location. A distance of 0
+ * encodes nullptr, so an offset_ptr cannot point at itself.
+ *
+ * @tparam T Pointee type
+ */
+template <typename T> class offset_ptr {
+public:
+  using element_type = T;
+
+  offset_ptr() noexcept : m_offset(0) {}
+  offset_ptr(std::nullptr_t) noexcept : m_offset(0) {}
+  offset_ptr(T *ptr) noexcept : m_offset(distance_to(ptr)) {}
+  offset_ptr(const offset_ptr &other) noexcept
+      : m_offset(distance_to(other.get())) {}
+
+  offset_ptr &operator=(const offset_ptr &other) noexcept {
+    m_offset = distance_to(other.get());
+    return *this;
+  }
+  offset_ptr &operator=(T *ptr) noexcept {
+    m_offset = distance_to(ptr);
+    return *this;
+  }
+
+  /**
+   * @brief Absolute address in the current mapping
+   */
+  T *get() const noexcept {
+    if (m_offset == 0)
+      return nullptr;
+    return reinterpret_cast<T *>(reinterpret_cast<uintptr_t>(this) +
+                                 static_cast<uintptr_t>(m_offset));
+  }
+
+  T &operator*() const noexcept { return *get(); }
+  T *operator->() const noexcept { return get(); }
+  T &operator[](std::ptrdiff_t index) const noexcept { return get()[index]; }
+  explicit operator bool() const noexcept { return m_offset != 0; }
+
+  friend bool operator==(const offset_ptr &a, const offset_ptr &b) noexcept {
+    return a.get() == b.get();
+  }
+  friend bool operator!=(const offset_ptr &a, const offset_ptr &b) noexcept {
+    return a.get() != b.get();
+  }
+
+private:
+  std::ptrdiff_t distance_to(const T *ptr) const noexcept {
+    if (ptr == nullptr)
+      return 0;
+    return static_cast<std::ptrdiff_t>(reinterpret_cast<uintptr_t>(ptr) -
+                                       reinterpret_cast<uintptr_t>(this));
+  }
+
+  std::ptrdiff_t m_offset; // Target address minus this address; 0 = null
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_OFFSET_PTR_HPP
@@ -0,0 +1,144 @@
+#ifndef ALLOCX_OS_MEMORY_HPP
+#define ALLOCX_OS_MEMORY_HPP
+
+#include <cstddef>
+
+namespace allocx {
+namespace os {
+
+/**
+ * @brief Thin wrappers over the OS virtual-memory calls (POSIX mmap)
+ *
+ * All functions report failure by returning nullptr/false rather than
+ * throwing, like the allocators built on them.
+ */
+
+/**
+ * @brief System page size in bytes
+ */
+size_t page_size() noexcept;
+
+/**
+ * @brief Map zeroed, private, read-write memory
+ * @param size Bytes to map (rounded up to whole pages)
+ * @return Page-aligned pointer, or nullptr on failure
+ */
+void *map(size_t size) noexcept;
+
+/**
+ * @brief Map memory whose start is aligned beyond the page size
+ *
+ * Over-maps by `alignment` and unmaps the unused head and tail.
+ *
+ * @param size Bytes to map (rounded up to whole pages)
+ * @param alignment Power-of-two alignment of the returned pointer
+ * @return Aligned pointer, or nullptr on failure
+ */
+void *map_aligned(size_t size, size_t alignment) noexcept;
+
+/**
+ * @brief Map a file descriptor read-write and shared between processes
+ * @param fd Descriptor of a memfd, shm_open object or regular file
+ * @param size Bytes to map from offset 0
+ * @return Page-aligned pointer, or nullptr on failure
+ */
+void *map_shared(int fd, size_t size) noexcept;
+
+/**
+ * @brief Write dirty pages of a file mapping back to the file (msync)
+ * @return false if writing back failed
+ */
+bool flush(void *ptr, size_t size) noexcept;
+
+/**
+ * @brief Fault in every page of a range for writing, keeping its contents
+ *
+ * Uses MADV_POPULATE_WRITE where available (Linux 5.14+), otherwise an
+ * atomic no-op write per page; either way concurrent writers to the
+ * range lose no stores, so this may run on a background thread.
+ */
+void prefault(void *ptr, size_t size) noexcept;
+
+/**
+ * @brief Lock a range into RAM (mlock); also faults it in
+ * @return false if refused, e.g. above RLIMIT_MEMLOCK
+ */
+bool lock(void *ptr, size_t size) noexcept;
+
+/**
+ * @brief Undo lock() (munlock)
+ */
+void unlock(void *ptr, size_t size) noexcept;
+
+/**
+ * @brief Return the whole pages inside a range to the OS, keeping it mapped
+ *
+ * Only pages entirely inside [ptr, ptr + size) are released. With lazy
+ * (MADV_FREE) the kernel reclaims them only under memory pressure and
+ * they keep their contents until then; otherwise (MADV_DONTNEED) they are
+ * dropped at once. Either way the next write faults in a zeroed page, so
+ * only call this on memory holding no live data.
+ *
+ * @return Bytes released (0 if the range spans no whole page or on failure)
+ */
+size_t decommit(void *ptr, size_t size, bool lazy) noexcept;
+
+/**
+ * @brief Unmap memory from map()/map_aligned()/map_shared()/remap()
+ */
+void unmap(void *ptr, size_t size) noexcept;
+
+/**
+ * @brief Resize a mapping (Linux mremap)
+ * @param ptr Start of the mapping
+ * @param old_size Current mapping size
+ * @param new_size Requested mapping size
+ * @param may_move Allow the kernel to move the mapping
+ * @return New start (== ptr unless moved), or nullptr on failure
+ */
+void *remap(void *ptr, size_t old_size, size_t new_size,
+            bool may_move) noexcept;
+
+/**
+ * @brief Where the kernel places the pages of a range (Linux mempolicy)
+ */
+enum class NumaPolicy {
+  first_touch, ///< Default: each page lands on the node that first writes it
+  bind,        ///< Only the given node; allocation fails when it is full
+  preferred,   ///< The given node, falling back to others when full
+  interleave   ///< Round-robin across all nodes
+};
+
+/**
+ * @brief Number of NUMA nodes (1 on non-NUMA machines)
+ */
+size_t numa_node_count() noexcept;
+
+/**
+ * @brief NUMA node of the CPU the calling thread is running on
+ */
+int current_numa_node() noexcept;
+
+/**
+ * @brief Apply a placement policy to a range before it is touched (mbind)
+ *
+ * Pages already faulted in keep their node.
+ *
+ * @param ptr Page-aligned start of the range
+ * @param size Bytes in the range
+ * @param policy Placement policy
+ * @param node Target node for bind/preferred (ignored otherwise)
+ * @return false if the kernel rejected the policy (e.g. no NUMA support)
+ */
+bool set_numa_policy(void *ptr, size_t size, NumaPolicy policy,
+                     int node) noexcept;
+
+/**
+ * @brief Node holding the page at ptr (faulting it in), or -1 on failure
+ */
+int numa_node_of(const void *ptr) noexcept;
+
+} // namespace os
+} // namespace allocx
+
+#endif // ALLOCX_OS_MEMORY_HPP
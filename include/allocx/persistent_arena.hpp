@@ -0,0 +1,143 @@
+#ifndef ALLOCX_PERSISTENT_ARENA_HPP
+#define ALLOCX_PERSISTENT_ARENA_HPP
+
+#include "allocator_base.hpp"
+#include "stack_allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace allocx {
+
+/**
+ * @brief File-backed arena that can be checkpointed and re-mapped later
+ *
+ * A StackAllocator over a shared mmap of a file. Objects built in the
+ * arena (linked with offset_ptr, never raw pointers) are written straight
+ * to the page cache; checkpoint() records the allocation top and a root
+ * object in the file header and flushes it to disk. open() maps the file
+ * again (at any address) and resumes from the last checkpoint without
+ * reading anything but the header, so a warm start costs page faults on
+ * the parts actually touched instead of rebuilding the whole graph.
+ *
+ * Objects are modified in place: checkpoint() is a durability point for
+ * the allocation state, not a transaction over object contents.
+ * restore() discards allocations made since the last checkpoint.
+ *
+ * Time Complexity:
+ * - Allocation: O(1)
+ * - open(): O(1), pages load lazily on first access
+ * - checkpoint(): O(dirty pages)
+ *
+ * Use Cases:
+ * - Reference data that is expensive to rebuild at startup
+ * - Precomputed lookup tables and indexes
+ */
+class PersistentArena : public IAllocator {
+public:
+  /// Position relative to the start of the file; 0 is never an object
+  using offset_type = uint64_t;
+  static constexpr offset_type null_offset = 0;
+
+  /**
+   * @brief Create (or truncate) a file and map it as an empty arena
+   * @param path File to create
+   * @param capacity File size in bytes, including a small header
+   * @return The arena, or nullptr on failure
+   */
+  static std::unique_ptr<PersistentArena> create(const char *path,
+                                                 size_t capacity);
+
+  /**
+   * @brief Map an arena file and resume from its last checkpoint
+   * @return The arena, or nullptr if the file is missing or not an arena
+   */
+  static std::unique_ptr<PersistentArena> open(const char *path);
+
+  /**
+   * @brief Unmap the file (without checkpointing)
+   */
+  ~PersistentArena() override;
+
+  // Prevent copying
+  PersistentArena(const PersistentArena &) = delete;
+  PersistentArena &operator=(const PersistentArena &) = delete;
+
+  /**
+   * @brief Bump-allocate from the file
+   * @return Pointer into the mapping, or nullptr if the file is full
+   */
+  void *allocate(size_t size,
+                 size_t alignment = alignof(std::max_align_t)) override;
+
+  /**
+   * @brief No-op, as for StackAllocator; use reset() or restore()
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  bool try_expand(void *ptr, size_t new_size) override;
+
+  /**
+   * @brief Discard every allocation and the root (until checkpointed)
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+  size_t total_size() const override;
+  size_t used_size() const override;
+
+  /**
+   * @brief Record the allocation top and root, and flush the file
+   * @return false if writing back to the file failed
+   */
+  bool checkpoint();
+
+  /**
+   * @brief Roll back allocations and the root to the last checkpoint
+   */
+  void restore();
+
+  /**
+   * @brief Set the object that open() hands back after a restart
+   */
+  void set_root(const void *object) noexcept { m_root = offset_of(object); }
+
+  /**
+   * @brief Root object recorded by set_root(), or nullptr
+   */
+  template <typename T> T *root() const noexcept {
+    return static_cast<T *>(from_offset(m_root));
+  }
+
+  /**
+   * @brief Offset of an address inside the mapping
+   */
+  offset_type offset_of(const void *ptr) const noexcept;
+
+  /**
+   * @brief Address of an offset in this mapping
+   * @return Pointer, or nullptr for null_offset and out-of-range offsets
+   */
+  void *from_offset(offset_type offset) const noexcept;
+
+  /**
+   * @brief Number of checkpoints taken over the file's lifetime
+   */
+  uint64_t checkpoint_count() const noexcept;
+
+private:
+  struct Header;
+
+  PersistentArena(int fd, void *mapping, size_t size);
+
+  Header *m_header;       // Start of the mapping
+  size_t m_size;          // File and mapping size
+  int m_fd;               // Open descriptor of the file
+  StackAllocator m_stack; // Allocation state over the data region
+  offset_type m_root;     // Current root (checkpointed by checkpoint())
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_PERSISTENT_ARENA_HPP
@@ -5,9 +5,40 @@
 #include "utils.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace allocx {
 
+/**
+ * @brief Optional PoolAllocator features
+ */
+struct PoolOptions {
+    /// Keep an allocated-chunk bitmap so live chunks can be enumerated
+    bool track_occupancy = false;
+    /// Fault in every page of the region at construction
+    bool prefault = false;
+    /// mlock the region so it is never paged out (best effort)
+    bool lock_memory = false;
+    /// Round chunks up to whole cache lines (and align them to one), so
+    /// objects used by different threads never share a line
+    bool cache_line_padding = false;
+    /// On each allocation, prefetch the new head of the free list (the
+    /// chunk the next allocation returns, and the link it will read), so
+    /// the miss overlaps the caller's work instead of stalling the next call
+    bool prefetch = false;
+    /// Hand out chunks in rough address order instead of LIFO: chunks are
+    /// grouped into page-sized spans, allocation takes the lowest free
+    /// chunk of the fullest span, and wholly free spans are used last so
+    /// trim() can release them. Ignores prefetch.
+    bool address_ordered = false;
+    /// Count free chunks per page (a small side table on the heap) so
+    /// trim() can find releasable pages. Costs a table update on every
+    /// allocate/deallocate; off, trim() releases nothing. Ignored with
+    /// address_ordered, whose spans already know which chunks are free.
+    bool trimmable = false;
+};
+
 /**
  * @brief Pool Allocator for fixed-size object allocation
  * 
@@ -32,9 +63,11 @@ public:
      * @param chunk_size Size of each chunk (must be >= sizeof(void*))
      * @param chunk_count Number of chunks in the pool
      * @param alignment Chunk alignment (default: max align)
+     * @param options Optional features (see PoolOptions)
      */
     explicit PoolAllocator(size_t chunk_size, size_t chunk_count, 
-                           size_t alignment = alignof(std::max_align_t));
+                           size_t alignment = alignof(std::max_align_t),
+                           const PoolOptions& options = PoolOptions());
 
     /**
      * @brief Construct using external memory buffer
@@ -42,9 +75,11 @@ public:
      * @param buffer_size Size of the buffer
      * @param chunk_size Size of each chunk
      * @param alignment Chunk alignment
+     * @param options Optional features (see PoolOptions)
      */
     PoolAllocator(void* buffer, size_t buffer_size, size_t chunk_size,
-                  size_t alignment = alignof(std::max_align_t));
+                  size_t alignment = alignof(std::max_align_t),
+                  const PoolOptions& options = PoolOptions());
 
     ~PoolAllocator() override;
 
@@ -67,6 +102,17 @@ public:
      */
     void deallocate(void* ptr, size_t size = 0) override;
 
+    /**
+     * @brief Resize in place (succeeds while new_size fits the chunk)
+     */
+    bool try_expand(void* ptr, size_t new_size) override;
+
+    /**
+     * @brief Resize within the chunk; fails (nullptr) if new_size exceeds it
+     */
+    void* reallocate(void* ptr, size_t old_size, size_t new_size,
+                     size_t alignment = alignof(std::max_align_t)) override;
+
     /**
      * @brief Reset pool to initial state (all chunks free)
      */
@@ -95,10 +141,207 @@ public:
      */
     size_t free_count() const noexcept;
 
+    /**
+     * @brief Fault in every page of the region without changing it
+     *
+     * Takes the first-touch page faults off the allocation path. May run
+     * on a background thread while the pool is in use.
+     */
+    void prefault() const noexcept;
+
+    /**
+     * @brief Check whether the region is locked in RAM
+     * @return True if PoolOptions::lock_memory was requested and granted
+     */
+    bool locked() const noexcept;
+
+    /**
+     * @brief Return pages that hold only free chunks to the OS
+     *
+     * Examines pages from a cursor that moves down the pool and wraps,
+     * resuming where the previous call stopped, and releases those every
+     * chunk of which is free. Free chunks are counted per page as they
+     * come and go, so each page costs O(1) to check and the free list is
+     * never walked. Each call examines at most TRIM_SCAN_PER_PAGE pages
+     * per page of max_bytes plus TRIM_SCAN_MIN, so a budgeted call does
+     * bounded work however large the pool; the default budget covers the
+     * whole pool in one call.
+     *
+     * Chunks starting in a released page are parked: their links are kept
+     * aside, allocate() steps over them when it meets them on the free
+     * list, and they are linked back a page at a time only once every
+     * other free chunk is in use, so released pages stay released as long
+     * as possible. Does nothing for a locked pool, or one constructed
+     * without PoolOptions::trimmable or address_ordered.
+     *
+     * With PoolOptions::address_ordered, releases runs of wholly free
+     * spans instead, under the same cursor and limit. Released spans are
+     * reused only once no resident free chunk is left. A page shared with
+     * a span that was in use at the time stays resident.
+     */
+    size_t trim(size_t max_bytes = SIZE_MAX, bool lazy = false) override;
+
+    /**
+     * @brief Check whether chunks are handed out in address order
+     * @return True if constructed with PoolOptions::address_ordered
+     */
+    bool address_ordered() const noexcept;
+
+    /**
+     * @brief Check whether live chunks can be enumerated
+     * @return True if constructed with PoolOptions::track_occupancy
+     */
+    bool tracks_occupancy() const noexcept;
+
+    /**
+     * @brief Visit every allocated chunk in ascending address order
+     *
+     * Requires PoolOptions::track_occupancy; visits nothing otherwise.
+     *
+     * @param func Callable invoked as func(void* chunk)
+     */
+    template <typename Func>
+    void for_each_allocated(Func&& func) const {
+        visit_words(0, m_occupied.size(), func);
+    }
+
+    /**
+     * @brief Visit allocated chunks using several threads
+     *
+     * Splits the chunk range into contiguous slices (whole bitmap words)
+     * and visits each slice on its own thread, the calling thread taking
+     * the first one. Within a slice chunks are visited in address order.
+     * The pool must not be modified until this returns.
+     *
+     * @param func Thread-safe callable invoked as func(void* chunk)
+     * @param thread_count Number of threads to use (including the caller)
+     */
+    template <typename Func>
+    void for_each_allocated_parallel(Func&& func, size_t thread_count) const {
+        size_t words = m_occupied.size();
+        if (thread_count > words) thread_count = words;
+        if (thread_count <= 1) {
+            visit_words(0, words, func);
+            return;
+        }
+
+        size_t per_thread = (words + thread_count - 1) / thread_count;
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count - 1);
+        for (size_t begin = per_thread; begin < words; begin += per_thread) {
+            size_t end = begin + per_thread < words ? begin + per_thread : words;
+            workers.emplace_back([this, begin, end, &func]() {
+                visit_words(begin, end, func);
+            });
+        }
+        visit_words(0, per_thread, func);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
 private:
+    static constexpr size_t NO_SPAN = SIZE_MAX;
+
+    // Pages (or spans) one trim() call may examine: per page of budget,
+    // plus a floor so small budgets still make progress
+    static constexpr size_t TRIM_SCAN_PER_PAGE = 4;
+    static constexpr size_t TRIM_SCAN_MIN = 256;
+
+    // Free-list mode trim bookkeeping for one page of the chunk array.
+    // A chunk belongs to the page its first byte is in.
+    struct PageState {
+        uint32_t free;       // Free chunks belonging to the page
+        uint32_t parked;     // 1 + index into m_parked, or 0
+        bool released;       // Returned by trim() and untouched since
+    };
+
+    // The free chunks of one page, taken out of service by trim()
+    struct ParkedPage {
+        size_t page;               // Index into m_pages
+        size_t first;              // Index of its first chunk
+        std::vector<void*> links;  // Their free-list links, which may lie
+                                   // in released memory
+    };
+
+    // Address-ordered mode: up to 64 consecutive chunks (about a page)
+    // with a free bitmap. Spans with free chunks sit in one list: by free
+    // count while partly used, m_empty once wholly free, m_released once
+    // trimmed.
+    struct Span {
+        uint64_t free_mask;  // 1 bit = free chunk, lowest bit = lowest address
+        uint32_t free;       // Free chunks
+        uint32_t chunks;     // Chunks in the span (the last may be short)
+        size_t prev;         // Neighbours in its list (NO_SPAN at the ends)
+        size_t next;
+        bool released;       // Wholly free and its pages returned by trim()
+    };
+
     // Rebuild the free list (used by reset and constructors)
     void init_free_list();
 
+    // Rebuild the spans, keeping which ones are released
+    void init_spans();
+
+    // Address-ordered counterparts of allocate/deallocate/trim
+    void* allocate_ordered();
+    void deallocate_ordered(void* ptr);
+    size_t trim_ordered(size_t max_bytes, bool lazy);
+
+    // Head of the list span belongs in, or nullptr if it is full
+    size_t* span_list(const Span& span);
+    void link_span(size_t index);
+    void unlink_span(size_t index);
+
+    // Relink the chunks of the lowest parked page; false if none left
+    bool refill();
+
+    // With PoolOptions::trimmable: step over parked chunks at the head of
+    // the free list and count the head out of its page. Returns the head,
+    // or nullptr if the pool is exhausted.
+    void* take_counted();
+
+    // Index into m_pages of the page holding ptr
+    size_t page_of(const void* ptr) const noexcept {
+        return static_cast<size_t>(reinterpret_cast<uintptr_t>(ptr) -
+                                   reinterpret_cast<uintptr_t>(m_page_base)) >> m_page_shift;
+    }
+
+    // First chunk belonging to page or a later one
+    size_t chunks_from(size_t page) const noexcept;
+
+    // Whether every chunk belonging to page is free (or parked)
+    bool page_free(size_t page) const noexcept;
+
+    // Page the chunk covering the start of page belongs to
+    size_t owner_page(size_t page) const noexcept;
+
+    // Take the free chunks belonging to page off the free list
+    void park(size_t page);
+
+    // Pages (or spans) a trim() call with this budget may examine
+    static size_t trim_scan_limit(size_t max_bytes, size_t unit) noexcept;
+
+    // Set m_chunk_size (and m_alignment) from the requested chunk size
+    void init_chunk_size(size_t chunk_size, const PoolOptions& options);
+
+    // Apply the prefault/lock_memory options to the region
+    void apply_memory_options(const PoolOptions& options);
+
+    // Visit allocated chunks covered by occupancy words [begin, end)
+    template <typename Func>
+    void visit_words(size_t begin, size_t end, Func& func) const {
+        for (size_t word = begin; word < end; ++word) {
+            uint64_t live = m_occupied[word];
+            while (live) {
+                size_t index = word * 64 + static_cast<size_t>(__builtin_ctzll(live));
+                func(utils::ptr_add(m_memory, index * m_chunk_size));
+                live &= live - 1;
+            }
+        }
+    }
+
+    void* m_block;            // Owned allocation (m_memory is aligned inside it)
     void* m_memory;           // Base pointer to memory block
     size_t m_memory_size;     // Total allocated memory size
     size_t m_chunk_size;      // Size of each chunk (aligned)
@@ -107,6 +350,23 @@ private:
     size_t m_alignment;       // Chunk alignment
     void* m_free_list;        // Head of intrusive free list
     bool m_owns_memory;       // Whether we should free m_memory
+    bool m_track_occupancy;   // Whether m_occupied is maintained
+    bool m_prefetch;          // Whether allocate() prefetches the next chunk
+    bool m_address_ordered;   // Whether spans replace the free list
+    bool m_trimmable;         // Whether m_pages is maintained
+    bool m_locked;            // Whether m_memory is mlock'ed
+    std::vector<uint64_t> m_occupied; // 1 bit = allocated chunk
+    char* m_page_base;        // Start of the page holding m_memory
+    size_t m_page_shift;      // log2 of the page size
+    std::vector<PageState> m_pages;
+    std::vector<ParkedPage> m_parked;
+    size_t m_trim_cursor;     // Page (or span) trim() resumes below
+    size_t m_span_chunks;     // Chunks per span
+    std::vector<Span> m_spans;
+    std::vector<size_t> m_partial; // Partly used span lists, by free count
+    uint64_t m_partial_mask;  // Bit f set if m_partial[f] is non-empty
+    size_t m_empty;           // Wholly free spans
+    size_t m_released;        // Wholly free spans released by trim()
 };
 
 } // namespace allocx
@@ -0,0 +1,161 @@
+#ifndef ALLOCX_SHARED_POOL_ALLOCATOR_HPP
+#define ALLOCX_SHARED_POOL_ALLOCATOR_HPP
+
+#include "allocator_base.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace allocx {
+
+/**
+ * @brief Fixed-size pool in shared memory for zero-copy messaging
+ *
+ * A PoolAllocator variant whose region (header, free list and chunks)
+ * lives in a memfd or POSIX shm object that several processes map. Every
+ * process may map the region at a different address, so nothing inside
+ * it stores raw pointers: the free list links chunk indices and callers
+ * exchange chunks as offsets from the region base (offset_of() /
+ * from_offset()), e.g. over a pipe or a shared ring buffer.
+ *
+ * The free list is a lock-free Treiber stack whose head packs a 32-bit
+ * ABA tag with the top chunk index into one 64-bit atomic, so allocate()
+ * and deallocate() are safe from any thread of any attached process.
+ * Links live in a separate index array rather than inside free chunks,
+ * which keeps chunk contents untouched by the allocator.
+ *
+ * Time Complexity:
+ * - Allocation: O(1) (one CAS when uncontended)
+ * - Deallocation: O(1) (one CAS when uncontended)
+ *
+ * Use Cases:
+ * - Feed handler -> strategy message passing without copies
+ * - Buffers shared between a parent and forked workers
+ */
+class SharedPoolAllocator : public IAllocator {
+public:
+  /// Position of a chunk relative to the region base; 0 is never a chunk
+  using offset_type = uint64_t;
+  static constexpr offset_type null_offset = 0;
+
+  /**
+   * @brief Create a new shared pool
+   *
+   * Without a name the region is an anonymous memfd, shared by passing
+   * fd() to another process (fork, SCM_RIGHTS or /proc/<pid>/fd). With a
+   * name it is a POSIX shm object (e.g. "/feed") that other processes
+   * open() by name; creation fails if the name already exists.
+   *
+   * @param chunk_size Size of each chunk
+   * @param chunk_count Number of chunks (below 2^32)
+   * @param name shm_open name, or nullptr for an anonymous memfd
+   * @param alignment Chunk alignment (power of two, at most a page)
+   * @return The pool, or nullptr on failure
+   */
+  static std::unique_ptr<SharedPoolAllocator>
+  create(size_t chunk_size, size_t chunk_count, const char *name = nullptr,
+         size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @brief Map an existing pool from a descriptor (the fd is duplicated)
+   * @return The pool, or nullptr if fd does not hold a valid pool
+   */
+  static std::unique_ptr<SharedPoolAllocator> attach(int fd);
+
+  /**
+   * @brief Map an existing pool created under a shm name
+   * @return The pool, or nullptr if it does not exist or is not ready
+   */
+  static std::unique_ptr<SharedPoolAllocator> open(const char *name);
+
+  /**
+   * @brief Remove a shm name; mapped pools stay valid until unmapped
+   */
+  static bool unlink(const char *name);
+
+  /**
+   * @brief Unmap the region and close the descriptor
+   */
+  ~SharedPoolAllocator() override;
+
+  // Prevent copying
+  SharedPoolAllocator(const SharedPoolAllocator &) = delete;
+  SharedPoolAllocator &operator=(const SharedPoolAllocator &) = delete;
+
+  /**
+   * @brief Pop a chunk from the shared free list
+   * @param size Must not exceed chunk_size()
+   * @param alignment Must not exceed the construction alignment
+   * @return Pointer to a chunk, or nullptr if the pool is exhausted
+   */
+  void *allocate(size_t size = 0, size_t alignment = 0) override;
+
+  /**
+   * @brief Push a chunk back; may be called by any attached process
+   */
+  void deallocate(void *ptr, size_t size = 0) override;
+
+  /**
+   * @brief Resize in place (succeeds while new_size fits the chunk)
+   */
+  bool try_expand(void *ptr, size_t new_size) override;
+
+  /**
+   * @brief Mark every chunk free
+   *
+   * Not synchronized with allocate()/deallocate(): only call while no
+   * attached process uses the pool.
+   */
+  void reset() override;
+
+  // IAllocator interface
+  bool owns(void *ptr) const override;
+  size_t total_size() const override;
+  size_t used_size() const override;
+
+  /**
+   * @brief Offset of a chunk (or any byte in it) from the region base
+   */
+  offset_type offset_of(const void *ptr) const noexcept;
+
+  /**
+   * @brief Address of an offset in this process's mapping
+   * @return Pointer, or nullptr for null_offset and out-of-range offsets
+   */
+  void *from_offset(offset_type offset) const noexcept;
+
+  size_t chunk_size() const noexcept;
+  size_t chunk_count() const noexcept;
+
+  /**
+   * @brief Free chunks across all processes (a snapshot under contention)
+   *
+   * The count is adjusted after each push and pop, so while a chunk is
+   * being freed and taken again it may briefly read one off; the result
+   * is clamped to [0, chunk_count()].
+   */
+  size_t free_count() const noexcept;
+
+  /// Descriptor of the shared region, for passing to other processes
+  int fd() const noexcept { return m_fd; }
+
+  /// Bytes mapped, including the header and link array
+  size_t region_size() const noexcept { return m_region_size; }
+
+private:
+  struct Header;
+
+  SharedPoolAllocator(int fd, void *region, size_t region_size);
+
+  // Map fd and validate its header
+  static std::unique_ptr<SharedPoolAllocator> map_existing(int fd);
+
+  Header *m_header;    // Start of the shared region
+  size_t m_region_size;
+  char *m_chunks;      // First chunk in this process's mapping
+  int m_fd;            // Owned descriptor of the shared region
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_SHARED_POOL_ALLOCATOR_HPP
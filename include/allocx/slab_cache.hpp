@@ -0,0 +1,277 @@
+#ifndef ALLOCX_SLAB_CACHE_HPP
+#define ALLOCX_SLAB_CACHE_HPP
+
+#include "os_memory.hpp"
+#include "pool_allocator.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Object cache that keeps freed objects in constructed state
+ *
+ * A slab allocator in the style of Bonwick's kmem_cache: memory is carved
+ * from PoolAllocator slabs of `objects_per_slab` objects, and every object
+ * is constructed once, when its slab is created. release() puts the object
+ * back on the cache without destroying it and acquire() hands it out again
+ * without constructing it, so expensive constructors (mutexes, sub-buffers)
+ * run only when the cache grows.
+ *
+ * Slabs are rounded up to whole pages and the slack is used for cache
+ * coloring: each new slab starts its objects one cache line further in
+ * than the previous one (wrapping when the slack runs out), so the same
+ * hot field of objects in different slabs falls into different cache
+ * sets instead of competing for one.
+ *
+ * Callers must return objects in a state fit for reuse. The constructor
+ * and destructor callbacks default to T's default constructor and
+ * destructor; destructors run only in reap() and in ~SlabCache(), which
+ * destroys every object, acquired or not.
+ *
+ * Usage:
+ *   SlabCache<Order> orders(256);
+ *   Order* o = orders.acquire();   // Already constructed
+ *   o->fill(...);
+ *   o->clear();
+ *   orders.release(o);            // Not destroyed
+ */
+template <typename T> class SlabCache {
+public:
+  using Constructor = std::function<void(void *)>; // Construct a T in place
+  using Destructor = std::function<void(T *)>;
+
+  /**
+   * @brief Construct an empty cache (slabs are created on demand)
+   * @param objects_per_slab Objects constructed per slab
+   * @param max_slabs Slab limit, 0 for unlimited
+   * @param constructor Builds a T at the given address
+   * @param destructor Tears down a T
+   */
+  explicit SlabCache(size_t objects_per_slab, size_t max_slabs = 0,
+                     Constructor constructor = nullptr,
+                     Destructor destructor = nullptr)
+      : m_objects_per_slab(std::max<size_t>(objects_per_slab, 1)),
+        m_max_slabs(max_slabs), m_constructor(std::move(constructor)),
+        m_destructor(std::move(destructor)), m_chunk_size(0), m_slab_bytes(0),
+        m_color_count(1), m_next_color(0), m_slabs(), m_free() {
+    if (!m_constructor)
+      m_constructor = [](void *memory) { new (memory) T(); };
+    if (!m_destructor)
+      m_destructor = [](T *object) { object->~T(); };
+
+    // Same rounding as PoolAllocator
+    m_chunk_size = utils::align_up(std::max(sizeof(T), sizeof(void *)),
+                                   object_alignment());
+    size_t used = m_chunk_size * m_objects_per_slab;
+    m_slab_bytes = utils::align_up(used, os::page_size());
+    m_color_count = (m_slab_bytes - used) / color_step() + 1;
+  }
+
+  ~SlabCache() {
+    while (!m_slabs.empty()) {
+      destroy_slab(m_slabs.size() - 1);
+    }
+  }
+
+  // Prevent copying
+  SlabCache(const SlabCache &) = delete;
+  SlabCache &operator=(const SlabCache &) = delete;
+
+  /**
+   * @brief Take a constructed object from the cache
+   * @return Object, or nullptr if the slab limit is reached
+   */
+  T *acquire() {
+    if (m_free.empty() && !grow())
+      return nullptr;
+    T *object = m_free.back();
+    m_free.pop_back();
+    return object;
+  }
+
+  /**
+   * @brief Return an object to the cache without destroying it
+   * @param object Object from acquire()
+   */
+  void release(T *object) {
+#ifdef DEBUG
+    assert(owns(object) && "Object does not belong to this cache");
+#endif
+    m_free.push_back(object);
+  }
+
+  /**
+   * @brief Construct a new slab up front
+   *
+   * If the constructor callback throws, the objects built so far are
+   * destroyed, the slab is freed and the exception propagates; the cache
+   * is left as it was.
+   *
+   * @return false if the slab limit is reached
+   */
+  bool grow() {
+    if (m_max_slabs != 0 && m_slabs.size() >= m_max_slabs)
+      return false;
+
+    size_t color = m_next_color * color_step();
+    std::align_val_t alignment{color_step()};
+    SlabMemory memory(::operator new(m_slab_bytes, alignment),
+                      AlignedDelete{alignment});
+    char *first_object = static_cast<char *>(memory.get()) + color;
+    Slab slab{std::move(memory),
+              PoolAllocator(first_object, m_chunk_size * m_objects_per_slab,
+                            sizeof(T), object_alignment()),
+              reinterpret_cast<T *>(first_object), color};
+
+    // Make room first, so nothing can fail once the objects exist
+    m_slabs.reserve(m_slabs.size() + 1);
+    m_free.reserve(m_free.size() + m_objects_per_slab);
+
+    // Chunks come out in address order. If a constructor throws, tear
+    // down the objects already built; the slab memory goes with `slab`.
+    size_t built = 0;
+    try {
+      for (; built < m_objects_per_slab; ++built) {
+        m_constructor(slab.pool.allocate());
+      }
+    } catch (...) {
+      while (built-- > 0) {
+        m_destructor(reinterpret_cast<T *>(first_object + built * m_chunk_size));
+      }
+      throw;
+    }
+
+    // Push them in reverse so acquire() also walks the slab in address
+    // order
+    for (size_t i = m_objects_per_slab; i-- > 0;) {
+      m_free.push_back(reinterpret_cast<T *>(first_object + i * m_chunk_size));
+    }
+    m_slabs.push_back(std::move(slab));
+    m_next_color = (m_next_color + 1) % m_color_count;
+    return true;
+  }
+
+  /**
+   * @brief Destroy and free slabs whose objects are all in the cache
+   * @return Number of slabs freed
+   */
+  size_t reap() {
+    std::vector<size_t> free_per_slab(m_slabs.size(), 0);
+    for (T *object : m_free) {
+      ++free_per_slab[slab_of(object)];
+    }
+
+    size_t freed = 0;
+    for (size_t i = m_slabs.size(); i-- > 0;) {
+      if (free_per_slab[i] != m_objects_per_slab)
+        continue;
+      PoolAllocator &pool = m_slabs[i].pool;
+      m_free.erase(std::remove_if(m_free.begin(), m_free.end(),
+                                  [&](T *object) { return pool.owns(object); }),
+                   m_free.end());
+      destroy_slab(i);
+      ++freed;
+    }
+    return freed;
+  }
+
+  /**
+   * @brief Check whether an object belongs to this cache
+   */
+  bool owns(const T *object) const noexcept {
+    void *ptr = const_cast<T *>(object);
+    return std::any_of(m_slabs.begin(), m_slabs.end(),
+                       [&](const Slab &slab) { return slab.pool.owns(ptr); });
+  }
+
+  size_t objects_per_slab() const noexcept { return m_objects_per_slab; }
+
+  /**
+   * @brief Number of distinct slab start offsets (1 = no coloring)
+   */
+  size_t color_count() const noexcept { return m_color_count; }
+
+  /**
+   * @brief Byte offset of a slab's first object from the slab start
+   * @param slab Slab index in creation order (as of now)
+   */
+  size_t slab_color(size_t slab) const noexcept { return m_slabs[slab].color; }
+
+  size_t slab_count() const noexcept { return m_slabs.size(); }
+  size_t capacity() const noexcept { return m_slabs.size() * m_objects_per_slab; }
+
+  /**
+   * @brief Constructed objects waiting in the cache
+   */
+  size_t free_count() const noexcept { return m_free.size(); }
+
+  /**
+   * @brief Objects currently acquired
+   */
+  size_t size() const noexcept { return capacity() - m_free.size(); }
+
+private:
+  struct AlignedDelete {
+    std::align_val_t alignment;
+    void operator()(void *memory) const { ::operator delete(memory, alignment); }
+  };
+  using SlabMemory = std::unique_ptr<void, AlignedDelete>;
+
+  struct Slab {
+    SlabMemory memory;  // Whole pages; outlives pool
+    PoolAllocator pool; // Backing chunks, starting `color` bytes in
+    T *first;           // Lowest-addressed object
+    size_t color;       // Offset of the first object
+  };
+
+  static constexpr size_t object_alignment() noexcept {
+    return std::max(alignof(T), alignof(void *));
+  }
+
+  // Colors move slabs by whole cache lines, keeping objects aligned
+  static constexpr size_t color_step() noexcept {
+    return std::max(object_alignment(), utils::CACHE_LINE_SIZE);
+  }
+
+  size_t slab_of(const T *object) const noexcept {
+    for (size_t i = 0; i < m_slabs.size(); ++i) {
+      if (m_slabs[i].pool.owns(const_cast<T *>(object)))
+        return i;
+    }
+    assert(false && "Object does not belong to this cache");
+    return 0;
+  }
+
+  // Run the destructor on every object of slab `index` and free it
+  void destroy_slab(size_t index) {
+    Slab &slab = m_slabs[index];
+    char *base = reinterpret_cast<char *>(slab.first);
+    for (size_t i = 0; i < m_objects_per_slab; ++i) {
+      m_destructor(reinterpret_cast<T *>(base + i * slab.pool.chunk_size()));
+    }
+    m_slabs.erase(m_slabs.begin() + static_cast<std::ptrdiff_t>(index));
+  }
+
+  size_t m_objects_per_slab;        // Objects per slab
+  size_t m_max_slabs;               // 0 = unlimited
+  Constructor m_constructor;        // Runs once per object, at slab creation
+  Destructor m_destructor;          // Runs when a slab is freed
+  size_t m_chunk_size;              // Bytes per object in a slab
+  size_t m_slab_bytes;              // Slab size, whole pages
+  size_t m_color_count;             // Distinct first-object offsets
+  size_t m_next_color;              // Color of the next slab
+  std::vector<Slab> m_slabs;        // Slabs in creation order
+  std::vector<T *> m_free;          // Constructed objects ready for acquire()
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_SLAB_CACHE_HPP
@@ -8,6 +8,16 @@
 
 namespace allocx {
 
+/**
+ * @brief Optional StackAllocator features
+ */
+struct StackOptions {
+    /// Fault in every page of the block at construction
+    bool prefault = false;
+    /// mlock the block so it is never paged out (best effort)
+    bool lock_memory = false;
+};
+
 /**
  * @brief Stack (Linear) Allocator for LIFO allocation patterns
  * 
@@ -37,8 +47,9 @@ public:
     /**
      * @brief Construct a stack allocator with given size
      * @param size Total size of memory block to manage
+     * @param options Optional features (see StackOptions)
      */
-    explicit StackAllocator(size_t size);
+    explicit StackAllocator(size_t size, const StackOptions& options = StackOptions());
 
     /**
      * @brief Construct using external memory buffer
@@ -68,6 +79,19 @@ public:
      */
     void deallocate(void* ptr, size_t size = 0) override;
 
+    /**
+     * @brief Grow or shrink the most recent allocation in place
+     * 
+     * Only the allocation at the top of the stack can be resized; it
+     * stops being the top once anything else is allocated or the stack
+     * is rolled back.
+     * 
+     * @param ptr Pointer returned by allocate()
+     * @param new_size Requested size in bytes
+     * @return true if ptr is the top allocation and new_size fits
+     */
+    bool try_expand(void* ptr, size_t new_size) override;
+
     /**
      * @brief Reset allocator to initial state (bulk deallocation)
      */
@@ -90,6 +114,29 @@ public:
     size_t total_size() const override;
     size_t used_size() const override;
 
+    /**
+     * @brief Fault in every page of the block without changing it
+     *
+     * Takes the first-touch page faults off the allocation path. May run
+     * on a background thread while the allocator is in use.
+     */
+    void prefault() const noexcept;
+
+    /**
+     * @brief Check whether the block is locked in RAM
+     * @return True if StackOptions::lock_memory was requested and granted
+     */
+    bool locked() const noexcept;
+
+    /**
+     * @brief Return the pages above the current top to the OS
+     *
+     * Releases whole pages between the top of the stack and the highest
+     * offset used since the last trim, highest first. Does nothing for a
+     * locked block.
+     */
+    size_t trim(size_t max_bytes = SIZE_MAX, bool lazy = false) override;
+
     /**
      * @brief Get remaining free space
      * @return Bytes available for allocation
@@ -97,10 +144,15 @@ public:
     size_t free_size() const noexcept;
 
 private:
+    static constexpr size_t NO_ALLOCATION = ~size_t(0);
+
     void* m_memory;       // Base pointer to memory block
     size_t m_size;        // Total size of block
     size_t m_offset;      // Current allocation offset
+    size_t m_last_offset; // Offset of the top allocation (NO_ALLOCATION if none)
+    size_t m_high_water;  // Highest offset in use since the last trim
     bool m_owns_memory;   // Whether we should free m_memory
+    bool m_locked;        // Whether m_memory is mlock'ed
 };
 
 } // namespace allocx
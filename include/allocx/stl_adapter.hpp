@@ -3,6 +3,8 @@
 
 #include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 namespace allocx {
 
@@ -26,6 +28,16 @@ public:
   using propagate_on_container_move_assignment = std::true_type;
   using is_always_equal = std::false_type;
 
+  /**
+   * @brief Pointer and element count from allocate_at_least()
+   *
+   * Mirrors C++23 std::allocation_result.
+   */
+  struct allocation_result {
+    T *ptr;
+    size_type count;
+  };
+
   /**
    * @brief Construct with reference to underlying allocator
    */
@@ -72,6 +84,46 @@ public:
     }
   }
 
+  /**
+   * @brief Allocate room for at least n objects
+   *
+   * AllocX allocators do not report slack, so count is n; use
+   * try_expand() to grow the block in place later.
+   */
+  allocation_result allocate_at_least(size_type n) {
+    return {allocate(n), n};
+  }
+
+  /**
+   * @brief Resize a block to hold n objects without moving it
+   * @return true if the block now holds at least n objects
+   */
+  bool try_expand(T *ptr, size_type n) {
+    return ptr && m_allocator->try_expand(ptr, n * sizeof(T));
+  }
+
+  /**
+   * @brief Resize a block, moving it (bytewise) only if necessary
+   *
+   * Restricted to trivially copyable T because a moved block is copied
+   * with memcpy.
+   *
+   * @param ptr Block from allocate() (nullptr to allocate)
+   * @param old_n Current number of objects
+   * @param new_n Requested number of objects
+   * @return Pointer to the resized block
+   */
+  T *reallocate(T *ptr, size_type old_n, size_type new_n) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "reallocate() requires a trivially copyable type");
+    void *result = m_allocator->reallocate(ptr, old_n * sizeof(T),
+                                           new_n * sizeof(T), alignof(T));
+    if (!result) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(result);
+  }
+
   /**
    * @brief Get pointer to underlying allocator
    */
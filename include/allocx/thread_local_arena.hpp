@@ -0,0 +1,114 @@
+#ifndef ALLOCX_THREAD_LOCAL_ARENA_HPP
+#define ALLOCX_THREAD_LOCAL_ARENA_HPP
+
+#include "allocator_base.hpp"
+#include "stack_allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace allocx {
+
+/**
+ * @brief Configuration for ThreadLocalArena
+ */
+struct ThreadLocalArenaConfig {
+  size_t arena_size = 1024 * 1024; // Bytes per thread arena
+  IAllocator *backing = nullptr;   // Arena memory source (nullptr: new)
+};
+
+/**
+ * @brief Registry of lazily created per-thread stack allocators
+ *
+ * The first call to local() on a thread creates (or recycles) a
+ * StackAllocator for that thread; later calls return it through a
+ * thread-local cache without locking. When a thread exits its arena goes
+ * back to the registry and is handed to the next new thread, so thread
+ * pools with churn do not grow the footprint.
+ *
+ * reset_all() resets every arena at a frame boundary and must only be
+ * called while no thread is allocating from its arena.
+ *
+ * The backing allocator, if any, is only used under the registry lock
+ * and must outlive the ThreadLocalArena.
+ *
+ * Usage:
+ *   ThreadLocalArena frames({256 * 1024, nullptr});
+ *   // worker threads:
+ *   void* scratch = frames.local().allocate(128);
+ *   // frame boundary (workers parked):
+ *   frames.reset_all();
+ */
+class ThreadLocalArena {
+public:
+  /**
+   * @brief Construct a registry (no arenas are created up front)
+   * @param config Per-thread arena size and backing allocator
+   */
+  explicit ThreadLocalArena(
+      const ThreadLocalArenaConfig &config = ThreadLocalArenaConfig());
+
+  ~ThreadLocalArena();
+
+  // Prevent copying
+  ThreadLocalArena(const ThreadLocalArena &) = delete;
+  ThreadLocalArena &operator=(const ThreadLocalArena &) = delete;
+
+  /**
+   * @brief Arena of the calling thread, created on first use
+   * @throws std::bad_alloc if the backing allocator is exhausted
+   */
+  StackAllocator &local();
+
+  /**
+   * @brief Reset every thread's arena (call only at a quiescent point)
+   */
+  void reset_all();
+
+  /**
+   * @brief Number of arenas created so far (live and recycled)
+   */
+  size_t arena_count() const;
+
+  /**
+   * @brief Number of arenas currently bound to a running thread
+   */
+  size_t active_count() const;
+
+  /**
+   * @brief Bytes in use across all arenas (quiescent point only)
+   */
+  size_t used_size() const;
+
+  const ThreadLocalArenaConfig &config() const noexcept { return m_config; }
+
+  /**
+   * @brief Process-wide registry used by tls_frame()
+   */
+  static ThreadLocalArena &global();
+
+  /**
+   * @brief Set the configuration of global() before its first use
+   * @return false if global() has already been created
+   */
+  static bool configure_global(const ThreadLocalArenaConfig &config);
+
+  // Shared with exiting threads; defined in the source file
+  struct Registry;
+
+private:
+  StackAllocator &attach();
+
+  ThreadLocalArenaConfig m_config;
+  uint64_t m_id;                        // Unique id for thread-local caches
+  std::shared_ptr<Registry> m_registry; // Arenas and free list
+};
+
+/**
+ * @brief Per-thread frame allocator from ThreadLocalArena::global()
+ */
+StackAllocator &tls_frame();
+
+} // namespace allocx
+
+#endif // ALLOCX_THREAD_LOCAL_ARENA_HPP
@@ -2,6 +2,7 @@
 #define ALLOCX_THREAD_SAFE_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 namespace allocx {
@@ -45,6 +46,23 @@ public:
     m_allocator->deallocate(ptr, size);
   }
 
+  /**
+   * @brief Thread-safe in-place resize
+   */
+  bool try_expand(void *ptr, size_t new_size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocator->try_expand(ptr, new_size);
+  }
+
+  /**
+   * @brief Thread-safe reallocation
+   */
+  void *reallocate(void *ptr, size_t old_size, size_t new_size,
+                   size_t alignment = alignof(std::max_align_t)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocator->reallocate(ptr, old_size, new_size, alignment);
+  }
+
   /**
    * @brief Thread-safe reset
    */
@@ -53,6 +71,14 @@ public:
     m_allocator->reset();
   }
 
+  /**
+   * @brief Thread-safe trim (see IAllocator::trim)
+   */
+  size_t trim(size_t max_bytes = SIZE_MAX, bool lazy = false) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocator->trim(max_bytes, lazy);
+  }
+
   /**
    * @brief Check ownership (thread-safe)
    */
@@ -84,6 +110,13 @@ public:
    */
   Allocator &get_underlying() noexcept { return *m_allocator; }
 
+  /**
+   * @brief Mutex serializing the underlying allocator
+   *
+   * Lets other components (e.g. TrimService) share the same lock.
+   */
+  std::mutex &mutex() const noexcept { return m_mutex; }
+
   // Prevent copying
   ThreadSafeAllocator(const ThreadSafeAllocator &) = delete;
   ThreadSafeAllocator &operator=(const ThreadSafeAllocator &) = delete;
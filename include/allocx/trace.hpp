@@ -0,0 +1,119 @@
+#ifndef ALLOCX_TRACE_HPP
+#define ALLOCX_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief Operation kind stored in a trace record
+ */
+enum class TraceOp : uint8_t { Allocate = 0, Deallocate = 1, Reset = 2 };
+
+/**
+ * @brief One binary trace record (24 bytes, native endianness)
+ *
+ * ptr_id is the address returned by the traced allocator. Addresses are
+ * unique among live blocks, which is all a replay needs to pair frees with
+ * allocations. A failed allocation is recorded with ptr_id 0.
+ */
+struct TraceRecord {
+  uint64_t tsc;       // read_tsc() at the time of the call
+  uint64_t ptr_id;    // Block identity (address in the traced process)
+  uint32_t size;      // Requested bytes (saturated at UINT32_MAX)
+  uint16_t thread;    // Small per-writer thread index
+  TraceOp op;         // Operation kind
+  uint8_t align_log2; // log2 of requested alignment
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord must stay compact");
+
+/**
+ * @brief Streams trace records from many threads into one file
+ *
+ * Each thread appends into its own buffer without locking; a buffer is
+ * written to the file (under a mutex) only when it fills up. flush() and
+ * the destructor write out all partially filled buffers and must only be
+ * called while no thread is recording.
+ *
+ * File layout: "ALXTRACE" magic, uint32 version, uint32 record size,
+ * followed by TraceRecords. Records of different threads are interleaved
+ * in buffer-sized runs; sort by tsc to recover global order.
+ */
+class TraceWriter {
+public:
+  static constexpr size_t RECORDS_PER_BUFFER = 4096;
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  /**
+   * @brief Open (truncate) a trace file
+   * @param path Output file path
+   */
+  explicit TraceWriter(const char *path);
+
+  ~TraceWriter();
+
+  /**
+   * @brief Check whether the output file was opened successfully
+   */
+  bool is_open() const noexcept { return m_file != nullptr; }
+
+  /**
+   * @brief Append a record for the calling thread
+   * @param op Operation kind
+   * @param ptr Block address (nullptr for failed allocations and resets)
+   * @param size Requested size
+   * @param alignment Requested alignment
+   */
+  void record(TraceOp op, const void *ptr, size_t size,
+              size_t alignment) noexcept;
+
+  /**
+   * @brief Write all buffered records to the file (quiescent point only)
+   */
+  void flush();
+
+  /**
+   * @brief Number of records written to the file so far
+   */
+  uint64_t records_written() const noexcept { return m_records_written; }
+
+  // Prevent copying
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+private:
+  struct ThreadBuffer {
+    TraceRecord records[RECORDS_PER_BUFFER];
+    size_t count = 0;
+    uint16_t thread = 0;
+    std::thread::id owner;
+  };
+
+  ThreadBuffer *thread_buffer();
+  void write_buffer(ThreadBuffer &buffer); // Caller holds m_mutex
+
+  std::FILE *m_file;
+  uint64_t m_id;               // Process-unique writer identity
+  uint64_t m_records_written;
+  std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+  std::mutex m_mutex;
+};
+
+/**
+ * @brief Load all records from a trace file
+ * @param path Trace file written by TraceWriter
+ * @param out Receives the records in file order
+ * @return false if the file is missing or not a valid trace
+ */
+bool read_trace(const char *path, std::vector<TraceRecord> &out);
+
+} // namespace allocx
+
+#endif // ALLOCX_TRACE_HPP
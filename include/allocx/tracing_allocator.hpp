@@ -0,0 +1,72 @@
+#ifndef ALLOCX_TRACING_ALLOCATOR_HPP
+#define ALLOCX_TRACING_ALLOCATOR_HPP
+
+#include "trace.hpp"
+#include <cstddef>
+
+namespace allocx {
+
+/**
+ * @brief Records every call on an allocator into a binary trace
+ *
+ * Forwards to the wrapped allocator and appends one TraceRecord per
+ * allocate()/deallocate()/reset() to a TraceWriter. Recording only touches
+ * a per-thread buffer, so the wrapper adds no locking of its own; it is as
+ * thread-safe as the wrapped allocator.
+ *
+ * Replay the resulting file with the allocx_replay tool.
+ *
+ * Usage:
+ *   TraceWriter trace("app.trace");
+ *   FreeListAllocator heap(1 << 20);
+ *   TracingAllocator<FreeListAllocator> traced(heap, trace);
+ *   void* ptr = traced.allocate(128);
+ */
+template <typename Allocator> class TracingAllocator {
+public:
+  /**
+   * @brief Construct with references to allocator and trace sink
+   */
+  TracingAllocator(Allocator &allocator, TraceWriter &writer) noexcept
+      : m_allocator(&allocator), m_writer(&writer) {}
+
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    void *ptr = m_allocator->allocate(size, alignment);
+    m_writer->record(TraceOp::Allocate, ptr, size, alignment);
+    return ptr;
+  }
+
+  void deallocate(void *ptr, size_t size = 0) {
+    if (ptr) {
+      // Record before the block can be handed out again by another thread
+      m_writer->record(TraceOp::Deallocate, ptr, size, 1);
+    }
+    m_allocator->deallocate(ptr, size);
+  }
+
+  void reset() {
+    m_writer->record(TraceOp::Reset, nullptr, 0, 1);
+    m_allocator->reset();
+  }
+
+  bool owns(void *ptr) const { return m_allocator->owns(ptr); }
+  size_t total_size() const { return m_allocator->total_size(); }
+  size_t used_size() const { return m_allocator->used_size(); }
+
+  /**
+   * @brief Get reference to underlying allocator
+   */
+  Allocator &get_underlying() noexcept { return *m_allocator; }
+
+  // Prevent copying
+  TracingAllocator(const TracingAllocator &) = delete;
+  TracingAllocator &operator=(const TracingAllocator &) = delete;
+
+private:
+  Allocator *m_allocator;
+  TraceWriter *m_writer;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_TRACING_ALLOCATOR_HPP
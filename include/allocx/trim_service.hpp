@@ -0,0 +1,141 @@
+#ifndef ALLOCX_TRIM_SERVICE_HPP
+#define ALLOCX_TRIM_SERVICE_HPP
+
+#include "allocator_base.hpp"
+#include "thread_safe.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace allocx {
+
+/**
+ * @brief TrimService settings
+ */
+struct TrimOptions {
+  /// Pause between passes
+  std::chrono::milliseconds interval{100};
+  /// Bytes released per pass, across all allocators
+  size_t max_bytes_per_pass = size_t(4) << 20;
+  /// Release with MADV_FREE (reclaimed under memory pressure) instead of
+  /// MADV_DONTNEED (dropped immediately)
+  bool lazy = false;
+};
+
+/**
+ * @brief Background thread that returns idle allocator pages to the OS
+ *
+ * Calls IAllocator::trim() on every registered allocator once per
+ * interval, within a per-pass byte budget, so a process that shrank after
+ * a burst gives back the memory it is no longer using. Allocators are
+ * trimmed under the same mutex their owners use, taken with try_lock: a
+ * busy allocator is skipped until the next pass instead of making either
+ * side wait, and the budget bounds how long each lock is held: a pool
+ * examines a number of pages proportional to it and resumes where the
+ * previous pass stopped.
+ *
+ * Allocators that cannot tell which pages are free release nothing.
+ *
+ * Usage:
+ *   PoolAllocator pool(64, 100000);
+ *   ThreadSafeAllocator<PoolAllocator> safe_pool(pool);
+ *   TrimService trimmer;
+ *   trimmer.add(safe_pool);
+ *   trimmer.start();
+ */
+class TrimService {
+public:
+  explicit TrimService(const TrimOptions &options = TrimOptions());
+
+  /**
+   * @brief Stop the background thread
+   */
+  ~TrimService();
+
+  // Prevent copying
+  TrimService(const TrimService &) = delete;
+  TrimService &operator=(const TrimService &) = delete;
+
+  /**
+   * @brief Register an allocator
+   * @param allocator Allocator to trim; must outlive its registration
+   * @param lock Mutex every user of the allocator holds while using it
+   */
+  void add(IAllocator &allocator, std::mutex &lock);
+
+  /**
+   * @brief Register the allocator behind a ThreadSafeAllocator
+   */
+  template <typename Allocator> void add(ThreadSafeAllocator<Allocator> &safe) {
+    add(safe.get_underlying(), safe.mutex());
+  }
+
+  /**
+   * @brief Unregister an allocator
+   *
+   * Waits for a pass in progress, so the allocator may be destroyed as
+   * soon as this returns.
+   */
+  void remove(IAllocator &allocator);
+
+  /**
+   * @brief Start the background thread
+   * @return false if it is already running
+   */
+  bool start();
+
+  /**
+   * @brief Stop and join the background thread (no-op if not running)
+   */
+  void stop();
+
+  bool running() const noexcept { return m_thread.joinable(); }
+
+  /**
+   * @brief Run one pass on the calling thread
+   * @return Bytes released by this pass
+   */
+  size_t run_once();
+
+  /// Total bytes released so far
+  size_t released_bytes() const noexcept {
+    return m_released.load(std::memory_order_relaxed);
+  }
+
+  /// Times an allocator was skipped because its lock was busy
+  size_t busy_skips() const noexcept {
+    return m_busy_skips.load(std::memory_order_relaxed);
+  }
+
+  /// Passes completed
+  size_t passes() const noexcept {
+    return m_passes.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Entry {
+    IAllocator *allocator;
+    std::mutex *lock;
+  };
+
+  void run();
+
+  TrimOptions m_options;
+  std::mutex m_mutex; // Guards m_entries, m_next and m_stopping
+  std::condition_variable m_wake;
+  std::vector<Entry> m_entries;
+  size_t m_next;   // Entry the next pass starts from
+  bool m_stopping; // Set by stop() to end the thread
+  std::thread m_thread;
+  std::atomic<size_t> m_released;
+  std::atomic<size_t> m_busy_skips;
+  std::atomic<size_t> m_passes;
+};
+
+} // namespace allocx
+
+#endif // ALLOCX_TRIM_SERVICE_HPP
@@ -4,10 +4,21 @@
 #include <cstddef>
 #include <cstdint>
 #include <cassert>
+#include <chrono>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 namespace allocx {
 namespace utils {
 
+/// Cache-line size assumed when padding data to avoid false sharing
+constexpr size_t CACHE_LINE_SIZE = 64;
+
 /**
  * @brief Align a value up to the nearest multiple of alignment
  * @param value The value to align
@@ -130,6 +141,45 @@ inline ptrdiff_t ptr_diff(const void* end, const void* start) noexcept {
     return static_cast<const char*>(end) - static_cast<const char*>(start);
 }
 
+/**
+ * @brief Read the CPU timestamp counter
+ *
+ * Not serialized, so neighbouring instructions may be reordered around it.
+ * Cheap enough (~20 cycles) for sampling individual allocator calls.
+ * Falls back to steady_clock nanoseconds on non-x86 targets.
+ *
+ * @return Current tick count
+ */
+inline uint64_t read_tsc() noexcept {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Get the number of read_tsc() ticks per nanosecond
+ *
+ * Calibrated once against steady_clock on first call (blocks ~10ms).
+ *
+ * @return Ticks per nanosecond
+ */
+inline double tsc_ticks_per_ns() noexcept {
+    static const double ticks_per_ns = [] {
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tsc_start = read_tsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t tsc_end = read_tsc();
+        auto wall_end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(wall_end - wall_start).count();
+        return ns > 0 ? static_cast<double>(tsc_end - tsc_start) / ns : 1.0;
+    }();
+    return ticks_per_ns;
+}
+
 } // namespace utils
 } // namespace allocx
 
@@ -0,0 +1,768 @@
+// Process-wide malloc/operator new replacement built on AllocX pools.
+//
+// Built as the allocx_malloc shared library; load it with LD_PRELOAD to
+// route every allocation of an unmodified program through AllocX:
+//
+//   LD_PRELOAD=./liballocx_malloc.so ./app
+//
+// Layout:
+// - Small requests (<= 8KB) are rounded to one of 32 size classes. Each
+//   class carves 64KB spans, each managed by a PoolAllocator placed in the
+//   span header. Spans are 64KB-aligned, so free() finds the header by
+//   masking the pointer.
+// - Each thread keeps a bounded free list per class and moves objects to
+//   and from the spans in batches under a per-class lock.
+// - Large requests get their own 64KB-aligned mapping with the same header
+//   at the base. Recently freed mappings are kept (up to 64 entries and
+//   64MB, oldest evicted first) and reused by requests they fit with at
+//   most 25% slack.
+// - Pointers aligned to 64KB or more can only come from large mappings
+//   made for such alignments; their header sits one span below.
+//
+// Fully empty spans are recycled between classes but never unmapped.
+
+#include "allocx/pool_allocator.hpp"
+#include "allocx/utils.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define ALLOCX_EXPORT __attribute__((visibility("default")))
+
+namespace allocx {
+namespace {
+
+constexpr size_t SPAN_SIZE = 64 * 1024;
+constexpr size_t REGION_SIZE = 4 * 1024 * 1024; // Spans mapped at a time
+constexpr size_t MIN_ALIGNMENT = 16;
+constexpr size_t MAX_SMALL_SIZE = 8192;
+constexpr size_t CLASS_COUNT = 32;
+constexpr size_t LARGE_CACHE_ENTRIES = 64;
+constexpr size_t LARGE_CACHE_MAX_BYTES = 64 * 1024 * 1024;
+constexpr uint32_t SPAN_MAGIC = 0xA110C5A7;
+
+enum class SpanKind : uint32_t { Small, Large };
+
+// Common header at the base of every 64KB-aligned span or large mapping
+struct SpanHeader {
+  uint32_t magic;
+  SpanKind kind;
+  size_t mapping_size; // Large: bytes mapped; Small: SPAN_SIZE
+  SpanHeader *prev;    // Partial-span list or large-mapping cache
+  SpanHeader *next;
+};
+
+struct SmallSpan : SpanHeader {
+  uint32_t size_class;
+  uint32_t reciprocal; // ceil(2^32 / object_size), maps offsets to objects
+  size_t object_size;
+  char *first;        // First object
+  PoolAllocator pool; // Chunks of this span
+};
+
+constexpr size_t SMALL_HEADER_SIZE = utils::align_up(sizeof(SmallSpan), 64);
+constexpr size_t LARGE_HEADER_SIZE = utils::align_up(sizeof(SpanHeader), 64);
+
+// 16..128 in steps of 16, then four classes per power of two up to 8KB
+constexpr size_t class_size(size_t size_class) {
+  return size_class < 8
+             ? (size_class + 1) * 16
+             : (size_t(128) << ((size_class - 8) / 4)) +
+                   ((size_class - 8) % 4 + 1) * (size_t(32) << ((size_class - 8) / 4));
+}
+
+static_assert(class_size(CLASS_COUNT - 1) == MAX_SMALL_SIZE,
+              "Size classes must end at MAX_SMALL_SIZE");
+
+inline size_t size_to_class(size_t size) {
+  if (size <= 128)
+    return size == 0 ? 0 : (size - 1) / 16;
+  size_t k = 63 - static_cast<size_t>(__builtin_clzll(size - 1));
+  return 8 + (k - 7) * 4 + ((size - 1 - (size_t(1) << k)) >> (k - 2));
+}
+
+// Objects cached per thread and moved per batch, by class
+inline uint32_t cache_limit(size_t size_class) {
+  size_t limit = (64 * 1024) / class_size(size_class);
+  return static_cast<uint32_t>(limit < 8 ? 8 : limit > 256 ? 256 : limit);
+}
+
+inline SpanHeader *span_of(const void *ptr) {
+  return reinterpret_cast<SpanHeader *>(reinterpret_cast<uintptr_t>(ptr) &
+                                        ~(SPAN_SIZE - 1));
+}
+
+// Header of the span or mapping a user pointer belongs to
+inline SpanHeader *header_of(const void *ptr) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  if ((address & (SPAN_SIZE - 1)) == 0)
+    address -= SPAN_SIZE; // Span-aligned: header is one span below
+  return span_of(reinterpret_cast<void *>(address));
+}
+
+// Start of the object containing `ptr` (aligned allocations hand out
+// interior pointers)
+inline char *object_of(const SmallSpan *span, const void *ptr) {
+  uint64_t offset = static_cast<uint64_t>(static_cast<const char *>(ptr) - span->first);
+  uint64_t index = (offset * span->reciprocal) >> 32;
+  return span->first + index * span->object_size;
+}
+
+// ============================================================================
+// OS memory
+// ============================================================================
+
+void *map_aligned(size_t size, size_t alignment) {
+  size_t padded = size + alignment;
+  void *raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+    return nullptr;
+
+  uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t aligned = utils::align_up(start, alignment);
+  if (aligned > start)
+    ::munmap(raw, aligned - start);
+  size_t tail = (start + padded) - (aligned + size);
+  if (tail > 0)
+    ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+  return reinterpret_cast<void *>(aligned);
+}
+
+// ============================================================================
+// Span supply
+// ============================================================================
+
+struct SpanSupply {
+  std::mutex lock;
+  char *cursor = nullptr; // Unused part of the current region
+  char *end = nullptr;
+  SpanHeader *free_spans = nullptr; // Empty spans from any class
+};
+
+SpanSupply g_supply;
+
+// Recently freed large mappings (see "Large objects" below)
+struct LargeCache {
+  std::mutex lock;
+  SpanHeader *mappings = nullptr; // Recently freed mappings, newest first
+  SpanHeader *oldest = nullptr;   // Tail of `mappings`, evicted first
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+LargeCache g_large;
+
+void *take_span() {
+  std::lock_guard<std::mutex> guard(g_supply.lock);
+  if (g_supply.free_spans) {
+    SpanHeader *span = g_supply.free_spans;
+    g_supply.free_spans = span->next;
+    return span;
+  }
+  if (g_supply.cursor == g_supply.end) {
+    char *region = static_cast<char *>(map_aligned(REGION_SIZE, SPAN_SIZE));
+    if (!region)
+      return nullptr;
+    g_supply.cursor = region;
+    g_supply.end = region + REGION_SIZE;
+  }
+  void *span = g_supply.cursor;
+  g_supply.cursor += SPAN_SIZE;
+  return span;
+}
+
+void give_span(SpanHeader *span) {
+  std::lock_guard<std::mutex> guard(g_supply.lock);
+  span->next = g_supply.free_spans;
+  g_supply.free_spans = span;
+}
+
+// ============================================================================
+// Size-class central lists
+// ============================================================================
+
+struct FreeObject {
+  FreeObject *next;
+};
+
+struct alignas(64) Central {
+  std::mutex lock;
+  SmallSpan *partial = nullptr; // Spans with free chunks
+};
+
+Central g_central[CLASS_COUNT];
+
+void link_partial(Central &central, SmallSpan *span) {
+  span->prev = nullptr;
+  span->next = central.partial;
+  if (central.partial)
+    central.partial->prev = span;
+  central.partial = span;
+}
+
+void unlink_partial(Central &central, SmallSpan *span) {
+  if (span->prev)
+    span->prev->next = span->next;
+  else
+    central.partial = static_cast<SmallSpan *>(span->next);
+  if (span->next)
+    span->next->prev = span->prev;
+}
+
+SmallSpan *new_span(size_t size_class) {
+  void *memory = take_span();
+  if (!memory)
+    return nullptr;
+
+  size_t object_size = class_size(size_class);
+  char *first = static_cast<char *>(memory) + SMALL_HEADER_SIZE;
+  SmallSpan *span = new (memory) SmallSpan{
+      {SPAN_MAGIC, SpanKind::Small, SPAN_SIZE, nullptr, nullptr},
+      static_cast<uint32_t>(size_class),
+      static_cast<uint32_t>(((uint64_t(1) << 32) + object_size - 1) / object_size),
+      object_size,
+      first,
+      PoolAllocator(first, SPAN_SIZE - SMALL_HEADER_SIZE, object_size,
+                    MIN_ALIGNMENT)};
+  return span;
+}
+
+// Move up to `count` objects of a class onto `list`; returns the number moved
+uint32_t central_fetch(size_t size_class, FreeObject *&list, uint32_t count) {
+  Central &central = g_central[size_class];
+  std::lock_guard<std::mutex> guard(central.lock);
+
+  uint32_t fetched = 0;
+  while (fetched < count) {
+    SmallSpan *span = central.partial;
+    if (!span) {
+      span = new_span(size_class);
+      if (!span)
+        break;
+      link_partial(central, span);
+    }
+    while (fetched < count) {
+      void *object = span->pool.allocate();
+      if (!object)
+        break;
+      FreeObject *node = static_cast<FreeObject *>(object);
+      node->next = list;
+      list = node;
+      ++fetched;
+    }
+    if (span->pool.free_count() == 0)
+      unlink_partial(central, span);
+  }
+  return fetched;
+}
+
+// Return a chain of objects of one class to their spans
+void central_release(size_t size_class, FreeObject *list) {
+  Central &central = g_central[size_class];
+  std::lock_guard<std::mutex> guard(central.lock);
+
+  while (list) {
+    FreeObject *next = list->next;
+    SmallSpan *span = static_cast<SmallSpan *>(span_of(list));
+    bool was_full = span->pool.free_count() == 0;
+    span->pool.deallocate(list);
+
+    if (was_full) {
+      link_partial(central, span);
+    } else if (span->pool.free_count() == span->pool.chunk_count() &&
+               (central.partial != span || span->next)) {
+      // Keep one empty span per class, recycle the rest
+      unlink_partial(central, span);
+      give_span(span);
+    }
+    list = next;
+  }
+}
+
+// ============================================================================
+// Thread caches
+// ============================================================================
+
+enum CacheState : int { CACHE_UNINIT = 0, CACHE_INITIALIZING, CACHE_ACTIVE, CACHE_DEAD };
+
+struct ThreadCache {
+  FreeObject *heads[CLASS_COUNT];
+  uint32_t counts[CLASS_COUNT];
+  int state;
+};
+
+// Zero-initialized POD, so no TLS constructor runs inside malloc
+thread_local ThreadCache t_cache __attribute__((tls_model("initial-exec")));
+
+pthread_once_t g_init_once = PTHREAD_ONCE_INIT;
+pthread_key_t g_exit_key;
+
+void flush_cache(ThreadCache &cache) {
+  for (size_t c = 0; c < CLASS_COUNT; ++c) {
+    if (cache.heads[c]) {
+      central_release(c, cache.heads[c]);
+      cache.heads[c] = nullptr;
+      cache.counts[c] = 0;
+    }
+  }
+}
+
+void on_thread_exit(void *arg) {
+  ThreadCache *cache = static_cast<ThreadCache *>(arg);
+  flush_cache(*cache);
+  cache->state = CACHE_DEAD; // Later frees on this thread go to the spans
+}
+
+// Keep all locks consistent across fork(); taken in a fixed order
+// (size classes, span supply, large cache), released in reverse
+void before_fork() {
+  for (Central &central : g_central)
+    central.lock.lock();
+  g_supply.lock.lock();
+  g_large.lock.lock();
+}
+
+void after_fork() {
+  g_large.lock.unlock();
+  g_supply.lock.unlock();
+  for (size_t c = CLASS_COUNT; c-- > 0;)
+    g_central[c].lock.unlock();
+}
+
+void global_init() {
+  pthread_key_create(&g_exit_key, on_thread_exit);
+  pthread_atfork(before_fork, after_fork, after_fork);
+}
+
+// Calls made while this runs (pthread internals may allocate) bypass the
+// cache because the state is CACHE_INITIALIZING
+void init_cache(ThreadCache &cache) {
+  cache.state = CACHE_INITIALIZING;
+  pthread_once(&g_init_once, global_init);
+  pthread_setspecific(g_exit_key, &cache);
+  cache.state = CACHE_ACTIVE;
+}
+
+void *small_alloc(size_t size_class) {
+  ThreadCache &cache = t_cache;
+  if (cache.state != CACHE_ACTIVE) {
+    if (cache.state == CACHE_UNINIT) {
+      init_cache(cache);
+      return small_alloc(size_class);
+    }
+    FreeObject *one = nullptr;
+    central_fetch(size_class, one, 1);
+    return one;
+  }
+
+  FreeObject *head = cache.heads[size_class];
+  if (!head) {
+    uint32_t fetched =
+        central_fetch(size_class, cache.heads[size_class], cache_limit(size_class) / 2);
+    if (fetched == 0)
+      return nullptr;
+    cache.counts[size_class] = fetched;
+    head = cache.heads[size_class];
+  }
+  cache.heads[size_class] = head->next;
+  --cache.counts[size_class];
+  return head;
+}
+
+void small_free(SmallSpan *span, void *ptr) {
+  size_t size_class = span->size_class;
+  FreeObject *node = reinterpret_cast<FreeObject *>(object_of(span, ptr));
+  ThreadCache &cache = t_cache;
+  if (cache.state != CACHE_ACTIVE) {
+    node->next = nullptr;
+    central_release(size_class, node);
+    return;
+  }
+
+  node->next = cache.heads[size_class];
+  cache.heads[size_class] = node;
+  uint32_t limit = cache_limit(size_class);
+  if (++cache.counts[size_class] <= limit)
+    return;
+
+  // Over the limit: hand half of the list back to the spans
+  FreeObject *tail = node;
+  for (uint32_t i = 1; i < limit / 2; ++i)
+    tail = tail->next;
+  cache.heads[size_class] = tail->next;
+  tail->next = nullptr;
+  cache.counts[size_class] -= limit / 2;
+  central_release(size_class, node);
+}
+
+// ============================================================================
+// Large objects
+// ============================================================================
+
+// Map `mapping_size` bytes at a span-aligned header such that
+// header + offset is aligned to `alignment`
+SpanHeader *map_large(size_t mapping_size, size_t offset, size_t alignment) {
+  if (alignment <= SPAN_SIZE)
+    return static_cast<SpanHeader *>(map_aligned(mapping_size, SPAN_SIZE));
+
+  size_t padded = mapping_size + alignment;
+  void *raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+    return nullptr;
+
+  uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t header = utils::align_up(start + offset, alignment) - offset;
+  if (header > start)
+    ::munmap(raw, header - start);
+  size_t tail = (start + padded) - (header + mapping_size);
+  if (tail > 0)
+    ::munmap(reinterpret_cast<void *>(header + mapping_size), tail);
+  return reinterpret_cast<SpanHeader *>(header);
+}
+
+// Unlink a mapping from the large cache (lock held)
+void unlink_cached(SpanHeader *cached) {
+  if (cached->prev)
+    cached->prev->next = cached->next;
+  else
+    g_large.mappings = cached->next;
+  if (cached->next)
+    cached->next->prev = cached->prev;
+  else
+    g_large.oldest = cached->prev;
+  --g_large.count;
+  g_large.bytes -= cached->mapping_size;
+}
+
+// Take a cached mapping of at least `mapping_size` bytes, and at most 25%
+// more, whose data would be suitably aligned. On success `mapping_size`
+// is updated to the mapping's real size.
+SpanHeader *take_cached(size_t &mapping_size, size_t offset, size_t alignment) {
+  std::lock_guard<std::mutex> guard(g_large.lock);
+  for (SpanHeader *cached = g_large.mappings; cached; cached = cached->next) {
+    if (cached->mapping_size < mapping_size ||
+        cached->mapping_size - mapping_size > mapping_size / 4 ||
+        (reinterpret_cast<uintptr_t>(cached) + offset) % alignment != 0)
+      continue;
+    unlink_cached(cached);
+    mapping_size = cached->mapping_size;
+    return cached;
+  }
+  return nullptr;
+}
+
+// `fresh` reports whether the memory comes straight from mmap (zeroed).
+// Alignments of a span or more put the data one span above the header,
+// which keeps the user pointer span-aligned (see header_of()).
+void *large_alloc(size_t size, size_t alignment, bool *fresh) {
+  size_t offset = alignment >= SPAN_SIZE
+                      ? SPAN_SIZE
+                      : utils::align_up(LARGE_HEADER_SIZE, alignment);
+  if (size > SIZE_MAX - offset - SPAN_SIZE - alignment)
+    return nullptr;
+  size_t mapping_size = utils::align_up(offset + size, SPAN_SIZE);
+
+  SpanHeader *span = take_cached(mapping_size, offset, alignment);
+  if (fresh)
+    *fresh = span == nullptr;
+  if (!span) {
+    span = map_large(mapping_size, offset, alignment);
+    if (!span)
+      return nullptr;
+  }
+  span->magic = SPAN_MAGIC;
+  span->kind = SpanKind::Large;
+  span->mapping_size = mapping_size;
+  return reinterpret_cast<char *>(span) + offset;
+}
+
+void large_free(SpanHeader *span) {
+  if (span->mapping_size > LARGE_CACHE_MAX_BYTES) {
+    ::munmap(span, span->mapping_size);
+    return;
+  }
+
+  // Evict the oldest mappings beyond the limits; they are unmapped
+  // after the lock is dropped, chained through `next`
+  SpanHeader *evicted = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(g_large.lock);
+    span->prev = nullptr;
+    span->next = g_large.mappings;
+    if (g_large.mappings)
+      g_large.mappings->prev = span;
+    else
+      g_large.oldest = span;
+    g_large.mappings = span;
+    ++g_large.count;
+    g_large.bytes += span->mapping_size;
+
+    while (g_large.count > LARGE_CACHE_ENTRIES ||
+           g_large.bytes > LARGE_CACHE_MAX_BYTES) {
+      SpanHeader *oldest = g_large.oldest;
+      unlink_cached(oldest);
+      oldest->next = evicted;
+      evicted = oldest;
+    }
+  }
+  while (evicted) {
+    SpanHeader *next = evicted->next;
+    ::munmap(evicted, evicted->mapping_size);
+    evicted = next;
+  }
+}
+
+// ============================================================================
+// Entry points
+// ============================================================================
+
+void *allocate(size_t size) {
+  if (size <= MAX_SMALL_SIZE)
+    return small_alloc(size_to_class(size));
+  return large_alloc(size, MIN_ALIGNMENT, nullptr);
+}
+
+void *allocate_aligned(size_t alignment, size_t size) {
+  if (alignment <= MIN_ALIGNMENT)
+    return allocate(size);
+  if (size > SIZE_MAX - alignment)
+    return nullptr;
+  if (size + alignment - 1 <= MAX_SMALL_SIZE) {
+    void *block = small_alloc(size_to_class(size + alignment - 1));
+    return block ? utils::align_pointer(block, alignment) : nullptr;
+  }
+  return large_alloc(size, alignment, nullptr);
+}
+
+void release(void *ptr) {
+  if (!ptr)
+    return;
+  SpanHeader *span = header_of(ptr);
+  if (span->kind == SpanKind::Small)
+    small_free(static_cast<SmallSpan *>(span), ptr);
+  else
+    large_free(span);
+}
+
+size_t usable_size(const void *ptr) {
+  SpanHeader *span = header_of(ptr);
+  const char *p = static_cast<const char *>(ptr);
+  if (span->kind == SpanKind::Small) {
+    SmallSpan *small = static_cast<SmallSpan *>(span);
+    return static_cast<size_t>(object_of(small, ptr) + small->object_size - p);
+  }
+  return static_cast<size_t>(reinterpret_cast<char *>(span) + span->mapping_size - p);
+}
+
+void *reallocate(void *ptr, size_t size) {
+  if (!ptr)
+    return allocate(size);
+  if (size == 0) {
+    release(ptr);
+    return nullptr;
+  }
+
+  size_t usable = usable_size(ptr);
+  if (size <= usable)
+    return ptr;
+
+  // Grow a large mapping in place when the following pages are free
+  SpanHeader *span = header_of(ptr);
+  if (span->kind == SpanKind::Large) {
+    size_t offset = static_cast<size_t>(static_cast<char *>(ptr) -
+                                        reinterpret_cast<char *>(span));
+    if (size <= SIZE_MAX - offset - SPAN_SIZE) {
+      size_t mapping_size = utils::align_up(offset + size, SPAN_SIZE);
+      if (::mremap(span, span->mapping_size, mapping_size, 0) != MAP_FAILED) {
+        span->mapping_size = mapping_size;
+        return ptr;
+      }
+    }
+  }
+
+  void *moved = allocate(size);
+  if (!moved)
+    return nullptr;
+  std::memcpy(moved, ptr, usable);
+  release(ptr);
+  return moved;
+}
+
+void *new_impl(size_t size) {
+  for (;;) {
+    if (void *ptr = allocate(size))
+      return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void *new_aligned_impl(size_t size, std::align_val_t alignment) {
+  for (;;) {
+    if (void *ptr = allocate_aligned(static_cast<size_t>(alignment), size))
+      return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+} // namespace
+} // namespace allocx
+
+// ============================================================================
+// C allocation API
+// ============================================================================
+
+extern "C" {
+
+ALLOCX_EXPORT void *malloc(size_t size) {
+  void *ptr = allocx::allocate(size);
+  if (!ptr)
+    errno = ENOMEM;
+  return ptr;
+}
+
+ALLOCX_EXPORT void free(void *ptr) { allocx::release(ptr); }
+
+ALLOCX_EXPORT void *calloc(size_t count, size_t size) {
+  size_t bytes;
+  if (__builtin_mul_overflow(count, size, &bytes)) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+
+  void *ptr;
+  bool fresh = false;
+  if (bytes <= allocx::MAX_SMALL_SIZE) {
+    ptr = allocx::allocate(bytes);
+  } else {
+    ptr = allocx::large_alloc(bytes, allocx::MIN_ALIGNMENT, &fresh);
+  }
+  if (!ptr) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  if (!fresh)
+    std::memset(ptr, 0, bytes);
+  return ptr;
+}
+
+ALLOCX_EXPORT void *realloc(void *ptr, size_t size) {
+  void *result = allocx::reallocate(ptr, size);
+  if (!result && size != 0)
+    errno = ENOMEM;
+  return result;
+}
+
+ALLOCX_EXPORT int posix_memalign(void **memptr, size_t alignment, size_t size) {
+  if (!allocx::utils::is_power_of_two(alignment) || alignment % sizeof(void *) != 0)
+    return EINVAL;
+  void *ptr = allocx::allocate_aligned(alignment, size);
+  if (!ptr)
+    return ENOMEM;
+  *memptr = ptr;
+  return 0;
+}
+
+ALLOCX_EXPORT void *aligned_alloc(size_t alignment, size_t size) {
+  if (!allocx::utils::is_power_of_two(alignment)) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  void *ptr = allocx::allocate_aligned(alignment, size);
+  if (!ptr)
+    errno = ENOMEM;
+  return ptr;
+}
+
+ALLOCX_EXPORT void *memalign(size_t alignment, size_t size) {
+  return aligned_alloc(alignment, size);
+}
+
+ALLOCX_EXPORT void *valloc(size_t size) {
+  return aligned_alloc(static_cast<size_t>(::sysconf(_SC_PAGESIZE)), size);
+}
+
+ALLOCX_EXPORT void *pvalloc(size_t size) {
+  size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  return aligned_alloc(page, allocx::utils::align_up(size ? size : 1, page));
+}
+
+ALLOCX_EXPORT size_t malloc_usable_size(void *ptr) {
+  return ptr ? allocx::usable_size(ptr) : 0;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Global operator new/delete
+// ============================================================================
+
+ALLOCX_EXPORT void *operator new(size_t size) { return allocx::new_impl(size); }
+ALLOCX_EXPORT void *operator new[](size_t size) { return allocx::new_impl(size); }
+
+ALLOCX_EXPORT void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocx::allocate(size);
+}
+ALLOCX_EXPORT void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocx::allocate(size);
+}
+
+ALLOCX_EXPORT void *operator new(size_t size, std::align_val_t alignment) {
+  return allocx::new_aligned_impl(size, alignment);
+}
+ALLOCX_EXPORT void *operator new[](size_t size, std::align_val_t alignment) {
+  return allocx::new_aligned_impl(size, alignment);
+}
+
+ALLOCX_EXPORT void *operator new(size_t size, std::align_val_t alignment,
+                                 const std::nothrow_t &) noexcept {
+  return allocx::allocate_aligned(static_cast<size_t>(alignment), size);
+}
+ALLOCX_EXPORT void *operator new[](size_t size, std::align_val_t alignment,
+                                   const std::nothrow_t &) noexcept {
+  return allocx::allocate_aligned(static_cast<size_t>(alignment), size);
+}
+
+ALLOCX_EXPORT void operator delete(void *ptr) noexcept { allocx::release(ptr); }
+ALLOCX_EXPORT void operator delete[](void *ptr) noexcept { allocx::release(ptr); }
+ALLOCX_EXPORT void operator delete(void *ptr, size_t) noexcept { allocx::release(ptr); }
+ALLOCX_EXPORT void operator delete[](void *ptr, size_t) noexcept { allocx::release(ptr); }
+ALLOCX_EXPORT void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete(void *ptr, std::align_val_t) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete[](void *ptr, std::align_val_t) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete(void *ptr, std::align_val_t,
+                                   const std::nothrow_t &) noexcept {
+  allocx::release(ptr);
+}
+ALLOCX_EXPORT void operator delete[](void *ptr, std::align_val_t,
+                                     const std::nothrow_t &) noexcept {
+  allocx::release(ptr);
+}
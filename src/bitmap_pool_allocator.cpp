@@ -0,0 +1,203 @@
+#include "allocx/bitmap_pool_allocator.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace allocx {
+
+BitmapPoolAllocator::BitmapPoolAllocator(size_t chunk_size, size_t chunk_count,
+                                         size_t alignment)
+    : m_memory(nullptr), m_allocation(nullptr), m_memory_size(0),
+      m_chunk_size(0), m_chunk_count(chunk_count), m_free_count(0),
+      m_hint(0) {
+  m_chunk_size = utils::align_up(std::max<size_t>(chunk_size, 1), alignment);
+  m_memory_size = m_chunk_size * chunk_count;
+
+  if (m_memory_size > 0) {
+    m_allocation = ::operator new(m_memory_size + alignment);
+    m_memory = utils::align_pointer(m_allocation, alignment);
+  } else {
+    m_chunk_count = 0;
+  }
+  init_bitmap();
+}
+
+BitmapPoolAllocator::BitmapPoolAllocator(void *buffer, size_t buffer_size,
+                                         size_t chunk_size, size_t alignment)
+    : m_memory(nullptr), m_allocation(nullptr), m_memory_size(0),
+      m_chunk_size(0), m_chunk_count(0), m_free_count(0), m_hint(0) {
+  assert(buffer != nullptr || buffer_size == 0);
+
+  m_memory = utils::align_pointer(buffer, alignment);
+  size_t offset = static_cast<size_t>(utils::ptr_diff(m_memory, buffer));
+  m_chunk_size = utils::align_up(std::max<size_t>(chunk_size, 1), alignment);
+  m_chunk_count = buffer_size > offset ? (buffer_size - offset) / m_chunk_size : 0;
+  m_memory_size = m_chunk_size * m_chunk_count;
+  init_bitmap();
+}
+
+BitmapPoolAllocator::~BitmapPoolAllocator() {
+  if (m_allocation) {
+    ::operator delete(m_allocation);
+  }
+}
+
+BitmapPoolAllocator::BitmapPoolAllocator(BitmapPoolAllocator &&other) noexcept
+    : m_memory(other.m_memory), m_allocation(other.m_allocation),
+      m_memory_size(other.m_memory_size), m_chunk_size(other.m_chunk_size),
+      m_chunk_count(other.m_chunk_count), m_free_count(other.m_free_count),
+      m_hint(other.m_hint), m_words(std::move(other.m_words)) {
+  other.m_memory = nullptr;
+  other.m_allocation = nullptr;
+  other.m_memory_size = 0;
+  other.m_chunk_count = 0;
+  other.m_free_count = 0;
+  other.m_hint = 0;
+  other.m_words.clear();
+}
+
+BitmapPoolAllocator &
+BitmapPoolAllocator::operator=(BitmapPoolAllocator &&other) noexcept {
+  if (this != &other) {
+    if (m_allocation) {
+      ::operator delete(m_allocation);
+    }
+
+    m_memory = other.m_memory;
+    m_allocation = other.m_allocation;
+    m_memory_size = other.m_memory_size;
+    m_chunk_size = other.m_chunk_size;
+    m_chunk_count = other.m_chunk_count;
+    m_free_count = other.m_free_count;
+    m_hint = other.m_hint;
+    m_words = std::move(other.m_words);
+
+    other.m_memory = nullptr;
+    other.m_allocation = nullptr;
+    other.m_memory_size = 0;
+    other.m_chunk_count = 0;
+    other.m_free_count = 0;
+    other.m_hint = 0;
+    other.m_words.clear();
+  }
+  return *this;
+}
+
+void BitmapPoolAllocator::init_bitmap() {
+  m_words.assign((m_chunk_count + 63) / 64, 0);
+  reset();
+}
+
+void *BitmapPoolAllocator::allocate(size_t /*size*/, size_t /*alignment*/) {
+  if (m_free_count == 0)
+    return nullptr;
+
+  size_t word = find_free_word(m_hint);
+  assert(word < m_words.size() && "Free count out of sync with bitmap");
+
+  uint64_t bits = m_words[word];
+  size_t bit = static_cast<size_t>(__builtin_ctzll(bits));
+  m_words[word] = bits & (bits - 1); // Clear lowest set bit
+  m_hint = word;
+  --m_free_count;
+
+  return utils::ptr_add(m_memory, (word * 64 + bit) * m_chunk_size);
+}
+
+void BitmapPoolAllocator::deallocate(void *ptr, size_t /*size*/) {
+  if (ptr == nullptr)
+    return;
+
+#ifdef DEBUG
+  assert(owns(ptr) && "Pointer does not belong to this allocator");
+  assert(static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) % m_chunk_size ==
+             0 &&
+         "Pointer is not at a chunk boundary");
+#endif
+
+  size_t index =
+      static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) / m_chunk_size;
+  size_t word = index / 64;
+  uint64_t mask = uint64_t(1) << (index % 64);
+
+#ifdef DEBUG
+  assert(!(m_words[word] & mask) && "Double free detected");
+#endif
+
+  m_words[word] |= mask;
+  m_hint = std::min(m_hint, word);
+  ++m_free_count;
+}
+
+bool BitmapPoolAllocator::try_expand(void *ptr, size_t new_size) {
+  return owns(ptr) && new_size <= m_chunk_size;
+}
+
+void *BitmapPoolAllocator::reallocate(void *ptr, size_t /*old_size*/,
+                                      size_t new_size, size_t /*alignment*/) {
+  // Every chunk has the same size, so moving can never help
+  if (new_size > m_chunk_size)
+    return nullptr;
+  return ptr ? ptr : allocate();
+}
+
+void BitmapPoolAllocator::reset() {
+  for (size_t word = 0; word < m_words.size(); ++word) {
+    m_words[word] = valid_mask(word);
+  }
+  m_free_count = m_chunk_count;
+  m_hint = 0;
+}
+
+bool BitmapPoolAllocator::owns(void *ptr) const {
+  const char *p = static_cast<const char *>(ptr);
+  const char *start = static_cast<const char *>(m_memory);
+  return p >= start && p < start + m_memory_size;
+}
+
+size_t BitmapPoolAllocator::total_size() const { return m_memory_size; }
+
+size_t BitmapPoolAllocator::used_size() const {
+  return (m_chunk_count - m_free_count) * m_chunk_size;
+}
+
+size_t BitmapPoolAllocator::chunk_size() const noexcept { return m_chunk_size; }
+
+size_t BitmapPoolAllocator::chunk_count() const noexcept {
+  return m_chunk_count;
+}
+
+size_t BitmapPoolAllocator::free_count() const noexcept { return m_free_count; }
+
+bool BitmapPoolAllocator::is_allocated(size_t index) const noexcept {
+  return index < m_chunk_count && !((m_words[index / 64] >> (index % 64)) & 1);
+}
+
+size_t BitmapPoolAllocator::find_free_word(size_t start) const noexcept {
+  const size_t count = m_words.size();
+  const uint64_t *words = m_words.data();
+  size_t word = start;
+
+#if defined(__AVX2__)
+  // Skip runs of full words four at a time
+  while (word + 4 <= count) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + word));
+    if (!_mm256_testz_si256(block, block))
+      break;
+    word += 4;
+  }
+#endif
+
+  while (word < count && words[word] == 0) {
+    ++word;
+  }
+  return word;
+}
+
+} // namespace allocx
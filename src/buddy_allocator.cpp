@@ -0,0 +1,294 @@
+#include "allocx/buddy_allocator.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace allocx {
+
+namespace {
+
+size_t log2_floor(size_t value) noexcept {
+  size_t log = 0;
+  while (value > 1) {
+    value >>= 1;
+    ++log;
+  }
+  return log;
+}
+
+size_t arena_alignment(size_t size) noexcept {
+  return std::min(size, BuddyAllocator::MAX_ARENA_ALIGNMENT);
+}
+
+} // namespace
+
+BuddyAllocator::BuddyAllocator(size_t size, size_t min_block_size)
+    : m_memory(nullptr), m_size(0), m_used(0), m_min_shift(0),
+      m_max_order(0), m_base_alignment(0), m_nonempty(0), m_free_lists(),
+      m_owns_memory(true) {
+  min_block_size = std::max(utils::next_power_of_two(min_block_size),
+                            utils::next_power_of_two(sizeof(FreeBlock)));
+  if (size > 0) {
+    m_size = std::max(utils::next_power_of_two(size), min_block_size);
+    m_base_alignment = std::max(arena_alignment(m_size),
+                                alignof(std::max_align_t));
+    m_memory = ::operator new(m_size, std::align_val_t(m_base_alignment));
+    init(min_block_size);
+  }
+}
+
+BuddyAllocator::BuddyAllocator(void *buffer, size_t size,
+                               size_t min_block_size)
+    : m_memory(buffer), m_size(0), m_used(0), m_min_shift(0),
+      m_max_order(0), m_base_alignment(0), m_nonempty(0), m_free_lists(),
+      m_owns_memory(false) {
+  assert(buffer != nullptr || size == 0);
+  min_block_size = std::max(utils::next_power_of_two(min_block_size),
+                            utils::next_power_of_two(sizeof(FreeBlock)));
+  if (size >= min_block_size) {
+    m_size = size_t(1) << log2_floor(size);
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    m_base_alignment = arena_alignment(static_cast<size_t>(addr & (~addr + 1)));
+    init(min_block_size);
+  }
+}
+
+BuddyAllocator::~BuddyAllocator() {
+  if (m_owns_memory && m_memory) {
+    ::operator delete(m_memory, std::align_val_t(m_base_alignment));
+  }
+}
+
+BuddyAllocator::BuddyAllocator(BuddyAllocator &&other) noexcept
+    : m_memory(other.m_memory), m_size(other.m_size), m_used(other.m_used),
+      m_min_shift(other.m_min_shift), m_max_order(other.m_max_order),
+      m_base_alignment(other.m_base_alignment),
+      m_nonempty(other.m_nonempty), m_split(std::move(other.m_split)),
+      m_free(std::move(other.m_free)), m_owns_memory(other.m_owns_memory) {
+  std::copy(other.m_free_lists, other.m_free_lists + MAX_ORDERS, m_free_lists);
+  other.m_memory = nullptr;
+  other.m_size = 0;
+  other.m_used = 0;
+  other.m_nonempty = 0;
+  other.m_owns_memory = false;
+}
+
+BuddyAllocator &BuddyAllocator::operator=(BuddyAllocator &&other) noexcept {
+  if (this != &other) {
+    if (m_owns_memory && m_memory) {
+      ::operator delete(m_memory, std::align_val_t(m_base_alignment));
+    }
+
+    m_memory = other.m_memory;
+    m_size = other.m_size;
+    m_used = other.m_used;
+    m_min_shift = other.m_min_shift;
+    m_max_order = other.m_max_order;
+    m_base_alignment = other.m_base_alignment;
+    m_nonempty = other.m_nonempty;
+    std::copy(other.m_free_lists, other.m_free_lists + MAX_ORDERS,
+              m_free_lists);
+    m_split = std::move(other.m_split);
+    m_free = std::move(other.m_free);
+    m_owns_memory = other.m_owns_memory;
+
+    other.m_memory = nullptr;
+    other.m_size = 0;
+    other.m_used = 0;
+    other.m_nonempty = 0;
+    other.m_owns_memory = false;
+  }
+  return *this;
+}
+
+void BuddyAllocator::init(size_t min_block_size) {
+  m_min_shift = log2_floor(min_block_size);
+  m_max_order = log2_floor(m_size) - m_min_shift;
+
+  // One bit per node of a complete binary tree with 2^max_order leaves
+  size_t nodes = size_t(2) << m_max_order;
+  m_split.assign((nodes + 63) / 64, 0);
+  m_free.assign((nodes + 63) / 64, 0);
+  reset();
+}
+
+void *BuddyAllocator::allocate(size_t size, size_t alignment) {
+  if (size == 0 || m_size == 0 || alignment > m_base_alignment)
+    return nullptr;
+
+  // Blocks are aligned to their own size, so alignment only grows the order
+  size_t needed = std::max(size, alignment);
+  if (needed > m_size)
+    return nullptr;
+  size_t shift = log2_floor(utils::next_power_of_two(needed));
+  size_t order = shift > m_min_shift ? shift - m_min_shift : 0;
+
+  // Smallest non-empty free list of sufficient order
+  uint64_t candidates = m_nonempty >> order;
+  if (candidates == 0)
+    return nullptr;
+  size_t current = order + static_cast<size_t>(__builtin_ctzll(candidates));
+
+  FreeBlock *block = m_free_lists[current];
+  remove_free(current, block);
+  size_t offset = static_cast<size_t>(utils::ptr_diff(block, m_memory));
+  set(m_free, node_index(offset, current), false);
+
+  // Split down to the requested order, freeing the upper halves
+  while (current > order) {
+    set(m_split, node_index(offset, current), true);
+    --current;
+    push_free(current, offset + (size_t(1) << (current + m_min_shift)));
+  }
+
+  m_used += size_t(1) << (order + m_min_shift);
+  return block;
+}
+
+void BuddyAllocator::deallocate(void *ptr, size_t /*size*/) {
+  if (ptr == nullptr)
+    return;
+
+#ifdef DEBUG
+  assert(owns(ptr) && "Pointer does not belong to this allocator");
+#endif
+
+  size_t offset = static_cast<size_t>(utils::ptr_diff(ptr, m_memory));
+  size_t node = 0;
+  size_t order = order_of(offset, node);
+
+#ifdef DEBUG
+  assert(!test(m_free, node) && "Double free detected");
+#endif
+
+  m_used -= size_t(1) << (order + m_min_shift);
+
+  // Merge with the buddy for as long as it is free as a whole
+  while (order < m_max_order && test(m_free, node ^ 1)) {
+    size_t buddy_offset = offset ^ (size_t(1) << (order + m_min_shift));
+    remove_free(order, static_cast<FreeBlock *>(
+                           utils::ptr_add(m_memory, buddy_offset)));
+    set(m_free, node ^ 1, false);
+
+    node >>= 1;
+    set(m_split, node, false);
+    offset = std::min(offset, buddy_offset);
+    ++order;
+  }
+
+  push_free(order, offset);
+}
+
+bool BuddyAllocator::try_expand(void *ptr, size_t new_size) {
+  return owns(ptr) && new_size <= block_size(ptr);
+}
+
+void BuddyAllocator::reset() {
+  if (m_size == 0)
+    return;
+
+  std::fill(m_split.begin(), m_split.end(), 0);
+  std::fill(m_free.begin(), m_free.end(), 0);
+  std::fill(m_free_lists, m_free_lists + MAX_ORDERS, nullptr);
+  m_nonempty = 0;
+  m_used = 0;
+  push_free(m_max_order, 0);
+}
+
+bool BuddyAllocator::owns(void *ptr) const {
+  const char *p = static_cast<const char *>(ptr);
+  const char *start = static_cast<const char *>(m_memory);
+  return p >= start && p < start + m_size;
+}
+
+size_t BuddyAllocator::total_size() const { return m_size; }
+
+size_t BuddyAllocator::used_size() const { return m_used; }
+
+size_t BuddyAllocator::min_block_size() const noexcept {
+  return size_t(1) << m_min_shift;
+}
+
+size_t BuddyAllocator::block_size(void *ptr) const noexcept {
+  size_t node = 0;
+  size_t order =
+      order_of(static_cast<size_t>(utils::ptr_diff(ptr, m_memory)), node);
+  return size_t(1) << (order + m_min_shift);
+}
+
+size_t BuddyAllocator::largest_free_block() const noexcept {
+  if (m_nonempty == 0)
+    return 0;
+  size_t order = 63 - static_cast<size_t>(__builtin_clzll(m_nonempty));
+  return size_t(1) << (order + m_min_shift);
+}
+
+size_t BuddyAllocator::free_block_count(size_t order) const noexcept {
+  if (order > m_max_order)
+    return 0;
+  size_t count = 0;
+  for (FreeBlock *block = m_free_lists[order]; block; block = block->next) {
+    ++count;
+  }
+  return count;
+}
+
+size_t BuddyAllocator::node_index(size_t offset, size_t order) const noexcept {
+  size_t depth = m_max_order - order;
+  return (size_t(1) << depth) + (offset >> (order + m_min_shift));
+}
+
+bool BuddyAllocator::test(const std::vector<uint64_t> &bits,
+                          size_t node) const noexcept {
+  return (bits[node / 64] >> (node % 64)) & 1;
+}
+
+void BuddyAllocator::set(std::vector<uint64_t> &bits, size_t node,
+                         bool value) noexcept {
+  uint64_t mask = uint64_t(1) << (node % 64);
+  if (value) {
+    bits[node / 64] |= mask;
+  } else {
+    bits[node / 64] &= ~mask;
+  }
+}
+
+void BuddyAllocator::push_free(size_t order, size_t offset) noexcept {
+  FreeBlock *block = static_cast<FreeBlock *>(utils::ptr_add(m_memory, offset));
+  block->prev = nullptr;
+  block->next = m_free_lists[order];
+  if (block->next) {
+    block->next->prev = block;
+  }
+  m_free_lists[order] = block;
+  m_nonempty |= uint64_t(1) << order;
+  set(m_free, node_index(offset, order), true);
+}
+
+void BuddyAllocator::remove_free(size_t order, FreeBlock *block) noexcept {
+  if (block->prev) {
+    block->prev->next = block->next;
+  } else {
+    m_free_lists[order] = block->next;
+  }
+  if (block->next) {
+    block->next->prev = block->prev;
+  }
+  if (!m_free_lists[order]) {
+    m_nonempty &= ~(uint64_t(1) << order);
+  }
+}
+
+size_t BuddyAllocator::order_of(size_t offset, size_t &node) const noexcept {
+  // Descend from the root while the block containing offset is split
+  size_t order = m_max_order;
+  node = 1;
+  while (order > 0 && test(m_split, node)) {
+    --order;
+    node = node_index(offset, order);
+  }
+  return order;
+}
+
+} // namespace allocx
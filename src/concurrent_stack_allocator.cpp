@@ -0,0 +1,143 @@
+#include "allocx/concurrent_stack_allocator.hpp"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace allocx {
+
+namespace {
+
+// Sub-block cached by the calling thread, keyed by allocator id + epoch
+struct ThreadCache {
+  uint64_t id = 0;
+  uint64_t epoch = 0;
+  char *cursor = nullptr;
+  char *end = nullptr;
+};
+
+thread_local ThreadCache t_cache;
+
+std::atomic<uint64_t> g_next_id{1};
+
+} // namespace
+
+ConcurrentStackAllocator::ConcurrentStackAllocator(size_t size,
+                                                   size_t sub_block_size)
+    : m_memory(nullptr), m_allocation(nullptr), m_size(size),
+      m_sub_block_size(sub_block_size), m_id(0), m_epoch(0), m_offset(0) {
+  if (size > 0) {
+    m_allocation = ::operator new(size, std::align_val_t(CACHE_LINE));
+    m_memory = static_cast<char *>(m_allocation);
+  }
+  init();
+}
+
+ConcurrentStackAllocator::ConcurrentStackAllocator(void *buffer, size_t size,
+                                                   size_t sub_block_size)
+    : m_memory(nullptr), m_allocation(nullptr), m_size(0),
+      m_sub_block_size(sub_block_size), m_id(0), m_epoch(0), m_offset(0) {
+  assert(buffer != nullptr || size == 0);
+
+  // Start on a cache line so sub-blocks never share one
+  m_memory = static_cast<char *>(utils::align_pointer(buffer, CACHE_LINE));
+  size_t offset = static_cast<size_t>(utils::ptr_diff(m_memory, buffer));
+  m_size = size > offset ? size - offset : 0;
+  init();
+}
+
+ConcurrentStackAllocator::~ConcurrentStackAllocator() {
+  if (m_allocation) {
+    ::operator delete(m_allocation, std::align_val_t(CACHE_LINE));
+  }
+}
+
+void ConcurrentStackAllocator::init() {
+  m_sub_block_size =
+      utils::align_up(std::max(m_sub_block_size, CACHE_LINE), CACHE_LINE);
+  // An arena smaller than a sub-block is handed out as one sub-block
+  if (m_sub_block_size > m_size) {
+    m_sub_block_size = std::max(m_size / CACHE_LINE * CACHE_LINE, CACHE_LINE);
+  }
+  m_id = g_next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+char *ConcurrentStackAllocator::reserve(size_t bytes,
+                                        size_t &granted) noexcept {
+  size_t offset = m_offset.fetch_add(bytes, std::memory_order_relaxed);
+  if (offset >= m_size) {
+    granted = 0;
+    return nullptr; // Arena exhausted (the offset stays past the end)
+  }
+  // Every later reservation starts past the end, so the caller that
+  // crosses it owns the whole tail even if that is less than it asked for
+  granted = std::min(bytes, m_size - offset);
+  return m_memory + offset;
+}
+
+void *ConcurrentStackAllocator::allocate(size_t size, size_t alignment) {
+  if (size == 0 || size > m_size)
+    return nullptr;
+
+  // Large requests bypass the sub-blocks
+  if (size > m_sub_block_size / 2 || alignment > CACHE_LINE) {
+    if (alignment - 1 > m_size - size)
+      return nullptr; // Cannot fit even in an empty arena (nor overflow)
+    size_t padded = utils::align_up(size + alignment - 1, CACHE_LINE);
+    size_t granted = 0;
+    char *block = reserve(padded, granted);
+    if (!block)
+      return nullptr;
+    size_t skip = utils::calc_padding(reinterpret_cast<uintptr_t>(block),
+                                      alignment);
+    return skip <= granted && size <= granted - skip ? block + skip : nullptr;
+  }
+
+  ThreadCache &cache = t_cache;
+  uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+  if (cache.id == m_id && cache.epoch == epoch) {
+    char *ptr =
+        static_cast<char *>(utils::align_pointer(cache.cursor, alignment));
+    if (ptr <= cache.end && size <= static_cast<size_t>(cache.end - ptr)) {
+      cache.cursor = ptr + size;
+      return ptr;
+    }
+  }
+
+  // Take a fresh sub-block (or whatever is left at the end of the
+  // arena); the rest of the old one is abandoned
+  size_t granted = 0;
+  char *block = reserve(m_sub_block_size, granted);
+  if (!block || granted < size)
+    return nullptr;
+  cache.id = m_id;
+  cache.epoch = epoch;
+  cache.cursor = block + size; // Sub-blocks are cache-line aligned
+  cache.end = block + granted;
+  return block;
+}
+
+void ConcurrentStackAllocator::deallocate(void * /*ptr*/, size_t /*size*/) {
+  // Individual deallocation is not supported; use reset()
+}
+
+void ConcurrentStackAllocator::reset() {
+  m_epoch.fetch_add(1, std::memory_order_relaxed);
+  m_offset.store(0, std::memory_order_relaxed);
+}
+
+bool ConcurrentStackAllocator::owns(void *ptr) const {
+  const char *p = static_cast<const char *>(ptr);
+  return p >= m_memory && p < m_memory + m_size;
+}
+
+size_t ConcurrentStackAllocator::total_size() const { return m_size; }
+
+size_t ConcurrentStackAllocator::used_size() const {
+  return std::min(m_offset.load(std::memory_order_relaxed), m_size);
+}
+
+size_t ConcurrentStackAllocator::sub_block_size() const noexcept {
+  return m_sub_block_size;
+}
+
+} // namespace allocx
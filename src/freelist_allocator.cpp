@@ -1,6 +1,8 @@
 #include "allocx/freelist_allocator.hpp"
+#include "allocx/os_memory.hpp"
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <limits>
 #include <new>
 #include <utility>
@@ -9,7 +11,8 @@ namespace allocx {
 
 FreeListAllocator::FreeListAllocator(size_t size, Strategy strategy)
     : m_memory(nullptr), m_size(size), m_used(0), m_strategy(strategy),
-      m_free_list(nullptr), m_owns_memory(true) {
+      m_free_list(nullptr), m_owns_memory(true), m_handles(),
+      m_free_handle(NO_HANDLE), m_metrics(), m_free_heap() {
   if (size > HEADER_SIZE) {
     m_memory = ::operator new(size);
     init();
@@ -19,7 +22,8 @@ FreeListAllocator::FreeListAllocator(size_t size, Strategy strategy)
 FreeListAllocator::FreeListAllocator(void *buffer, size_t size,
                                      Strategy strategy)
     : m_memory(buffer), m_size(size), m_used(0), m_strategy(strategy),
-      m_free_list(nullptr), m_owns_memory(false) {
+      m_free_list(nullptr), m_owns_memory(false), m_handles(),
+      m_free_handle(NO_HANDLE), m_metrics(), m_free_heap() {
   assert(buffer != nullptr || size == 0);
   if (size > HEADER_SIZE) {
     init();
@@ -35,7 +39,10 @@ FreeListAllocator::~FreeListAllocator() {
 FreeListAllocator::FreeListAllocator(FreeListAllocator &&other) noexcept
     : m_memory(other.m_memory), m_size(other.m_size), m_used(other.m_used),
       m_strategy(other.m_strategy), m_free_list(other.m_free_list),
-      m_owns_memory(other.m_owns_memory) {
+      m_owns_memory(other.m_owns_memory),
+      m_handles(std::move(other.m_handles)),
+      m_free_handle(other.m_free_handle), m_metrics(other.m_metrics),
+      m_free_heap(std::move(other.m_free_heap)) {
   other.m_memory = nullptr;
   other.m_size = 0;
   other.m_used = 0;
@@ -56,6 +63,10 @@ FreeListAllocator::operator=(FreeListAllocator &&other) noexcept {
     m_strategy = other.m_strategy;
     m_free_list = other.m_free_list;
     m_owns_memory = other.m_owns_memory;
+    m_handles = std::move(other.m_handles);
+    m_free_handle = other.m_free_handle;
+    m_metrics = other.m_metrics;
+    m_free_heap = std::move(other.m_free_heap);
 
     other.m_memory = nullptr;
     other.m_size = 0;
@@ -67,21 +78,35 @@ FreeListAllocator::operator=(FreeListAllocator &&other) noexcept {
 }
 
 void FreeListAllocator::init() {
+  // Whole header-aligned units only: a block ending in odd slack would put
+  // the header of whatever follows it (after a split or a defragment move)
+  // at a misaligned address
+  m_size -= m_size % alignof(BlockHeader);
+
   // Create initial free block spanning entire memory
   m_free_list = static_cast<BlockHeader *>(m_memory);
   m_free_list->size = m_size - HEADER_SIZE;
   m_free_list->next = nullptr;
   m_free_list->is_free = true;
+  m_free_list->trimmed = false;
   m_free_list->padding = 0;
   m_used = 0;
+
+  m_metrics = Metrics();
+  m_free_heap.clear();
+  track_free(m_free_list);
+
+  // All handles are invalidated
+  m_handles.clear();
+  m_free_handle = NO_HANDLE;
 }
 
 void *FreeListAllocator::allocate(size_t size, size_t alignment) {
   if (size == 0)
     return nullptr;
 
-  // Ensure minimum size
-  size = std::max(size, MIN_BLOCK_SIZE);
+  // Ensure minimum size, rounded so that split headers stay aligned
+  size = utils::align_up(std::max(size, MIN_BLOCK_SIZE), alignof(BlockHeader));
 
   // Find suitable block based on strategy
   BlockHeader *block = nullptr;
@@ -108,45 +133,28 @@ void *FreeListAllocator::allocate(size_t size, size_t alignment) {
   size_t total_size = padding + size;
   if (block->size >= total_size + HEADER_SIZE + MIN_BLOCK_SIZE) {
     split_block(block, size, padding);
+  } else {
+    untrack_free(block);
   }
 
   // Remove from free list and mark as used
   remove_free_block(block);
+  block->handle = NO_HANDLE;
   block->is_free = false;
-  block->padding = static_cast<uint8_t>(padding);
 
   m_used += HEADER_SIZE + block->size;
 
-  // Return aligned data pointer
-  return reinterpret_cast<char *>(block) + HEADER_SIZE + padding;
+  // Return aligned data pointer, recording the padding just before it
+  uint8_t *data = reinterpret_cast<uint8_t *>(block) + HEADER_SIZE + padding;
+  store_padding(block, data, padding);
+  return data;
 }
 
 void FreeListAllocator::deallocate(void *ptr, size_t /*size*/) {
   if (ptr == nullptr)
     return;
 
-  // Recover block header
-  // We need to find the actual header by checking padding
-  // For simplicity, we'll scan backwards - but this assumes ptr is valid
-  char *data = static_cast<char *>(ptr);
-
-  // The header is before the data, accounting for any padding
-  // We try to find a valid header by scanning
-  BlockHeader *block = nullptr;
-  for (size_t offset = HEADER_SIZE;
-       offset <= HEADER_SIZE + alignof(std::max_align_t); ++offset) {
-    BlockHeader *candidate = reinterpret_cast<BlockHeader *>(data - offset);
-    if (reinterpret_cast<char *>(candidate) >= static_cast<char *>(m_memory) &&
-        !candidate->is_free && candidate->padding == offset - HEADER_SIZE) {
-      block = candidate;
-      break;
-    }
-  }
-
-  if (!block) {
-    // Fallback: assume HEADER_SIZE offset with no padding
-    block = reinterpret_cast<BlockHeader *>(data - HEADER_SIZE);
-  }
+  BlockHeader *block = header_of(ptr);
 
 #ifdef DEBUG
   assert(owns(ptr) && "Pointer does not belong to this allocator");
@@ -155,12 +163,55 @@ void FreeListAllocator::deallocate(void *ptr, size_t /*size*/) {
 
   m_used -= HEADER_SIZE + block->size;
 
-  // Mark as free and add to free list
+  // Mark as free and add to free list, merging with free neighbours
   block->is_free = true;
+  block->trimmed = false;
+  block->padding = 0;
+  track_free(block);
   insert_free_block(block);
+}
+
+bool FreeListAllocator::try_expand(void *ptr, size_t new_size) {
+  if (ptr == nullptr || new_size == 0)
+    return false;
+
+  BlockHeader *block = header_of(ptr);
+  size_t needed = static_cast<size_t>(static_cast<char *>(ptr) -
+                                      reinterpret_cast<char *>(block) -
+                                      HEADER_SIZE) +
+                  utils::align_up(std::max(new_size, MIN_BLOCK_SIZE),
+                                  alignof(BlockHeader));
+  size_t old_size = block->size;
+
+  if (needed > block->size) {
+    // Absorb the physically following block if it is free and big enough
+    BlockHeader *next = next_physical(block);
+    const char *arena_end = static_cast<char *>(m_memory) + m_size;
+    if (reinterpret_cast<char *>(next) >= arena_end || !next->is_free ||
+        block->size + HEADER_SIZE + next->size < needed) {
+      return false;
+    }
+    untrack_free(next);
+    remove_free_block(next);
+    block->size += HEADER_SIZE + next->size;
+  }
+
+  // Return any surplus large enough to form its own free block
+  if (block->size >= needed + HEADER_SIZE + MIN_BLOCK_SIZE) {
+    BlockHeader *surplus = reinterpret_cast<BlockHeader *>(
+        reinterpret_cast<char *>(block) + HEADER_SIZE + needed);
+    surplus->size = block->size - needed - HEADER_SIZE;
+    surplus->is_free = true;
+    surplus->trimmed = false;
+    surplus->padding = 0;
+    block->size = needed;
+    track_free(surplus);
+    insert_free_block(surplus);
+  }
 
-  // Coalesce adjacent free blocks
-  coalesce();
+  m_used += block->size;
+  m_used -= old_size;
+  return true;
 }
 
 void FreeListAllocator::reset() {
@@ -181,25 +232,117 @@ size_t FreeListAllocator::total_size() const { return m_size; }
 size_t FreeListAllocator::used_size() const { return m_used; }
 
 size_t FreeListAllocator::free_block_count() const noexcept {
-  size_t count = 0;
-  BlockHeader *current = m_free_list;
-  while (current) {
-    ++count;
-    current = current->next;
-  }
-  return count;
+  return m_metrics.free_blocks;
 }
 
 size_t FreeListAllocator::largest_free_block() const noexcept {
-  size_t largest = 0;
-  BlockHeader *current = m_free_list;
-  while (current) {
-    if (current->size > largest) {
-      largest = current->size;
-    }
-    current = current->next;
+  return m_free_heap.empty() ? 0 : m_free_heap.front().size;
+}
+
+FreeListAllocator::Metrics FreeListAllocator::metrics() const noexcept {
+  Metrics result = m_metrics;
+  result.largest_free_block = largest_free_block();
+  result.external_fragmentation =
+      result.free_bytes
+          ? 1.0 - static_cast<double>(result.largest_free_block) /
+                      static_cast<double>(result.free_bytes)
+          : 0.0;
+  return result;
+}
+
+void FreeListAllocator::dump_heap_map(std::ostream &os) const {
+  static const char *const strategy_names[] = {"first_fit", "best_fit",
+                                               "worst_fit"};
+  os << "# arena_size=" << m_size << "\n";
+  os << "# header_size=" << HEADER_SIZE << "\n";
+  os << "# strategy=" << strategy_names[static_cast<int>(m_strategy)] << "\n";
+  os << "offset,size,state\n";
+
+  if (m_size <= HEADER_SIZE)
+    return;
+
+  const char *start = static_cast<const char *>(m_memory);
+  const char *end = start + m_size;
+  BlockHeader *block = static_cast<BlockHeader *>(m_memory);
+  while (reinterpret_cast<const char *>(block) < end) {
+    char state = block->is_free ? 'F' : (block->handle != NO_HANDLE ? 'R' : 'A');
+    os << (reinterpret_cast<const char *>(block) - start) << ","
+       << HEADER_SIZE + block->size << "," << state << "\n";
+    block = next_physical(block);
+  }
+}
+
+void FreeListAllocator::track_free(BlockHeader *block) {
+  ++m_metrics.free_blocks;
+  m_metrics.free_bytes += block->size;
+  ++m_metrics.histogram[63 - __builtin_clzll(block->size)];
+
+  m_free_heap.push_back({block->size, block});
+  block->handle = static_cast<uint32_t>(m_free_heap.size() - 1);
+  sift_up(m_free_heap.size() - 1);
+}
+
+void FreeListAllocator::untrack_free(BlockHeader *block) noexcept {
+  --m_metrics.free_blocks;
+  m_metrics.free_bytes -= block->size;
+  --m_metrics.histogram[63 - __builtin_clzll(block->size)];
+
+  // Move the last entry into the vacated slot and restore the heap
+  size_t slot = block->handle;
+  HeapEntry last = m_free_heap.back();
+  m_free_heap.pop_back();
+  if (slot < m_free_heap.size()) {
+    m_free_heap[slot] = last;
+    last.block->handle = static_cast<uint32_t>(slot);
+    sift_down(sift_up(slot));
   }
-  return largest;
+}
+
+void FreeListAllocator::resize_free(BlockHeader *block, size_t size) noexcept {
+  m_metrics.free_bytes += size - block->size;
+  --m_metrics.histogram[63 - __builtin_clzll(block->size)];
+  ++m_metrics.histogram[63 - __builtin_clzll(size)];
+
+  bool grew = size > block->size;
+  block->size = size;
+  m_free_heap[block->handle].size = size;
+  if (grew) {
+    sift_up(block->handle);
+  } else {
+    sift_down(block->handle);
+  }
+}
+
+size_t FreeListAllocator::sift_up(size_t slot) noexcept {
+  HeapEntry entry = m_free_heap[slot];
+  while (slot > 0) {
+    size_t parent = (slot - 1) / 2;
+    if (m_free_heap[parent].size >= entry.size)
+      break;
+    m_free_heap[slot] = m_free_heap[parent];
+    m_free_heap[slot].block->handle = static_cast<uint32_t>(slot);
+    slot = parent;
+  }
+  m_free_heap[slot] = entry;
+  entry.block->handle = static_cast<uint32_t>(slot);
+  return slot;
+}
+
+void FreeListAllocator::sift_down(size_t slot) noexcept {
+  HeapEntry entry = m_free_heap[slot];
+  size_t count = m_free_heap.size();
+  for (size_t child = 2 * slot + 1; child < count; child = 2 * slot + 1) {
+    if (child + 1 < count &&
+        m_free_heap[child + 1].size > m_free_heap[child].size)
+      ++child;
+    if (m_free_heap[child].size <= entry.size)
+      break;
+    m_free_heap[slot] = m_free_heap[child];
+    m_free_heap[slot].block->handle = static_cast<uint32_t>(slot);
+    slot = child;
+  }
+  m_free_heap[slot] = entry;
+  entry.block->handle = static_cast<uint32_t>(slot);
 }
 
 FreeListAllocator::BlockHeader *
@@ -266,43 +409,59 @@ void FreeListAllocator::split_block(BlockHeader *block, size_t size,
   // Create new block after the allocated space
   BlockHeader *new_block = reinterpret_cast<BlockHeader *>(
       reinterpret_cast<char *>(block) + HEADER_SIZE + padding + size);
-  new_block->size = remaining;
+  new_block->size = block->size;
   new_block->is_free = true;
+  new_block->trimmed = false;
   new_block->padding = 0;
 
+  // The remainder takes over the block's slot in the size heap
+  new_block->handle = block->handle;
+  m_free_heap[block->handle].block = new_block;
+  resize_free(new_block, remaining);
+
   // Update original block size
   block->size = padding + size;
 
-  // Insert new block into free list
+  // Insert new block into free list (directly after block, by address)
   new_block->next = block->next;
   block->next = new_block;
 }
 
-void FreeListAllocator::coalesce() {
-  // Sort free list by address for coalescing
-  // For simplicity, we just check adjacent blocks
-  BlockHeader *current = m_free_list;
-  while (current && current->next) {
-    BlockHeader *next = current->next;
-
-    // Check if blocks are adjacent
-    char *current_end =
-        reinterpret_cast<char *>(current) + HEADER_SIZE + current->size;
-    if (current_end == reinterpret_cast<char *>(next)) {
-      // Merge blocks
-      current->size += HEADER_SIZE + next->size;
-      current->next = next->next;
-      // Don't advance - check if we can merge with the new next
-    } else {
-      current = current->next;
-    }
+void FreeListAllocator::coalesce(BlockHeader *prev, BlockHeader *block) {
+  // Merge with the following free block if physically adjacent
+  BlockHeader *next = block->next;
+  if (next && next_physical(block) == next) {
+    untrack_free(next);
+    resize_free(block, block->size + HEADER_SIZE + next->size);
+    block->next = next->next;
+    block->trimmed = false;
+  }
+
+  // Merge into the preceding free block if physically adjacent
+  if (prev && next_physical(prev) == block) {
+    untrack_free(block);
+    resize_free(prev, prev->size + HEADER_SIZE + block->size);
+    prev->next = block->next;
+    prev->trimmed = false;
   }
 }
 
 void FreeListAllocator::insert_free_block(BlockHeader *block) {
-  // Insert at head for O(1)
-  block->next = m_free_list;
-  m_free_list = block;
+  // Keep the list sorted by address so neighbours can be merged
+  BlockHeader *prev = nullptr;
+  BlockHeader *current = m_free_list;
+  while (current && current < block) {
+    prev = current;
+    current = current->next;
+  }
+
+  block->next = current;
+  if (prev) {
+    prev->next = block;
+  } else {
+    m_free_list = block;
+  }
+  coalesce(prev, block);
 }
 
 void FreeListAllocator::remove_free_block(BlockHeader *block) {
@@ -321,4 +480,187 @@ void FreeListAllocator::remove_free_block(BlockHeader *block) {
   }
 }
 
+void FreeListAllocator::store_padding(BlockHeader *block, uint8_t *data,
+                                      size_t padding) noexcept {
+  // With no padding, data[-1] is block->padding itself
+  block->padding = static_cast<uint8_t>(std::min(padding, LONG_PADDING));
+  data[-1] = block->padding;
+  if (padding >= LONG_PADDING) {
+    std::memcpy(data - 1 - sizeof(size_t), &padding, sizeof(size_t));
+  }
+}
+
+FreeListAllocator::BlockHeader *
+FreeListAllocator::header_of(void *ptr) const noexcept {
+  // Recover block header from the padding recorded before the data
+  uint8_t *data = static_cast<uint8_t *>(ptr);
+  size_t padding = data[-1];
+  if (padding == LONG_PADDING) {
+    std::memcpy(&padding, data - 1 - sizeof(size_t), sizeof(size_t));
+  }
+  return reinterpret_cast<BlockHeader *>(data - padding - HEADER_SIZE);
+}
+
+FreeListAllocator::BlockHeader *
+FreeListAllocator::next_physical(BlockHeader *block) const noexcept {
+  return reinterpret_cast<BlockHeader *>(reinterpret_cast<char *>(block) +
+                                         HEADER_SIZE + block->size);
+}
+
+size_t FreeListAllocator::trim(size_t max_bytes, bool lazy) {
+  size_t released = 0;
+  for (BlockHeader *block = m_free_list; block && released < max_bytes;
+       block = block->next) {
+    if (block->trimmed)
+      continue;
+    // Flagged even when no whole page fits, so the block is not rescanned
+    released += os::decommit(reinterpret_cast<char *>(block) + HEADER_SIZE,
+                             block->size, lazy);
+    block->trimmed = true;
+  }
+  return released;
+}
+
+FreeListAllocator::Handle FreeListAllocator::allocate_handle(size_t size,
+                                                             size_t alignment) {
+  void *data = allocate(size, alignment);
+  if (!data)
+    return NULL_HANDLE;
+
+  uint32_t index;
+  if (m_free_handle != NO_HANDLE) {
+    index = m_free_handle;
+    m_free_handle = m_handles[index].next_free;
+  } else {
+    index = static_cast<uint32_t>(m_handles.size());
+    m_handles.push_back(HandleEntry());
+  }
+  m_handles[index] = {data, alignment, NO_HANDLE};
+  header_of(data)->handle = index;
+  return index + 1;
+}
+
+void FreeListAllocator::deallocate_handle(Handle handle) {
+  if (handle == NULL_HANDLE)
+    return;
+
+  uint32_t index = handle - 1;
+#ifdef DEBUG
+  assert(index < m_handles.size() && m_handles[index].data &&
+         "Invalid or freed handle");
+#endif
+
+  deallocate(m_handles[index].data);
+  m_handles[index].data = nullptr;
+  m_handles[index].next_free = m_free_handle;
+  m_free_handle = index;
+}
+
+void *FreeListAllocator::resolve(Handle handle) const noexcept {
+  if (handle == NULL_HANDLE)
+    return nullptr;
+#ifdef DEBUG
+  assert(handle - 1 < m_handles.size() && "Invalid handle");
+#endif
+  return m_handles[handle - 1].data;
+}
+
+size_t FreeListAllocator::defragment(size_t max_bytes,
+                                     std::chrono::nanoseconds max_time) {
+  using Clock = std::chrono::steady_clock;
+  const bool timed = max_time != std::chrono::nanoseconds::max();
+  const Clock::time_point deadline =
+      timed ? Clock::now() + max_time : Clock::time_point();
+  const char *arena_end = static_cast<char *>(m_memory) + m_size;
+
+  size_t moved = 0;
+  BlockHeader *prev = nullptr;
+  BlockHeader *free_block = m_free_list;
+  while (free_block && moved < max_bytes) {
+    if (timed && Clock::now() >= deadline)
+      break;
+
+    // Slide the block after this free block down, if it may move
+    BlockHeader *block = next_physical(free_block);
+    size_t bytes = 0;
+    if (reinterpret_cast<char *>(block) < arena_end && !block->is_free &&
+        block->handle != NO_HANDLE) {
+      bytes = slide_down(prev, free_block);
+    }
+
+    if (bytes == 0) {
+      prev = free_block;
+      free_block = free_block->next;
+    } else {
+      // The gap now sits after the moved block (or was absorbed by it)
+      moved += bytes;
+      free_block = prev ? prev->next : m_free_list;
+    }
+  }
+  return moved;
+}
+
+size_t FreeListAllocator::slide_down(BlockHeader *prev,
+                                     BlockHeader *free_block) {
+  BlockHeader *block = next_physical(free_block);
+  HandleEntry &entry = m_handles[block->handle];
+
+  // Read everything from the old header before the data move clobbers it
+  uint32_t handle = block->handle;
+  size_t old_size = block->size;
+  uint8_t *old_data = static_cast<uint8_t *>(entry.data);
+  size_t payload =
+      block->size - static_cast<size_t>(old_data - reinterpret_cast<uint8_t *>(
+                                                       block) -
+                                        HEADER_SIZE);
+  char *region_end = reinterpret_cast<char *>(next_physical(block));
+  BlockHeader *next_free = free_block->next;
+
+  char *start = reinterpret_cast<char *>(free_block);
+  size_t padding = utils::calc_padding(
+      reinterpret_cast<uintptr_t>(start) + HEADER_SIZE, entry.alignment);
+  uint8_t *new_data =
+      reinterpret_cast<uint8_t *>(start) + HEADER_SIZE + padding;
+  char *new_end = reinterpret_cast<char *>(new_data) + payload;
+  if (new_end > region_end)
+    return 0; // Alignment padding does not fit; leave the block pinned
+
+  untrack_free(free_block);
+  std::memmove(new_data, old_data, payload);
+
+  BlockHeader *moved = reinterpret_cast<BlockHeader *>(start);
+  moved->size = padding + payload;
+  moved->next = nullptr;
+  moved->handle = handle;
+  moved->is_free = false;
+  store_padding(moved, new_data, padding);
+
+  // Re-create the free space after the moved block
+  BlockHeader *successor = next_free;
+  size_t leftover = static_cast<size_t>(region_end - new_end);
+  if (leftover >= HEADER_SIZE + MIN_BLOCK_SIZE) {
+    BlockHeader *gap = reinterpret_cast<BlockHeader *>(new_end);
+    gap->size = leftover - HEADER_SIZE;
+    gap->next = next_free;
+    gap->is_free = true;
+    gap->trimmed = false;
+    gap->padding = 0;
+    track_free(gap);
+    coalesce(nullptr, gap);
+    successor = gap;
+  } else {
+    moved->size += leftover; // Too small to track; keep it as slack
+  }
+  if (prev) {
+    prev->next = successor;
+  } else {
+    m_free_list = successor;
+  }
+
+  m_used += moved->size;
+  m_used -= old_size;
+  entry.data = new_data;
+  return payload;
+}
+
 } // namespace allocx
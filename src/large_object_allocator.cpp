@@ -0,0 +1,166 @@
+#include "allocx/large_object_allocator.hpp"
+#include "allocx/os_memory.hpp"
+#include "allocx/utils.hpp"
+#include <cassert>
+
+namespace allocx {
+
+LargeObjectAllocator::LargeObjectAllocator(const LargeObjectOptions &options,
+                                           IAllocator *fallback)
+    : m_options(options), m_fallback(fallback), m_mappings(), m_cache(),
+      m_mapped_bytes(0), m_cached_bytes(0), m_cache_hits(0) {}
+
+LargeObjectAllocator::~LargeObjectAllocator() { reset(); }
+
+void *LargeObjectAllocator::allocate(size_t size, size_t alignment) {
+  if (size == 0)
+    return nullptr;
+  if (m_fallback && size < m_options.threshold)
+    return m_fallback->allocate(size, alignment);
+
+  size_t page = os::page_size();
+  if (size > SIZE_MAX - page)
+    return nullptr;
+  size_t mapping_size = utils::align_up(size, page);
+
+  void *base = take_cached(mapping_size, alignment);
+  if (!base) {
+    base = os::map_aligned(mapping_size, alignment);
+    if (!base)
+      return nullptr;
+  }
+  m_mappings.emplace(reinterpret_cast<uintptr_t>(base), mapping_size);
+  m_mapped_bytes += mapping_size;
+  return base;
+}
+
+void LargeObjectAllocator::deallocate(void *ptr, size_t size) {
+  if (!ptr)
+    return;
+
+  auto it = m_mappings.find(reinterpret_cast<uintptr_t>(ptr));
+  if (it == m_mappings.end()) {
+#ifdef DEBUG
+    assert(m_fallback && "Pointer does not belong to this allocator");
+#endif
+    if (m_fallback)
+      m_fallback->deallocate(ptr, size);
+    return;
+  }
+
+  size_t mapping_size = it->second;
+  m_mappings.erase(it);
+  m_mapped_bytes -= mapping_size;
+  release(ptr, mapping_size);
+}
+
+bool LargeObjectAllocator::try_expand(void *ptr, size_t new_size) {
+  auto it = m_mappings.find(reinterpret_cast<uintptr_t>(ptr));
+  if (it == m_mappings.end())
+    return m_fallback && m_fallback->try_expand(ptr, new_size);
+  if (new_size <= it->second)
+    return true;
+
+  // Extend the mapping if the pages after it are free
+  size_t page = os::page_size();
+  if (new_size > SIZE_MAX - page)
+    return false;
+  size_t mapping_size = utils::align_up(new_size, page);
+  if (!os::remap(ptr, it->second, mapping_size, false))
+    return false;
+  m_mapped_bytes += mapping_size - it->second;
+  it->second = mapping_size;
+  return true;
+}
+
+void *LargeObjectAllocator::reallocate(void *ptr, size_t old_size,
+                                       size_t new_size, size_t alignment) {
+  auto it = m_mappings.find(reinterpret_cast<uintptr_t>(ptr));
+  if (ptr == nullptr || it == m_mappings.end() || new_size == 0 ||
+      alignment > os::page_size()) {
+    return IAllocator::reallocate(ptr, old_size, new_size, alignment);
+  }
+  if (try_expand(ptr, new_size))
+    return ptr;
+
+  // Let the kernel move the pages instead of copying them
+  size_t mapping_size = utils::align_up(new_size, os::page_size());
+  void *moved = os::remap(ptr, it->second, mapping_size, true);
+  if (!moved)
+    return nullptr;
+  m_mapped_bytes += mapping_size - it->second;
+  m_mappings.erase(it);
+  m_mappings.emplace(reinterpret_cast<uintptr_t>(moved), mapping_size);
+  return moved;
+}
+
+void LargeObjectAllocator::reset() {
+  for (const auto &mapping : m_mappings) {
+    os::unmap(reinterpret_cast<void *>(mapping.first), mapping.second);
+  }
+  for (const CachedMapping &cached : m_cache) {
+    os::unmap(cached.base, cached.size);
+  }
+  m_mappings.clear();
+  m_cache.clear();
+  m_mapped_bytes = 0;
+  m_cached_bytes = 0;
+}
+
+bool LargeObjectAllocator::owns(void *ptr) const {
+  return find(ptr) != m_mappings.end() || (m_fallback && m_fallback->owns(ptr));
+}
+
+size_t LargeObjectAllocator::total_size() const {
+  return m_mapped_bytes + m_cached_bytes;
+}
+
+size_t LargeObjectAllocator::used_size() const { return m_mapped_bytes; }
+
+std::map<uintptr_t, size_t>::const_iterator
+LargeObjectAllocator::find(const void *ptr) const {
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  auto it = m_mappings.upper_bound(address);
+  if (it == m_mappings.begin())
+    return m_mappings.end();
+  --it;
+  return address < it->first + it->second ? it : m_mappings.end();
+}
+
+void *LargeObjectAllocator::take_cached(size_t &size, size_t alignment) {
+  for (size_t i = 0; i < m_cache.size(); ++i) {
+    const CachedMapping &cached = m_cache[i];
+    if (cached.size < size || cached.size - size > size / 4 ||
+        !utils::is_aligned(cached.base, alignment))
+      continue;
+
+    // The mapping may be up to 25% larger; report its real size
+    void *base = cached.base;
+    size = cached.size;
+    m_cached_bytes -= cached.size;
+    m_cache.erase(m_cache.begin() + static_cast<std::ptrdiff_t>(i));
+    ++m_cache_hits;
+    return base;
+  }
+  return nullptr;
+}
+
+void LargeObjectAllocator::release(void *base, size_t size) {
+  if (m_options.cache_entries == 0 || size > m_options.cache_bytes) {
+    os::unmap(base, size);
+    return;
+  }
+
+  m_cache.insert(m_cache.begin(), CachedMapping{base, size});
+  m_cached_bytes += size;
+  // Evict the oldest mappings beyond the limits
+  while (m_cache.size() > m_options.cache_entries ||
+         m_cached_bytes > m_options.cache_bytes) {
+    const CachedMapping &oldest = m_cache.back();
+    os::unmap(oldest.base, oldest.size);
+    m_cached_bytes -= oldest.size;
+    m_cache.pop_back();
+  }
+}
+
+} // namespace allocx
@@ -0,0 +1,172 @@
+#include "allocx/numa_pool_selector.hpp"
+#include "allocx/utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
+namespace allocx {
+
+namespace {
+
+// Threads rarely change node, so getcpu() is only re-checked periodically
+constexpr unsigned NODE_REFRESH_INTERVAL = 64;
+
+int cached_numa_node() {
+  thread_local int node = 0;
+  thread_local unsigned countdown = 0;
+  if (countdown == 0) {
+    node = os::current_numa_node();
+    countdown = NODE_REFRESH_INTERVAL;
+  }
+  --countdown;
+  return node;
+}
+
+} // namespace
+
+struct NumaPoolSelector::Node {
+  std::mutex mutex; // Guards pool operations
+  std::once_flag created;
+  std::atomic<PoolAllocator *> pool{nullptr}; // Published once built
+  std::unique_ptr<PoolAllocator> storage;
+  void *memory = nullptr;
+  size_t memory_size = 0;
+  bool placed = false; // Placement policy accepted by the kernel
+};
+
+NumaPoolSelector::NumaPoolSelector(size_t chunk_size, size_t chunks_per_node,
+                                   os::NumaPolicy policy, size_t alignment)
+    : m_chunk_size(chunk_size), m_chunks_per_node(chunks_per_node),
+      m_alignment(alignment), m_policy(policy), m_nodes() {
+  size_t count = os::numa_node_count();
+  m_nodes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    m_nodes.push_back(std::unique_ptr<Node>(new Node()));
+  }
+}
+
+NumaPoolSelector::~NumaPoolSelector() {
+  for (const std::unique_ptr<Node> &node : m_nodes) {
+    node->storage.reset();
+    os::unmap(node->memory, node->memory_size);
+  }
+}
+
+PoolAllocator *NumaPoolSelector::pool_for(Node &node, int index) {
+  if (PoolAllocator *pool = node.pool.load(std::memory_order_acquire))
+    return pool;
+  std::call_once(node.created, [&]() {
+    size_t chunk = utils::align_up(std::max(m_chunk_size, sizeof(void *)),
+                                   m_alignment);
+    size_t size = utils::align_up(chunk * m_chunks_per_node + m_alignment,
+                                  os::page_size());
+    void *memory = os::map(size);
+    if (!memory)
+      return;
+
+    // Set the policy before the pool's free list touches the pages; with
+    // first-touch, touching them here places them on this thread's node
+    node.placed = m_policy == os::NumaPolicy::first_touch ||
+                  os::set_numa_policy(memory, size, m_policy, index);
+    node.memory = memory;
+    node.memory_size = size;
+    node.storage.reset(
+        new PoolAllocator(memory, size, m_chunk_size, m_alignment));
+    node.pool.store(node.storage.get(), std::memory_order_release);
+  });
+  return node.pool.load(std::memory_order_acquire);
+}
+
+void *NumaPoolSelector::allocate(size_t size, size_t /*alignment*/) {
+  if (size > m_chunk_size)
+    return nullptr;
+
+  // Local node first, then the others in order
+  size_t local = static_cast<size_t>(cached_numa_node());
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    size_t index = (local + i) % m_nodes.size();
+    Node &node = *m_nodes[index];
+    // A first-touch pool built here would land on the caller's node
+    if (i > 0 && m_policy == os::NumaPolicy::first_touch &&
+        !has_pool(static_cast<int>(index)))
+      continue;
+    PoolAllocator *pool = pool_for(node, static_cast<int>(index));
+    if (!pool)
+      continue;
+    std::lock_guard<std::mutex> lock(node.mutex);
+    if (void *ptr = pool->allocate())
+      return ptr;
+  }
+  return nullptr;
+}
+
+void NumaPoolSelector::deallocate(void *ptr, size_t /*size*/) {
+  if (ptr == nullptr)
+    return;
+
+  int index = node_of(ptr);
+#ifdef DEBUG
+  assert(index >= 0 && "Pointer does not belong to this selector");
+#endif
+  if (index < 0)
+    return;
+  Node &node = *m_nodes[static_cast<size_t>(index)];
+  std::lock_guard<std::mutex> lock(node.mutex);
+  node.pool.load(std::memory_order_relaxed)->deallocate(ptr);
+}
+
+void NumaPoolSelector::reset() {
+  for (const std::unique_ptr<Node> &node : m_nodes) {
+    PoolAllocator *pool = node->pool.load(std::memory_order_acquire);
+    if (pool) {
+      std::lock_guard<std::mutex> lock(node->mutex);
+      pool->reset();
+    }
+  }
+}
+
+bool NumaPoolSelector::owns(void *ptr) const { return node_of(ptr) >= 0; }
+
+size_t NumaPoolSelector::total_size() const {
+  size_t total = 0;
+  for (const std::unique_ptr<Node> &node : m_nodes) {
+    PoolAllocator *pool = node->pool.load(std::memory_order_acquire);
+    if (pool)
+      total += pool->total_size();
+  }
+  return total;
+}
+
+size_t NumaPoolSelector::used_size() const {
+  size_t used = 0;
+  for (const std::unique_ptr<Node> &node : m_nodes) {
+    PoolAllocator *pool = node->pool.load(std::memory_order_acquire);
+    if (pool) {
+      std::lock_guard<std::mutex> lock(node->mutex);
+      used += pool->used_size();
+    }
+  }
+  return used;
+}
+
+int NumaPoolSelector::node_of(const void *ptr) const noexcept {
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    PoolAllocator *pool = m_nodes[i]->pool.load(std::memory_order_acquire);
+    if (pool && pool->owns(const_cast<void *>(ptr)))
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+bool NumaPoolSelector::has_pool(int node) const noexcept {
+  return node >= 0 && static_cast<size_t>(node) < m_nodes.size() &&
+         m_nodes[static_cast<size_t>(node)]->pool.load(
+             std::memory_order_acquire) != nullptr;
+}
+
+bool NumaPoolSelector::placement_applied(int node) const noexcept {
+  return has_pool(node) && m_nodes[static_cast<size_t>(node)]->placed;
+}
+
+} // namespace allocx
@@ -0,0 +1,218 @@
+#include "allocx/os_memory.hpp"
+#include "allocx/utils.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace allocx {
+namespace os {
+
+size_t page_size() noexcept {
+  static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+void *map(size_t size) noexcept {
+  if (size == 0)
+    return nullptr;
+  void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+void *map_aligned(size_t size, size_t alignment) noexcept {
+  if (alignment <= page_size())
+    return map(size);
+
+  size = utils::align_up(size, page_size());
+  size_t padded = size + alignment;
+  if (padded < size)
+    return nullptr;
+  void *raw = map(padded);
+  if (!raw)
+    return nullptr;
+
+  uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t aligned = utils::align_up(start, alignment);
+  if (aligned > start)
+    ::munmap(raw, aligned - start);
+  size_t tail = (start + padded) - (aligned + size);
+  if (tail > 0)
+    ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+  return reinterpret_cast<void *>(aligned);
+}
+
+void *map_shared(int fd, size_t size) noexcept {
+  if (fd < 0 || size == 0)
+    return nullptr;
+  void *ptr =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+bool flush(void *ptr, size_t size) noexcept {
+  return ::msync(ptr, size, MS_SYNC) == 0;
+}
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+void prefault(void *ptr, size_t size) noexcept {
+  if (ptr == nullptr || size == 0)
+    return;
+  size_t page = page_size();
+  uintptr_t start = reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t(page) - 1);
+  uintptr_t end = utils::align_up(reinterpret_cast<uintptr_t>(ptr) + size, page);
+  if (::madvise(reinterpret_cast<void *>(start), end - start,
+                MADV_POPULATE_WRITE) == 0)
+    return;
+
+  // Older kernels: an atomic OR with 0 dirties the page without
+  // overwriting stores made concurrently by the allocator's owner
+  char *first = static_cast<char *>(ptr);
+  char *last = first + size - 1;
+  for (char *p = first; p <= last;) {
+    __atomic_fetch_or(p, 0, __ATOMIC_RELAXED);
+    uintptr_t next =
+        (reinterpret_cast<uintptr_t>(p) & ~(uintptr_t(page) - 1)) + page;
+    if (next > reinterpret_cast<uintptr_t>(last))
+      break;
+    p = reinterpret_cast<char *>(next);
+  }
+}
+
+bool lock(void *ptr, size_t size) noexcept {
+  return ptr != nullptr && ::mlock(ptr, size) == 0;
+}
+
+void unlock(void *ptr, size_t size) noexcept {
+  if (ptr)
+    ::munlock(ptr, size);
+}
+
+size_t decommit(void *ptr, size_t size, bool lazy) noexcept {
+  if (ptr == nullptr)
+    return 0;
+  size_t page = page_size();
+  uintptr_t start = utils::align_up(reinterpret_cast<uintptr_t>(ptr), page);
+  uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) &
+                  ~(uintptr_t(page) - 1);
+  if (end <= start)
+    return 0;
+  size_t length = end - start;
+  void *first = reinterpret_cast<void *>(start);
+  // MADV_FREE is refused on some mappings (e.g. shared); drop those instead
+  if (lazy && ::madvise(first, length, MADV_FREE) == 0)
+    return length;
+  return ::madvise(first, length, MADV_DONTNEED) == 0 ? length : 0;
+}
+
+void unmap(void *ptr, size_t size) noexcept {
+  if (ptr)
+    ::munmap(ptr, size);
+}
+
+void *remap(void *ptr, size_t old_size, size_t new_size,
+            bool may_move) noexcept {
+  void *result =
+      ::mremap(ptr, old_size, new_size, may_move ? MREMAP_MAYMOVE : 0);
+  return result == MAP_FAILED ? nullptr : result;
+}
+
+namespace {
+
+// From <linux/mempolicy.h>; called through syscall() so there is no
+// dependency on libnuma
+constexpr int MPOL_DEFAULT_MODE = 0;
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_BIND_MODE = 2;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+constexpr unsigned long MPOL_F_NODE_FLAG = 1UL << 0;
+constexpr unsigned long MPOL_F_ADDR_FLAG = 1UL << 1;
+
+constexpr size_t MAX_NUMA_NODES = 64;
+
+// Highest node in /sys/devices/system/node/online ("0", "0-1", "0,2-3") + 1
+size_t read_node_count() noexcept {
+  std::FILE *file = std::fopen("/sys/devices/system/node/online", "r");
+  if (!file)
+    return 1;
+  char line[256] = {};
+  bool ok = std::fgets(line, sizeof(line), file) != nullptr;
+  std::fclose(file);
+  if (!ok)
+    return 1;
+
+  size_t highest = 0;
+  for (char *cursor = line; *cursor;) {
+    char *end = nullptr;
+    unsigned long value = std::strtoul(cursor, &end, 10);
+    if (end == cursor) {
+      ++cursor;
+      continue;
+    }
+    if (value > highest)
+      highest = value;
+    cursor = end;
+  }
+  return highest + 1 < MAX_NUMA_NODES ? highest + 1 : MAX_NUMA_NODES;
+}
+
+} // namespace
+
+size_t numa_node_count() noexcept {
+  static const size_t count = read_node_count();
+  return count;
+}
+
+int current_numa_node() noexcept {
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (::getcpu(&cpu, &node) != 0 || node >= numa_node_count())
+    return 0;
+  return static_cast<int>(node);
+}
+
+bool set_numa_policy(void *ptr, size_t size, NumaPolicy policy,
+                     int node) noexcept {
+  unsigned long mask = 0;
+  int mode = MPOL_DEFAULT_MODE;
+  switch (policy) {
+  case NumaPolicy::first_touch:
+    break;
+  case NumaPolicy::bind:
+  case NumaPolicy::preferred:
+    if (node < 0 || static_cast<size_t>(node) >= numa_node_count())
+      return false;
+    mode = policy == NumaPolicy::bind ? MPOL_BIND_MODE : MPOL_PREFERRED_MODE;
+    mask = 1UL << node;
+    break;
+  case NumaPolicy::interleave:
+    mode = MPOL_INTERLEAVE_MODE;
+    mask = numa_node_count() >= MAX_NUMA_NODES
+               ? ~0UL
+               : (1UL << numa_node_count()) - 1;
+    break;
+  }
+
+  // maxnode counts mask bits plus one, as libnuma passes it
+  unsigned long maxnode = mask ? MAX_NUMA_NODES + 1 : 0;
+  return ::syscall(SYS_mbind, ptr, size, mode, mask ? &mask : nullptr,
+                   maxnode, 0) == 0;
+}
+
+int numa_node_of(const void *ptr) noexcept {
+  int node = -1;
+  if (::syscall(SYS_get_mempolicy, &node, nullptr, 0, ptr,
+                MPOL_F_NODE_FLAG | MPOL_F_ADDR_FLAG) != 0)
+    return -1;
+  return node;
+}
+
+} // namespace os
+} // namespace allocx
@@ -0,0 +1,172 @@
+#include "allocx/persistent_arena.hpp"
+#include "allocx/os_memory.hpp"
+#include "allocx/utils.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace allocx {
+
+namespace {
+
+constexpr uint64_t PERSISTENT_ARENA_MAGIC = 0x414e455241584c41ULL; // "ALXARENA"
+constexpr uint32_t PERSISTENT_ARENA_VERSION = 1;
+constexpr size_t DATA_OFFSET = 64; // Header, padded to a cache line
+
+} // namespace
+
+// File header; everything else in the file is arena data
+struct PersistentArena::Header {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t size;        // File size when created
+  uint64_t data_offset; // Start of the StackAllocator region
+  uint64_t used;        // Allocation top at the last checkpoint
+  uint64_t root;        // Root offset at the last checkpoint
+  uint64_t checkpoints; // Checkpoints taken
+};
+
+std::unique_ptr<PersistentArena> PersistentArena::create(const char *path,
+                                                         size_t capacity) {
+  static_assert(sizeof(Header) <= DATA_OFFSET,
+                "Header must fit before the data region");
+  capacity = utils::align_up(capacity, os::page_size());
+  if (capacity <= DATA_OFFSET)
+    return nullptr;
+
+  int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return nullptr;
+
+  // The file is sparse until objects are written
+  void *mapping = nullptr;
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) == 0)
+    mapping = os::map_shared(fd, capacity);
+  if (!mapping) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  Header *header = static_cast<Header *>(mapping);
+  header->version = PERSISTENT_ARENA_VERSION;
+  header->size = capacity;
+  header->data_offset = DATA_OFFSET;
+  header->used = 0;
+  header->root = null_offset;
+  header->checkpoints = 0;
+  header->magic = PERSISTENT_ARENA_MAGIC;
+
+  return std::unique_ptr<PersistentArena>(
+      new PersistentArena(fd, mapping, capacity));
+}
+
+std::unique_ptr<PersistentArena> PersistentArena::open(const char *path) {
+  int fd = ::open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) <= DATA_OFFSET) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  // Only the header page is read here; the rest faults in on use
+  size_t size = static_cast<size_t>(st.st_size);
+  void *mapping = os::map_shared(fd, size);
+  if (!mapping) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  const Header *header = static_cast<const Header *>(mapping);
+  if (header->magic != PERSISTENT_ARENA_MAGIC ||
+      header->version != PERSISTENT_ARENA_VERSION || header->size != size ||
+      header->data_offset != DATA_OFFSET ||
+      header->used > size - DATA_OFFSET || header->root >= size) {
+    os::unmap(mapping, size);
+    ::close(fd);
+    return nullptr;
+  }
+
+  return std::unique_ptr<PersistentArena>(
+      new PersistentArena(fd, mapping, size));
+}
+
+PersistentArena::PersistentArena(int fd, void *mapping, size_t size)
+    : m_header(static_cast<Header *>(mapping)), m_size(size), m_fd(fd),
+      m_stack(static_cast<char *>(mapping) + DATA_OFFSET, size - DATA_OFFSET),
+      m_root(m_header->root) {
+  restore();
+}
+
+PersistentArena::~PersistentArena() {
+  os::unmap(m_header, m_size);
+  ::close(m_fd);
+}
+
+void *PersistentArena::allocate(size_t size, size_t alignment) {
+  return m_stack.allocate(size, alignment);
+}
+
+void PersistentArena::deallocate(void * /*ptr*/, size_t /*size*/) {
+  // Use reset() or restore() instead
+}
+
+bool PersistentArena::try_expand(void *ptr, size_t new_size) {
+  return m_stack.try_expand(ptr, new_size);
+}
+
+void PersistentArena::reset() {
+  m_stack.reset();
+  m_root = null_offset;
+}
+
+bool PersistentArena::owns(void *ptr) const { return m_stack.owns(ptr); }
+
+size_t PersistentArena::total_size() const { return m_stack.total_size(); }
+
+size_t PersistentArena::used_size() const { return m_stack.used_size(); }
+
+bool PersistentArena::checkpoint() {
+  // Objects first, so the header never covers unwritten data
+  if (!os::flush(m_header, m_size))
+    return false;
+  m_header->used = m_stack.used_size();
+  m_header->root = m_root;
+  ++m_header->checkpoints;
+  return os::flush(m_header, os::page_size());
+}
+
+void PersistentArena::restore() {
+  // StackAllocator only rolls back, so re-reserve the checkpointed bytes.
+  // The last byte is reserved separately so try_expand() on the first
+  // object cannot resize the reservation over the others.
+  m_stack.reset();
+  if (m_header->used > 1)
+    m_stack.allocate(m_header->used - 1, 1);
+  if (m_header->used > 0)
+    m_stack.allocate(1, 1);
+  m_root = m_header->root;
+}
+
+PersistentArena::offset_type
+PersistentArena::offset_of(const void *ptr) const noexcept {
+  if (ptr == nullptr)
+    return null_offset;
+  return static_cast<offset_type>(utils::ptr_diff(ptr, m_header));
+}
+
+void *PersistentArena::from_offset(offset_type offset) const noexcept {
+  if (offset < DATA_OFFSET || offset >= m_size)
+    return nullptr;
+  return reinterpret_cast<char *>(m_header) + offset;
+}
+
+uint64_t PersistentArena::checkpoint_count() const noexcept {
+  return m_header->checkpoints;
+}
+
+} // namespace allocx
@@ -1,4 +1,5 @@
 #include "allocx/pool_allocator.hpp"
+#include "allocx/os_memory.hpp"
 #include <new>
 #include <cassert>
 #include <utility>
@@ -6,8 +7,10 @@
 
 namespace allocx {
 
-PoolAllocator::PoolAllocator(size_t chunk_size, size_t chunk_count, size_t alignment)
-    : m_memory(nullptr)
+PoolAllocator::PoolAllocator(size_t chunk_size, size_t chunk_count, size_t alignment,
+                             const PoolOptions& options)
+    : m_block(nullptr)
+    , m_memory(nullptr)
     , m_memory_size(0)
     , m_chunk_size(0)
     , m_chunk_count(chunk_count)
@@ -15,24 +18,35 @@ PoolAllocator::PoolAllocator(size_t chunk_size, size_t chunk_count, size_t align
     , m_alignment(alignment)
     , m_free_list(nullptr)
     , m_owns_memory(true)
+    , m_track_occupancy(options.track_occupancy)
+    , m_prefetch(options.prefetch)
+    , m_address_ordered(options.address_ordered)
+    , m_trimmable(options.trimmable)
+    , m_locked(false)
+    , m_page_base(nullptr)
+    , m_page_shift(0)
+    , m_trim_cursor(0)
+    , m_span_chunks(0)
+    , m_partial_mask(0)
+    , m_empty(NO_SPAN)
+    , m_released(NO_SPAN)
 {
-    // Ensure chunk size is at least sizeof(void*) for intrusive list
-    // and properly aligned
-    m_chunk_size = std::max(chunk_size, sizeof(void*));
-    m_chunk_size = utils::align_up(m_chunk_size, alignment);
-    
+    init_chunk_size(chunk_size, options);
     m_memory_size = m_chunk_size * chunk_count;
     
     if (m_memory_size > 0) {
-        // Allocate aligned memory
-        m_memory = ::operator new(m_memory_size + alignment);
-        m_memory = utils::align_pointer(m_memory, alignment);
+        // Over-allocate and align; the original pointer is kept for delete
+        m_block = ::operator new(m_memory_size + m_alignment);
+        m_memory = utils::align_pointer(m_block, m_alignment);
+        apply_memory_options(options);
         init_free_list();
     }
 }
 
-PoolAllocator::PoolAllocator(void* buffer, size_t buffer_size, size_t chunk_size, size_t alignment)
-    : m_memory(nullptr)
+PoolAllocator::PoolAllocator(void* buffer, size_t buffer_size, size_t chunk_size, size_t alignment,
+                             const PoolOptions& options)
+    : m_block(nullptr)
+    , m_memory(nullptr)
     , m_memory_size(0)
     , m_chunk_size(0)
     , m_chunk_count(0)
@@ -40,37 +54,50 @@ PoolAllocator::PoolAllocator(void* buffer, size_t buffer_size, size_t chunk_size
     , m_alignment(alignment)
     , m_free_list(nullptr)
     , m_owns_memory(false)
+    , m_track_occupancy(options.track_occupancy)
+    , m_prefetch(options.prefetch)
+    , m_address_ordered(options.address_ordered)
+    , m_trimmable(options.trimmable)
+    , m_locked(false)
+    , m_page_base(nullptr)
+    , m_page_shift(0)
+    , m_trim_cursor(0)
+    , m_span_chunks(0)
+    , m_partial_mask(0)
+    , m_empty(NO_SPAN)
+    , m_released(NO_SPAN)
 {
     assert(buffer != nullptr || buffer_size == 0);
     
+    init_chunk_size(chunk_size, options);
+
     // Align the buffer
-    m_memory = utils::align_pointer(buffer, alignment);
+    m_memory = utils::align_pointer(buffer, m_alignment);
     size_t offset = static_cast<char*>(m_memory) - static_cast<char*>(buffer);
-    m_memory_size = buffer_size - offset;
-    
-    // Ensure chunk size is at least sizeof(void*) and aligned
-    m_chunk_size = std::max(chunk_size, sizeof(void*));
-    m_chunk_size = utils::align_up(m_chunk_size, alignment);
+    m_memory_size = offset < buffer_size ? buffer_size - offset : 0;
     
     // Calculate how many chunks fit
     m_chunk_count = m_memory_size / m_chunk_size;
     m_free_count = m_chunk_count;
     
     if (m_chunk_count > 0) {
+        apply_memory_options(options);
         init_free_list();
     }
 }
 
 PoolAllocator::~PoolAllocator() {
-    if (m_owns_memory && m_memory) {
-        // Need to recover original pointer for deletion
-        // This is simplified - actual implementation might need to store original
-        ::operator delete(m_memory);
+    if (m_locked) {
+        os::unlock(m_memory, m_memory_size);
+    }
+    if (m_owns_memory && m_block) {
+        ::operator delete(m_block);
     }
 }
 
 PoolAllocator::PoolAllocator(PoolAllocator&& other) noexcept
-    : m_memory(other.m_memory)
+    : m_block(other.m_block)
+    , m_memory(other.m_memory)
     , m_memory_size(other.m_memory_size)
     , m_chunk_size(other.m_chunk_size)
     , m_chunk_count(other.m_chunk_count)
@@ -78,21 +105,47 @@ PoolAllocator::PoolAllocator(PoolAllocator&& other) noexcept
     , m_alignment(other.m_alignment)
     , m_free_list(other.m_free_list)
     , m_owns_memory(other.m_owns_memory)
+    , m_track_occupancy(other.m_track_occupancy)
+    , m_prefetch(other.m_prefetch)
+    , m_address_ordered(other.m_address_ordered)
+    , m_trimmable(other.m_trimmable)
+    , m_locked(other.m_locked)
+    , m_occupied(std::move(other.m_occupied))
+    , m_page_base(other.m_page_base)
+    , m_page_shift(other.m_page_shift)
+    , m_pages(std::move(other.m_pages))
+    , m_parked(std::move(other.m_parked))
+    , m_trim_cursor(other.m_trim_cursor)
+    , m_span_chunks(other.m_span_chunks)
+    , m_spans(std::move(other.m_spans))
+    , m_partial(std::move(other.m_partial))
+    , m_partial_mask(other.m_partial_mask)
+    , m_empty(other.m_empty)
+    , m_released(other.m_released)
 {
+    other.m_block = nullptr;
     other.m_memory = nullptr;
     other.m_memory_size = 0;
     other.m_chunk_count = 0;
     other.m_free_count = 0;
     other.m_free_list = nullptr;
     other.m_owns_memory = false;
+    other.m_locked = false;
+    other.m_partial_mask = 0;
+    other.m_empty = NO_SPAN;
+    other.m_released = NO_SPAN;
 }
 
 PoolAllocator& PoolAllocator::operator=(PoolAllocator&& other) noexcept {
     if (this != &other) {
-        if (m_owns_memory && m_memory) {
-            ::operator delete(m_memory);
+        if (m_locked) {
+            os::unlock(m_memory, m_memory_size);
+        }
+        if (m_owns_memory && m_block) {
+            ::operator delete(m_block);
         }
         
+        m_block = other.m_block;
         m_memory = other.m_memory;
         m_memory_size = other.m_memory_size;
         m_chunk_size = other.m_chunk_size;
@@ -101,48 +154,154 @@ PoolAllocator& PoolAllocator::operator=(PoolAllocator&& other) noexcept {
         m_alignment = other.m_alignment;
         m_free_list = other.m_free_list;
         m_owns_memory = other.m_owns_memory;
+        m_track_occupancy = other.m_track_occupancy;
+        m_prefetch = other.m_prefetch;
+        m_address_ordered = other.m_address_ordered;
+        m_trimmable = other.m_trimmable;
+        m_locked = other.m_locked;
+        m_occupied = std::move(other.m_occupied);
+        m_page_base = other.m_page_base;
+        m_page_shift = other.m_page_shift;
+        m_pages = std::move(other.m_pages);
+        m_parked = std::move(other.m_parked);
+        m_trim_cursor = other.m_trim_cursor;
+        m_span_chunks = other.m_span_chunks;
+        m_spans = std::move(other.m_spans);
+        m_partial = std::move(other.m_partial);
+        m_partial_mask = other.m_partial_mask;
+        m_empty = other.m_empty;
+        m_released = other.m_released;
         
+        other.m_block = nullptr;
         other.m_memory = nullptr;
         other.m_memory_size = 0;
         other.m_chunk_count = 0;
         other.m_free_count = 0;
         other.m_free_list = nullptr;
         other.m_owns_memory = false;
+        other.m_locked = false;
+        other.m_partial_mask = 0;
+        other.m_empty = NO_SPAN;
+        other.m_released = NO_SPAN;
     }
     return *this;
 }
 
+void PoolAllocator::init_chunk_size(size_t chunk_size, const PoolOptions& options) {
+    if (options.cache_line_padding) {
+        m_alignment = std::max(m_alignment, utils::CACHE_LINE_SIZE);
+    }
+    // Ensure chunk size is at least sizeof(void*) for intrusive list
+    // and properly aligned
+    m_chunk_size = std::max(chunk_size, sizeof(void*));
+    m_chunk_size = utils::align_up(m_chunk_size, m_alignment);
+}
+
+void PoolAllocator::apply_memory_options(const PoolOptions& options) {
+    if (options.lock_memory) {
+        m_locked = os::lock(m_memory, m_memory_size);
+    }
+    if (options.prefault && !m_locked) {
+        prefault();  // mlock has already faulted everything in
+    }
+}
+
+void PoolAllocator::prefault() const noexcept {
+    os::prefault(m_memory, m_memory_size);
+}
+
+bool PoolAllocator::locked() const noexcept {
+    return m_locked;
+}
+
 void PoolAllocator::init_free_list() {
-    // Build intrusive linked list through chunks
-    char* chunk = static_cast<char*>(m_memory);
-    m_free_list = chunk;
-    
-    for (size_t i = 0; i < m_chunk_count - 1; ++i) {
-        void** current = reinterpret_cast<void**>(chunk);
-        chunk += m_chunk_size;
-        *current = chunk;  // Point to next chunk
+    if (m_address_ordered) {
+        init_spans();
+    } else {
+        // Build intrusive linked list through chunks
+        char* chunk = static_cast<char*>(m_memory);
+        m_free_list = chunk;
+
+        for (size_t i = 0; i < m_chunk_count - 1; ++i) {
+            void** current = reinterpret_cast<void**>(chunk);
+            chunk += m_chunk_size;
+            *current = chunk;  // Point to next chunk
+        }
+
+        // Last chunk points to null
+        void** last = reinterpret_cast<void**>(chunk);
+        *last = nullptr;
     }
-    
-    // Last chunk points to null
-    void** last = reinterpret_cast<void**>(chunk);
-    *last = nullptr;
-    
+
+    if (!m_address_ordered && m_trimmable) {
+        // Every page starts out resident with all its chunks free
+        char* end = static_cast<char*>(m_memory) + m_chunk_count * m_chunk_size;
+        const size_t page = os::page_size();
+        m_page_shift = static_cast<size_t>(__builtin_ctzll(page));
+        m_page_base = reinterpret_cast<char*>(
+            reinterpret_cast<uintptr_t>(m_memory) & ~(uintptr_t(page) - 1));
+        m_pages.assign(page_of(end - 1) + 1, PageState{0, 0, false});
+        for (size_t p = 0; p < m_pages.size(); ++p) {
+            m_pages[p].free = static_cast<uint32_t>(chunks_from(p + 1) - chunks_from(p));
+        }
+        m_parked.clear();
+    }
+
     m_free_count = m_chunk_count;
+    m_trim_cursor = 0;
+
+    if (m_track_occupancy) {
+        m_occupied.assign((m_chunk_count + 63) / 64, 0);
+    }
 }
 
 void* PoolAllocator::allocate(size_t /*size*/, size_t /*alignment*/) {
-    if (m_free_list == nullptr) {
+    if (m_address_ordered) {
+        return allocate_ordered();
+    }
+    if (m_free_list == nullptr && !refill()) {
         return nullptr;  // Pool exhausted
     }
     
     // Pop from free list
     void* ptr = m_free_list;
-    m_free_list = *static_cast<void**>(m_free_list);
+    if (m_trimmable && (ptr = take_counted()) == nullptr) {
+        return nullptr;
+    }
+    m_free_list = *static_cast<void**>(ptr);
     --m_free_count;
+
+    // After random frees the next head is usually a cache miss; start it
+    // now (for writing, as it will be handed out) rather than next call
+    if (m_prefetch && m_free_list != nullptr) {
+        __builtin_prefetch(m_free_list, 1, 3);
+    }
+
+    if (m_track_occupancy) {
+        size_t index = static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) / m_chunk_size;
+        m_occupied[index / 64] |= uint64_t(1) << (index % 64);
+    }
     
     return ptr;
 }
 
+void* PoolAllocator::take_counted() {
+    void* ptr = m_free_list;
+    PageState* page = &m_pages[page_of(ptr)];
+    while (page->parked != 0) {
+        const ParkedPage& parked = m_parked[page->parked - 1];
+        size_t index = static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) / m_chunk_size;
+        m_free_list = parked.links[index - parked.first];
+        if (m_free_list == nullptr && !refill()) {
+            return nullptr;
+        }
+        ptr = m_free_list;
+        page = &m_pages[page_of(ptr)];
+    }
+    --page->free;
+    return ptr;
+}
+
 void PoolAllocator::deallocate(void* ptr, size_t /*size*/) {
     if (ptr == nullptr) return;
     
@@ -150,12 +309,38 @@ void PoolAllocator::deallocate(void* ptr, size_t /*size*/) {
     assert(owns(ptr) && "Pointer does not belong to this pool");
 #endif
     
+    if (m_track_occupancy) {
+        size_t index = static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) / m_chunk_size;
+        m_occupied[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+
+    if (m_address_ordered) {
+        deallocate_ordered(ptr);
+        return;
+    }
+
     // Push to free list
     *static_cast<void**>(ptr) = m_free_list;
     m_free_list = ptr;
+    if (m_trimmable) {
+        ++m_pages[page_of(ptr)].free;
+    }
     ++m_free_count;
 }
 
+bool PoolAllocator::try_expand(void* ptr, size_t new_size) {
+    return owns(ptr) && new_size <= m_chunk_size;
+}
+
+void* PoolAllocator::reallocate(void* ptr, size_t /*old_size*/, size_t new_size,
+                                size_t /*alignment*/) {
+    // Every chunk has the same size, so moving can never help
+    if (new_size > m_chunk_size) {
+        return nullptr;
+    }
+    return ptr ? ptr : allocate();
+}
+
 void PoolAllocator::reset() {
     if (m_chunk_count > 0) {
         init_free_list();
@@ -196,4 +381,345 @@ size_t PoolAllocator::free_count() const noexcept {
     return m_free_count;
 }
 
+size_t PoolAllocator::trim(size_t max_bytes, bool lazy) {
+    if (m_locked || m_free_count == 0 || max_bytes == 0) {
+        return 0;
+    }
+    if (m_address_ordered) {
+        return trim_ordered(max_bytes, lazy);
+    }
+    if (!m_trimmable) {
+        return 0;
+    }
+
+    // Only pages [first, last) lie entirely inside the chunk array
+    const size_t page = os::page_size();
+    const uintptr_t page_base = reinterpret_cast<uintptr_t>(m_page_base);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_memory);
+    size_t first = static_cast<size_t>(base - page_base + page - 1) >> m_page_shift;
+    size_t last = static_cast<size_t>(base + m_chunk_count * m_chunk_size - page_base) >>
+                  m_page_shift;
+    if (last <= first) {
+        return 0;
+    }
+    if (m_trim_cursor <= first || m_trim_cursor > last) {
+        m_trim_cursor = last;
+    }
+
+    // Every chunk touching the page must be free: the one covering its
+    // start (which may belong to a lower page) and those belonging to it
+    auto releasable = [&](size_t p) {
+        return !m_pages[p].released && page_free(p) && page_free(owner_page(p));
+    };
+
+    // Park everything touching pages [begin, end) and release them
+    auto release = [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            park(owner_page(p));
+            park(p);
+        }
+        size_t bytes = os::decommit(m_page_base + (begin << m_page_shift),
+                                    (end - begin) << m_page_shift, lazy);
+        if (bytes != 0) {
+            for (size_t p = begin; p < end; ++p) {
+                m_pages[p].released = true;
+            }
+        }
+        return bytes;
+    };
+
+    // Runs of releasable pages, moving down from the cursor; a run never
+    // wraps
+    size_t limit = std::min(trim_scan_limit(max_bytes, page), last - first);
+    size_t planned = 0;
+    size_t released = 0;
+    size_t run_end = 0;  // End of the run being gathered, 0 if none
+    for (size_t scanned = 0; scanned < limit && planned < max_bytes; ++scanned) {
+        size_t p = --m_trim_cursor;
+        if (releasable(p)) {
+            if (run_end == 0) {
+                run_end = p + 1;
+            }
+            planned += page;
+        } else if (run_end != 0) {
+            released += release(p + 1, run_end);
+            run_end = 0;
+        }
+        if (m_trim_cursor == first) {
+            if (run_end != 0) {
+                released += release(first, run_end);
+                run_end = 0;
+            }
+            m_trim_cursor = last;
+        }
+    }
+    if (run_end != 0) {
+        released += release(m_trim_cursor, run_end);
+    }
+    return released;
+}
+
+size_t PoolAllocator::trim_scan_limit(size_t max_bytes, size_t unit) noexcept {
+    size_t units = max_bytes / unit;
+    if (units > (SIZE_MAX - TRIM_SCAN_MIN) / TRIM_SCAN_PER_PAGE) {
+        return SIZE_MAX;
+    }
+    return units * TRIM_SCAN_PER_PAGE + TRIM_SCAN_MIN;
+}
+
+size_t PoolAllocator::chunks_from(size_t page) const noexcept {
+    const char* start = m_page_base + (page << m_page_shift);
+    const char* base = static_cast<const char*>(m_memory);
+    if (start <= base) {
+        return 0;
+    }
+    size_t index = (static_cast<size_t>(start - base) + m_chunk_size - 1) / m_chunk_size;
+    return std::min(index, m_chunk_count);
+}
+
+bool PoolAllocator::page_free(size_t page) const noexcept {
+    // Parked chunks were never handed out, so they still count as free
+    return m_pages[page].free == chunks_from(page + 1) - chunks_from(page);
+}
+
+size_t PoolAllocator::owner_page(size_t page) const noexcept {
+    size_t offset = static_cast<size_t>(m_page_base + (page << m_page_shift) -
+                                        static_cast<char*>(m_memory));
+    return page_of(static_cast<char*>(m_memory) + offset / m_chunk_size * m_chunk_size);
+}
+
+void PoolAllocator::park(size_t page) {
+    size_t first = chunks_from(page);
+    size_t end = chunks_from(page + 1);
+    if (m_pages[page].parked != 0 || first == end) {
+        return;
+    }
+
+    // The chunks stay on the free list until allocate() meets them, by
+    // which time their memory may read back as zeroes
+    ParkedPage parked{page, first, std::vector<void*>(end - first)};
+    char* base = static_cast<char*>(m_memory);
+    for (size_t i = first; i < end; ++i) {
+        parked.links[i - first] = *reinterpret_cast<void**>(base + i * m_chunk_size);
+    }
+    m_parked.push_back(std::move(parked));
+    m_pages[page].parked = static_cast<uint32_t>(m_parked.size());
+}
+
+bool PoolAllocator::refill() {
+    char* base = static_cast<char*>(m_memory);
+    while (!m_parked.empty()) {
+        // The free list is empty, so allocate() has stepped over every
+        // parked chunk and none is linked any more
+        ParkedPage parked = std::move(m_parked.back());
+        m_parked.pop_back();
+        m_pages[parked.page].parked = 0;
+
+        // Push the page's chunks so the lowest is handed out first
+        size_t end = parked.first + parked.links.size();
+        for (size_t i = end; i-- > parked.first;) {
+            void* chunk = base + i * m_chunk_size;
+            *static_cast<void**>(chunk) = m_free_list;
+            m_free_list = chunk;
+        }
+
+        // Those chunks will be written, so the pages they cover no longer
+        // count as released
+        size_t last = page_of(base + end * m_chunk_size - 1);
+        for (size_t p = parked.page; p <= last; ++p) {
+            m_pages[p].released = false;
+        }
+        if (m_free_list != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PoolAllocator::tracks_occupancy() const noexcept {
+    return m_track_occupancy;
+}
+
+bool PoolAllocator::address_ordered() const noexcept {
+    return m_address_ordered;
+}
+
+void PoolAllocator::init_spans() {
+    // About a page per span, capped by the width of the free mask
+    m_span_chunks = std::min<size_t>(std::max<size_t>(os::page_size() / m_chunk_size, 1), 64);
+    size_t count = (m_chunk_count + m_span_chunks - 1) / m_span_chunks;
+
+    // reset() writes nothing to the chunks, so released spans stay released
+    bool keep_released = m_spans.size() == count;
+    m_spans.resize(count);
+    m_partial.assign(m_span_chunks, NO_SPAN);
+    m_partial_mask = 0;
+    m_empty = NO_SPAN;
+    m_released = NO_SPAN;
+
+    // Link from the top so the lowest span heads its list
+    for (size_t i = count; i-- > 0;) {
+        Span& span = m_spans[i];
+        span.chunks = static_cast<uint32_t>(
+            std::min(m_span_chunks, m_chunk_count - i * m_span_chunks));
+        span.free = span.chunks;
+        span.free_mask = span.chunks == 64 ? ~uint64_t(0)
+                                           : (uint64_t(1) << span.chunks) - 1;
+        span.released = keep_released && span.released;
+        link_span(i);
+    }
+}
+
+size_t* PoolAllocator::span_list(const Span& span) {
+    if (span.free == 0) {
+        return nullptr;  // Full spans are not listed
+    }
+    if (span.free == span.chunks) {
+        return span.released ? &m_released : &m_empty;
+    }
+    return &m_partial[span.free];
+}
+
+void PoolAllocator::link_span(size_t index) {
+    Span& span = m_spans[index];
+    span.prev = NO_SPAN;
+    span.next = NO_SPAN;
+    size_t* head = span_list(span);
+    if (head == nullptr) {
+        return;
+    }
+    span.next = *head;
+    if (*head != NO_SPAN) {
+        m_spans[*head].prev = index;
+    }
+    *head = index;
+    if (span.free != span.chunks) {
+        m_partial_mask |= uint64_t(1) << span.free;
+    }
+}
+
+void PoolAllocator::unlink_span(size_t index) {
+    Span& span = m_spans[index];
+    size_t* head = span_list(span);
+    if (head == nullptr) {
+        return;
+    }
+    if (span.prev != NO_SPAN) {
+        m_spans[span.prev].next = span.next;
+    } else {
+        *head = span.next;
+    }
+    if (span.next != NO_SPAN) {
+        m_spans[span.next].prev = span.prev;
+    }
+    if (span.free != span.chunks && *head == NO_SPAN) {
+        m_partial_mask &= ~(uint64_t(1) << span.free);
+    }
+}
+
+void* PoolAllocator::allocate_ordered() {
+    // Fullest partly used span first, then resident empty ones, and
+    // released ones only when nothing else is left
+    size_t index;
+    if (m_partial_mask != 0) {
+        index = m_partial[static_cast<size_t>(__builtin_ctzll(m_partial_mask))];
+    } else if (m_empty != NO_SPAN) {
+        index = m_empty;
+    } else if (m_released != NO_SPAN) {
+        index = m_released;
+    } else {
+        return nullptr;  // Pool exhausted
+    }
+
+    Span& span = m_spans[index];
+    unlink_span(index);
+    size_t bit = static_cast<size_t>(__builtin_ctzll(span.free_mask));
+    span.free_mask &= span.free_mask - 1;
+    --span.free;
+    span.released = false;
+    link_span(index);
+    --m_free_count;
+
+    size_t chunk = index * m_span_chunks + bit;
+    if (m_track_occupancy) {
+        m_occupied[chunk / 64] |= uint64_t(1) << (chunk % 64);
+    }
+    return static_cast<char*>(m_memory) + chunk * m_chunk_size;
+}
+
+void PoolAllocator::deallocate_ordered(void* ptr) {
+    size_t chunk = static_cast<size_t>(utils::ptr_diff(ptr, m_memory)) / m_chunk_size;
+    size_t index = chunk / m_span_chunks;
+    uint64_t bit = uint64_t(1) << (chunk % m_span_chunks);
+    Span& span = m_spans[index];
+
+#ifdef DEBUG
+    assert((span.free_mask & bit) == 0 && "Chunk is already free");
+#endif
+
+    unlink_span(index);
+    span.free_mask |= bit;
+    ++span.free;
+    link_span(index);
+    ++m_free_count;
+}
+
+size_t PoolAllocator::trim_ordered(size_t max_bytes, bool lazy) {
+    char* base = static_cast<char*>(m_memory);
+    const size_t span_bytes = m_span_chunks * m_chunk_size;
+    const size_t count = m_spans.size();
+    if (m_trim_cursor == 0 || m_trim_cursor > count) {
+        m_trim_cursor = count;
+    }
+    auto releasable = [&](size_t index) {
+        const Span& span = m_spans[index];
+        return span.free == span.chunks && !span.released;
+    };
+
+    // Spans are smaller than a page for small chunks, so single spans may
+    // release nothing while a run of them does
+    auto release = [&](size_t begin, size_t end) {
+        char* first = base + begin * span_bytes;
+        char* last = base + (end - 1) * span_bytes + m_spans[end - 1].chunks * m_chunk_size;
+        size_t bytes = os::decommit(first, static_cast<size_t>(last - first), lazy);
+        if (bytes != 0) {
+            for (size_t index = begin; index < end; ++index) {
+                unlink_span(index);
+                m_spans[index].released = true;
+                link_span(index);
+            }
+        }
+        return bytes;
+    };
+
+    // Runs of wholly free, resident spans, moving down from the cursor
+    size_t limit = std::min(trim_scan_limit(max_bytes, span_bytes), count);
+    size_t planned = 0;
+    size_t released = 0;
+    size_t run_end = 0;  // End of the run being gathered, 0 if none
+    for (size_t scanned = 0; scanned < limit && planned < max_bytes; ++scanned) {
+        size_t i = --m_trim_cursor;
+        if (releasable(i)) {
+            if (run_end == 0) {
+                run_end = i + 1;
+            }
+            planned += m_spans[i].chunks * m_chunk_size;
+        } else if (run_end != 0) {
+            released += release(i + 1, run_end);
+            run_end = 0;
+        }
+        if (m_trim_cursor == 0) {
+            if (run_end != 0) {
+                released += release(0, run_end);
+                run_end = 0;
+            }
+            m_trim_cursor = count;
+        }
+    }
+    if (run_end != 0) {
+        released += release(m_trim_cursor, run_end);
+    }
+    return released;
+}
+
 } // namespace allocx
@@ -0,0 +1,280 @@
+#include "allocx/shared_pool_allocator.hpp"
+#include "allocx/os_memory.hpp"
+#include "allocx/utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace allocx {
+
+// Cross-process atomics must not fall back to a process-local lock
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "SharedPoolAllocator requires lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "SharedPoolAllocator requires lock-free 32-bit atomics");
+
+namespace {
+
+constexpr uint64_t SHARED_POOL_MAGIC = 0x4c4f4f5058434c41ULL; // "ALCXPOOL"
+constexpr uint32_t SHARED_POOL_VERSION = 1;
+constexpr size_t CACHE_LINE = 64;
+
+// Free-list head: ABA tag in the high half, chunk index + 1 in the low
+// half (0 = empty)
+inline uint64_t pack_head(uint32_t tag, uint32_t index) {
+  return (static_cast<uint64_t>(tag) << 32) | index;
+}
+inline uint32_t head_tag(uint64_t head) {
+  return static_cast<uint32_t>(head >> 32);
+}
+inline uint32_t head_index(uint64_t head) {
+  return static_cast<uint32_t>(head);
+}
+
+} // namespace
+
+// Layout at the start of the region; followed by the link array, then
+// the chunks. Only offsets are stored.
+struct SharedPoolAllocator::Header {
+  std::atomic<uint64_t> magic; // Published last, once the pool is usable
+  uint32_t version;
+  uint32_t chunk_count;
+  uint64_t chunk_size;
+  uint64_t links_offset; // std::atomic<uint32_t>[chunk_count]
+  uint64_t chunks_offset;
+  uint64_t region_size;
+
+  alignas(CACHE_LINE) std::atomic<uint64_t> head;
+  // Adjusted after the head CAS succeeds, so a pop can be counted before
+  // the push it took the chunk from: briefly out of range, even negative
+  alignas(CACHE_LINE) std::atomic<int64_t> free_count;
+
+  std::atomic<uint32_t> *links() {
+    return reinterpret_cast<std::atomic<uint32_t> *>(
+        reinterpret_cast<char *>(this) + links_offset);
+  }
+
+  // Link every chunk into the free list in address order
+  void init_free_list() {
+    std::atomic<uint32_t> *link = links();
+    for (uint32_t i = 0; i < chunk_count; ++i) {
+      link[i].store(i + 2 <= chunk_count ? i + 2 : 0,
+                    std::memory_order_relaxed);
+    }
+    uint32_t tag = head_tag(head.load(std::memory_order_relaxed)) + 1;
+    free_count.store(chunk_count, std::memory_order_relaxed);
+    head.store(pack_head(tag, 1), std::memory_order_release);
+  }
+};
+
+std::unique_ptr<SharedPoolAllocator>
+SharedPoolAllocator::create(size_t chunk_size, size_t chunk_count,
+                            const char *name, size_t alignment) {
+  if (chunk_count == 0 || chunk_count >= UINT32_MAX ||
+      !utils::is_power_of_two(alignment) || alignment > os::page_size())
+    return nullptr;
+
+  chunk_size = utils::align_up(std::max<size_t>(chunk_size, 1), alignment);
+  size_t links_offset = utils::align_up(sizeof(Header), CACHE_LINE);
+  size_t chunks_offset = utils::align_up(
+      links_offset + chunk_count * sizeof(std::atomic<uint32_t>),
+      std::max(alignment, CACHE_LINE));
+  if (chunk_size > (SIZE_MAX - chunks_offset) / chunk_count)
+    return nullptr;
+  size_t region_size = utils::align_up(chunks_offset + chunk_size * chunk_count,
+                                       os::page_size());
+
+  int fd = name ? ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600)
+                : ::memfd_create("allocx_shared_pool", MFD_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  void *region = nullptr;
+  if (::ftruncate(fd, static_cast<off_t>(region_size)) == 0)
+    region = os::map_shared(fd, region_size);
+  if (!region) {
+    ::close(fd);
+    if (name)
+      ::shm_unlink(name);
+    return nullptr;
+  }
+
+  Header *header = new (region) Header();
+  header->version = SHARED_POOL_VERSION;
+  header->chunk_count = static_cast<uint32_t>(chunk_count);
+  header->chunk_size = chunk_size;
+  header->links_offset = links_offset;
+  header->chunks_offset = chunks_offset;
+  header->region_size = region_size;
+  header->head.store(0, std::memory_order_relaxed);
+  header->init_free_list();
+  header->magic.store(SHARED_POOL_MAGIC, std::memory_order_release);
+
+  return std::unique_ptr<SharedPoolAllocator>(
+      new SharedPoolAllocator(fd, region, region_size));
+}
+
+std::unique_ptr<SharedPoolAllocator> SharedPoolAllocator::attach(int fd) {
+  int own_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (own_fd < 0)
+    return nullptr;
+  return map_existing(own_fd);
+}
+
+std::unique_ptr<SharedPoolAllocator>
+SharedPoolAllocator::open(const char *name) {
+  int fd = ::shm_open(name, O_RDWR, 0);
+  if (fd < 0)
+    return nullptr;
+  return map_existing(fd);
+}
+
+bool SharedPoolAllocator::unlink(const char *name) {
+  return ::shm_unlink(name) == 0;
+}
+
+std::unique_ptr<SharedPoolAllocator>
+SharedPoolAllocator::map_existing(int fd) {
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  size_t region_size = static_cast<size_t>(st.st_size);
+  void *region = os::map_shared(fd, region_size);
+  if (!region) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  // Reject foreign files and pools still being initialized
+  const Header *header = static_cast<const Header *>(region);
+  if (header->magic.load(std::memory_order_acquire) != SHARED_POOL_MAGIC ||
+      header->version != SHARED_POOL_VERSION ||
+      header->region_size != region_size ||
+      header->chunks_offset +
+              header->chunk_size * uint64_t(header->chunk_count) >
+          region_size) {
+    os::unmap(region, region_size);
+    ::close(fd);
+    return nullptr;
+  }
+
+  return std::unique_ptr<SharedPoolAllocator>(
+      new SharedPoolAllocator(fd, region, region_size));
+}
+
+SharedPoolAllocator::SharedPoolAllocator(int fd, void *region,
+                                         size_t region_size)
+    : m_header(static_cast<Header *>(region)), m_region_size(region_size),
+      m_chunks(static_cast<char *>(region) + m_header->chunks_offset),
+      m_fd(fd) {}
+
+SharedPoolAllocator::~SharedPoolAllocator() {
+  os::unmap(m_header, m_region_size);
+  ::close(m_fd);
+}
+
+void *SharedPoolAllocator::allocate(size_t size, size_t alignment) {
+  if (size > m_header->chunk_size ||
+      (alignment && !utils::is_aligned(m_chunks, alignment)) ||
+      (alignment && m_header->chunk_size % alignment != 0))
+    return nullptr;
+
+  std::atomic<uint32_t> *links = m_header->links();
+  uint64_t head = m_header->head.load(std::memory_order_acquire);
+  for (;;) {
+    uint32_t index = head_index(head);
+    if (index == 0)
+      return nullptr; // Pool exhausted
+
+    // May read a stale link if another process pops first; the tag
+    // makes the CAS fail in that case
+    uint32_t next = links[index - 1].load(std::memory_order_relaxed);
+    if (m_header->head.compare_exchange_weak(
+            head, pack_head(head_tag(head) + 1, next),
+            std::memory_order_acquire, std::memory_order_acquire)) {
+      m_header->free_count.fetch_sub(1, std::memory_order_relaxed);
+      return m_chunks + size_t(index - 1) * m_header->chunk_size;
+    }
+  }
+}
+
+void SharedPoolAllocator::deallocate(void *ptr, size_t /*size*/) {
+  if (ptr == nullptr)
+    return;
+
+#ifdef DEBUG
+  assert(owns(ptr) && "Pointer does not belong to this pool");
+#endif
+
+  uint32_t index = static_cast<uint32_t>(
+      static_cast<size_t>(static_cast<char *>(ptr) - m_chunks) /
+          m_header->chunk_size +
+      1);
+  std::atomic<uint32_t> *links = m_header->links();
+  uint64_t head = m_header->head.load(std::memory_order_relaxed);
+  do {
+    links[index - 1].store(head_index(head), std::memory_order_relaxed);
+  } while (!m_header->head.compare_exchange_weak(
+      head, pack_head(head_tag(head) + 1, index), std::memory_order_release,
+      std::memory_order_relaxed));
+  m_header->free_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SharedPoolAllocator::try_expand(void *ptr, size_t new_size) {
+  return owns(ptr) && new_size <= m_header->chunk_size;
+}
+
+void SharedPoolAllocator::reset() { m_header->init_free_list(); }
+
+bool SharedPoolAllocator::owns(void *ptr) const {
+  const char *p = static_cast<const char *>(ptr);
+  return p >= m_chunks &&
+         p < m_chunks + m_header->chunk_size * m_header->chunk_count;
+}
+
+size_t SharedPoolAllocator::total_size() const {
+  return m_header->chunk_size * m_header->chunk_count;
+}
+
+size_t SharedPoolAllocator::used_size() const {
+  return (chunk_count() - free_count()) * m_header->chunk_size;
+}
+
+SharedPoolAllocator::offset_type
+SharedPoolAllocator::offset_of(const void *ptr) const noexcept {
+  if (ptr == nullptr)
+    return null_offset;
+  return static_cast<offset_type>(utils::ptr_diff(ptr, m_header));
+}
+
+void *SharedPoolAllocator::from_offset(offset_type offset) const noexcept {
+  if (offset < m_header->chunks_offset || offset >= m_region_size)
+    return nullptr;
+  return reinterpret_cast<char *>(m_header) + offset;
+}
+
+size_t SharedPoolAllocator::chunk_size() const noexcept {
+  return m_header->chunk_size;
+}
+
+size_t SharedPoolAllocator::chunk_count() const noexcept {
+  return m_header->chunk_count;
+}
+
+size_t SharedPoolAllocator::free_count() const noexcept {
+  int64_t count = m_header->free_count.load(std::memory_order_relaxed);
+  if (count < 0)
+    return 0;
+  return std::min(static_cast<size_t>(count), chunk_count());
+}
+
+} // namespace allocx
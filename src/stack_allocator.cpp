@@ -1,18 +1,29 @@
 #include "allocx/stack_allocator.hpp"
+#include "allocx/os_memory.hpp"
+#include <algorithm>
 #include <new>
 #include <cassert>
 #include <utility>
 
 namespace allocx {
 
-StackAllocator::StackAllocator(size_t size)
+StackAllocator::StackAllocator(size_t size, const StackOptions& options)
     : m_memory(nullptr)
     , m_size(size)
     , m_offset(0)
+    , m_last_offset(NO_ALLOCATION)
+    , m_high_water(size)
     , m_owns_memory(true)
+    , m_locked(false)
 {
     if (size > 0) {
         m_memory = ::operator new(size);
+        if (options.lock_memory) {
+            m_locked = os::lock(m_memory, m_size);
+        }
+        if (options.prefault && !m_locked) {
+            prefault();  // mlock has already faulted everything in
+        }
     }
 }
 
@@ -20,12 +31,18 @@ StackAllocator::StackAllocator(void* buffer, size_t size)
     : m_memory(buffer)
     , m_size(size)
     , m_offset(0)
+    , m_last_offset(NO_ALLOCATION)
+    , m_high_water(size)
     , m_owns_memory(false)
+    , m_locked(false)
 {
     assert(buffer != nullptr || size == 0);
 }
 
 StackAllocator::~StackAllocator() {
+    if (m_locked) {
+        os::unlock(m_memory, m_size);
+    }
     if (m_owns_memory && m_memory) {
         ::operator delete(m_memory);
     }
@@ -35,16 +52,24 @@ StackAllocator::StackAllocator(StackAllocator&& other) noexcept
     : m_memory(other.m_memory)
     , m_size(other.m_size)
     , m_offset(other.m_offset)
+    , m_last_offset(other.m_last_offset)
+    , m_high_water(other.m_high_water)
     , m_owns_memory(other.m_owns_memory)
+    , m_locked(other.m_locked)
 {
     other.m_memory = nullptr;
     other.m_size = 0;
     other.m_offset = 0;
+    other.m_high_water = 0;
     other.m_owns_memory = false;
+    other.m_locked = false;
 }
 
 StackAllocator& StackAllocator::operator=(StackAllocator&& other) noexcept {
     if (this != &other) {
+        if (m_locked) {
+            os::unlock(m_memory, m_size);
+        }
         if (m_owns_memory && m_memory) {
             ::operator delete(m_memory);
         }
@@ -52,12 +77,17 @@ StackAllocator& StackAllocator::operator=(StackAllocator&& other) noexcept {
         m_memory = other.m_memory;
         m_size = other.m_size;
         m_offset = other.m_offset;
+        m_last_offset = other.m_last_offset;
+        m_high_water = other.m_high_water;
         m_owns_memory = other.m_owns_memory;
+        m_locked = other.m_locked;
         
         other.m_memory = nullptr;
         other.m_size = 0;
         other.m_offset = 0;
+        other.m_high_water = 0;
         other.m_owns_memory = false;
+        other.m_locked = false;
     }
     return *this;
 }
@@ -80,6 +110,10 @@ void* StackAllocator::allocate(size_t size, size_t alignment) {
     
     // Update offset
     m_offset = aligned_offset + size;
+    m_last_offset = aligned_offset;
+    if (m_offset > m_high_water) {
+        m_high_water = m_offset;
+    }
     
     return ptr;
 }
@@ -89,8 +123,25 @@ void StackAllocator::deallocate(void* /*ptr*/, size_t /*size*/) {
     // Use rollback() or reset() instead
 }
 
+bool StackAllocator::try_expand(void* ptr, size_t new_size) {
+    if (m_last_offset == NO_ALLOCATION ||
+        ptr != static_cast<char*>(m_memory) + m_last_offset) {
+        return false;  // Not the top allocation
+    }
+    if (new_size == 0 || new_size > m_size - m_last_offset) {
+        return false;
+    }
+
+    m_offset = m_last_offset + new_size;
+    if (m_offset > m_high_water) {
+        m_high_water = m_offset;
+    }
+    return true;
+}
+
 void StackAllocator::reset() {
     m_offset = 0;
+    m_last_offset = NO_ALLOCATION;
 }
 
 StackAllocator::Marker StackAllocator::get_marker() const noexcept {
@@ -99,6 +150,9 @@ StackAllocator::Marker StackAllocator::get_marker() const noexcept {
 
 void StackAllocator::rollback(Marker marker) {
     assert(marker <= m_offset && "Cannot rollback to future state");
+    if (marker != m_offset) {
+        m_last_offset = NO_ALLOCATION;
+    }
     m_offset = marker;
 }
 
@@ -117,6 +171,37 @@ size_t StackAllocator::used_size() const {
     return m_offset;
 }
 
+void StackAllocator::prefault() const noexcept {
+    os::prefault(m_memory, m_size);
+}
+
+bool StackAllocator::locked() const noexcept {
+    return m_locked;
+}
+
+size_t StackAllocator::trim(size_t max_bytes, bool lazy) {
+    if (m_memory == nullptr || m_locked || m_high_water <= m_offset) {
+        return 0;
+    }
+
+    // Only [top, high water) can have been dirtied since the last trim;
+    // the page holding the high water mark is partly dirty too
+    char* base = static_cast<char*>(m_memory);
+    char* first = base + m_offset;
+    char* last = std::min(static_cast<char*>(utils::align_pointer(
+                              base + m_high_water, os::page_size())),
+                          base + m_size);
+    if (static_cast<size_t>(last - first) > max_bytes) {
+        first = last - max_bytes;
+    }
+
+    size_t released = os::decommit(first, static_cast<size_t>(last - first), lazy);
+    if (released > 0) {
+        m_high_water = static_cast<size_t>(first - base);
+    }
+    return released;
+}
+
 size_t StackAllocator::free_size() const noexcept {
     return m_size - m_offset;
 }
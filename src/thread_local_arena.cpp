@@ -0,0 +1,198 @@
+#include "allocx/thread_local_arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace allocx {
+
+namespace {
+
+constexpr size_t ARENA_ALIGNMENT = 64;
+
+std::atomic<uint64_t> g_next_id{1};
+
+std::mutex g_global_mutex;
+ThreadLocalArenaConfig g_global_config;
+bool g_global_created = false;
+
+} // namespace
+
+struct ThreadLocalArena::Registry {
+  struct Slot {
+    std::unique_ptr<StackAllocator> stack;
+    void *memory = nullptr; // From the backing allocator, if any
+  };
+
+  mutable std::mutex mutex;
+  bool closed = false; // Set once the ThreadLocalArena is destroyed
+  std::vector<std::unique_ptr<Slot>> slots;
+  std::vector<Slot *> free_slots;
+
+  void release(Slot *slot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed)
+      return;
+    slot->stack->reset();
+    free_slots.push_back(slot);
+  }
+};
+
+namespace {
+
+using Registry = ThreadLocalArena::Registry;
+
+// Arenas bound to this thread; returned to their registries on exit
+struct ThreadBindings {
+  struct Binding {
+    uint64_t id;
+    std::weak_ptr<Registry> registry;
+    Registry::Slot *slot;
+  };
+
+  std::vector<Binding> bindings;
+
+  ~ThreadBindings() {
+    for (Binding &binding : bindings) {
+      if (std::shared_ptr<Registry> registry = binding.registry.lock()) {
+        registry->release(binding.slot);
+      }
+    }
+  }
+};
+
+// Most recently used arena, keyed by registry id
+struct ThreadCache {
+  uint64_t id = 0;
+  StackAllocator *stack = nullptr;
+};
+
+thread_local ThreadBindings t_bindings;
+thread_local ThreadCache t_cache;
+thread_local StackAllocator *t_frame = nullptr;
+
+} // namespace
+
+ThreadLocalArena::ThreadLocalArena(const ThreadLocalArenaConfig &config)
+    : m_config(config), m_id(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+      m_registry(std::make_shared<Registry>()) {}
+
+ThreadLocalArena::~ThreadLocalArena() {
+  std::lock_guard<std::mutex> lock(m_registry->mutex);
+  m_registry->closed = true;
+  for (auto &slot : m_registry->slots) {
+    slot->stack.reset();
+    if (slot->memory) {
+      m_config.backing->deallocate(slot->memory, m_config.arena_size);
+    }
+  }
+  m_registry->slots.clear();
+  m_registry->free_slots.clear();
+}
+
+StackAllocator &ThreadLocalArena::local() {
+  ThreadCache &cache = t_cache;
+  if (cache.id == m_id)
+    return *cache.stack;
+
+  StackAllocator &stack = attach();
+  cache.id = m_id;
+  cache.stack = &stack;
+  return stack;
+}
+
+StackAllocator &ThreadLocalArena::attach() {
+  // The thread may already own an arena here if it switched registries
+  for (const ThreadBindings::Binding &binding : t_bindings.bindings) {
+    if (binding.id == m_id)
+      return *binding.slot->stack;
+  }
+
+  Registry::Slot *slot = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_registry->mutex);
+    if (!m_registry->free_slots.empty()) {
+      slot = m_registry->free_slots.back();
+      m_registry->free_slots.pop_back();
+    } else {
+      auto created = std::make_unique<Registry::Slot>();
+      if (m_config.backing) {
+        created->memory =
+            m_config.backing->allocate(m_config.arena_size, ARENA_ALIGNMENT);
+        if (!created->memory)
+          throw std::bad_alloc();
+        created->stack = std::make_unique<StackAllocator>(created->memory,
+                                                          m_config.arena_size);
+      } else {
+        created->stack = std::make_unique<StackAllocator>(m_config.arena_size);
+      }
+      slot = created.get();
+      m_registry->slots.push_back(std::move(created));
+    }
+  }
+
+  // Drop bindings to destroyed registries before adding a new one
+  auto &bindings = t_bindings.bindings;
+  bindings.erase(std::remove_if(bindings.begin(), bindings.end(),
+                                [](const ThreadBindings::Binding &binding) {
+                                  return binding.registry.expired();
+                                }),
+                 bindings.end());
+  bindings.push_back({m_id, m_registry, slot});
+  return *slot->stack;
+}
+
+void ThreadLocalArena::reset_all() {
+  std::lock_guard<std::mutex> lock(m_registry->mutex);
+  for (auto &slot : m_registry->slots) {
+    slot->stack->reset();
+  }
+}
+
+size_t ThreadLocalArena::arena_count() const {
+  std::lock_guard<std::mutex> lock(m_registry->mutex);
+  return m_registry->slots.size();
+}
+
+size_t ThreadLocalArena::active_count() const {
+  std::lock_guard<std::mutex> lock(m_registry->mutex);
+  return m_registry->slots.size() - m_registry->free_slots.size();
+}
+
+size_t ThreadLocalArena::used_size() const {
+  std::lock_guard<std::mutex> lock(m_registry->mutex);
+  size_t used = 0;
+  for (const auto &slot : m_registry->slots) {
+    used += slot->stack->used_size();
+  }
+  return used;
+}
+
+ThreadLocalArena &ThreadLocalArena::global() {
+  static ThreadLocalArena arena([] {
+    std::lock_guard<std::mutex> lock(g_global_mutex);
+    g_global_created = true;
+    return g_global_config;
+  }());
+  return arena;
+}
+
+bool ThreadLocalArena::configure_global(const ThreadLocalArenaConfig &config) {
+  std::lock_guard<std::mutex> lock(g_global_mutex);
+  if (g_global_created)
+    return false;
+  g_global_config = config;
+  return true;
+}
+
+StackAllocator &tls_frame() {
+  StackAllocator *frame = t_frame;
+  if (frame)
+    return *frame;
+  frame = &ThreadLocalArena::global().local();
+  t_frame = frame;
+  return *frame;
+}
+
+} // namespace allocx
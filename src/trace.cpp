@@ -0,0 +1,160 @@
+#include "allocx/trace.hpp"
+#include "allocx/utils.hpp"
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace allocx {
+
+namespace {
+
+constexpr char TRACE_MAGIC[8] = {'A', 'L', 'X', 'T', 'R', 'A', 'C', 'E'};
+
+std::atomic<uint64_t> g_next_writer_id{1};
+
+// Single-entry cache of the calling thread's buffer
+struct ThreadBufferCache {
+  uint64_t writer_id = 0;
+  void *buffer = nullptr;
+};
+
+thread_local ThreadBufferCache t_buffer_cache;
+
+uint8_t log2_of(size_t value) noexcept {
+  uint8_t log = 0;
+  while (value > 1) {
+    value >>= 1;
+    ++log;
+  }
+  return log;
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(const char *path)
+    : m_file(std::fopen(path, "wb")),
+      m_id(g_next_writer_id.fetch_add(1, std::memory_order_relaxed)),
+      m_records_written(0) {
+  if (m_file) {
+    uint32_t version = FORMAT_VERSION;
+    uint32_t record_size = sizeof(TraceRecord);
+    std::fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), m_file);
+    std::fwrite(&version, sizeof(version), 1, m_file);
+    std::fwrite(&record_size, sizeof(record_size), 1, m_file);
+  }
+}
+
+TraceWriter::~TraceWriter() {
+  flush();
+  if (m_file) {
+    std::fclose(m_file);
+  }
+}
+
+void TraceWriter::record(TraceOp op, const void *ptr, size_t size,
+                         size_t alignment) noexcept {
+  if (!m_file)
+    return;
+
+  ThreadBuffer *buffer = thread_buffer();
+  if (!buffer)
+    return;
+
+  TraceRecord &rec = buffer->records[buffer->count++];
+  rec.tsc = utils::read_tsc();
+  rec.ptr_id = reinterpret_cast<uintptr_t>(ptr);
+  rec.size = size > std::numeric_limits<uint32_t>::max()
+                 ? std::numeric_limits<uint32_t>::max()
+                 : static_cast<uint32_t>(size);
+  rec.thread = buffer->thread;
+  rec.op = op;
+  rec.align_log2 = log2_of(alignment);
+
+  if (buffer->count == RECORDS_PER_BUFFER) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    write_buffer(*buffer);
+  }
+}
+
+void TraceWriter::flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &buffer : m_buffers) {
+    write_buffer(*buffer);
+  }
+  if (m_file) {
+    std::fflush(m_file);
+  }
+}
+
+TraceWriter::ThreadBuffer *TraceWriter::thread_buffer() {
+  if (t_buffer_cache.writer_id == m_id) {
+    return static_cast<ThreadBuffer *>(t_buffer_cache.buffer);
+  }
+
+  // Slow path: first record from this thread, or the thread switched
+  // between writers since its last record
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  ThreadBuffer *found = nullptr;
+  for (auto &buffer : m_buffers) {
+    if (buffer->owner == self) {
+      found = buffer.get();
+      break;
+    }
+  }
+
+  if (!found) {
+    if (m_buffers.size() > std::numeric_limits<uint16_t>::max()) {
+      return nullptr;
+    }
+    try {
+      m_buffers.push_back(std::make_unique<ThreadBuffer>());
+    } catch (...) {
+      return nullptr;
+    }
+    found = m_buffers.back().get();
+    found->thread = static_cast<uint16_t>(m_buffers.size() - 1);
+    found->owner = self;
+  }
+
+  t_buffer_cache.writer_id = m_id;
+  t_buffer_cache.buffer = found;
+  return found;
+}
+
+void TraceWriter::write_buffer(ThreadBuffer &buffer) {
+  if (m_file && buffer.count > 0) {
+    m_records_written +=
+        std::fwrite(buffer.records, sizeof(TraceRecord), buffer.count, m_file);
+  }
+  buffer.count = 0;
+}
+
+bool read_trace(const char *path, std::vector<TraceRecord> &out) {
+  std::FILE *file = std::fopen(path, "rb");
+  if (!file)
+    return false;
+
+  char magic[sizeof(TRACE_MAGIC)];
+  uint32_t version = 0;
+  uint32_t record_size = 0;
+  bool valid = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+               std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0 &&
+               std::fread(&version, sizeof(version), 1, file) == 1 &&
+               std::fread(&record_size, sizeof(record_size), 1, file) == 1 &&
+               version == TraceWriter::FORMAT_VERSION &&
+               record_size == sizeof(TraceRecord);
+
+  if (valid) {
+    TraceRecord rec;
+    while (std::fread(&rec, sizeof(rec), 1, file) == 1) {
+      out.push_back(rec);
+    }
+  }
+
+  std::fclose(file);
+  return valid;
+}
+
+} // namespace allocx
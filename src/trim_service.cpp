@@ -0,0 +1,85 @@
+#include "allocx/trim_service.hpp"
+#include <algorithm>
+
+namespace allocx {
+
+TrimService::TrimService(const TrimOptions &options)
+    : m_options(options), m_mutex(), m_wake(), m_entries(), m_next(0),
+      m_stopping(false), m_thread(), m_released(0), m_busy_skips(0),
+      m_passes(0) {}
+
+TrimService::~TrimService() { stop(); }
+
+void TrimService::add(IAllocator &allocator, std::mutex &lock) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_entries.push_back({&allocator, &lock});
+}
+
+void TrimService::remove(IAllocator &allocator) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                 [&](const Entry &entry) {
+                                   return entry.allocator == &allocator;
+                                 }),
+                  m_entries.end());
+}
+
+bool TrimService::start() {
+  if (m_thread.joinable())
+    return false;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stopping = false;
+  }
+  m_thread = std::thread(&TrimService::run, this);
+  return true;
+}
+
+void TrimService::stop() {
+  if (!m_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  m_thread.join();
+}
+
+size_t TrimService::run_once() {
+  // Held for the whole pass so remove() cannot return mid-trim
+  std::lock_guard<std::mutex> guard(m_mutex);
+  size_t released = 0;
+  size_t count = m_entries.size();
+  // Start where the last pass stopped so a small budget still reaches
+  // every allocator in turn
+  size_t visited = 0;
+  for (; visited < count && released < m_options.max_bytes_per_pass;
+       ++visited) {
+    const Entry &entry = m_entries[(m_next + visited) % count];
+    std::unique_lock<std::mutex> lock(*entry.lock, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      m_busy_skips.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    released += entry.allocator->trim(
+        m_options.max_bytes_per_pass - released, m_options.lazy);
+  }
+  m_next = count ? (m_next + visited) % count : 0;
+
+  m_released.fetch_add(released, std::memory_order_relaxed);
+  m_passes.fetch_add(1, std::memory_order_relaxed);
+  return released;
+}
+
+void TrimService::run() {
+  std::unique_lock<std::mutex> guard(m_mutex);
+  while (!m_wake.wait_for(guard, m_options.interval,
+                          [this]() { return m_stopping; })) {
+    guard.unlock();
+    run_once();
+    guard.lock();
+  }
+}
+
+} // namespace allocx
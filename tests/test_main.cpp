@@ -1,11 +1,42 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <string>
 #include <vector>
 
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "allocx/bitmap_pool_allocator.hpp"
+#include "allocx/buddy_allocator.hpp"
+#include "allocx/concurrent_stack_allocator.hpp"
 #include "allocx/freelist_allocator.hpp"
+#include "allocx/handle_pool.hpp"
+#include "allocx/large_object_allocator.hpp"
+#include "allocx/numa_pool_selector.hpp"
+#include "allocx/offset_ptr.hpp"
+#include "allocx/os_memory.hpp"
+#include "allocx/persistent_arena.hpp"
+#include "allocx/instrumented_allocator.hpp"
+#include "allocx/latency_histogram.hpp"
 #include "allocx/pool_allocator.hpp"
+#include "allocx/shared_pool_allocator.hpp"
+#include "allocx/slab_cache.hpp"
 #include "allocx/stack_allocator.hpp"
+#include "allocx/stl_adapter.hpp"
+#include "allocx/thread_local_arena.hpp"
+#include "allocx/thread_safe.hpp"
+#include "allocx/tracing_allocator.hpp"
+#include "allocx/trim_service.hpp"
 #include "allocx/utils.hpp"
 
 using namespace allocx;
@@ -129,6 +160,25 @@ void test_stack_out_of_memory() {
   ASSERT(p2 == nullptr);
 }
 
+void test_stack_try_expand() {
+  StackAllocator alloc(1024);
+
+  void *p1 = alloc.allocate(100);
+  ASSERT(alloc.try_expand(p1, 300)); // Top of stack grows in place
+  ASSERT(alloc.used_size() == 300);
+  ASSERT(alloc.try_expand(p1, 50)); // And shrinks
+  ASSERT(alloc.used_size() == 50);
+  ASSERT(!alloc.try_expand(p1, 2000));
+
+  void *p2 = alloc.allocate(16);
+  ASSERT(!alloc.try_expand(p1, 100)); // No longer the top
+  ASSERT(alloc.try_expand(p2, 64));
+
+  std::memset(p2, 0x3C, 64);
+  void *p3 = alloc.reallocate(p2, 64, 128);
+  ASSERT(p3 == p2);
+}
+
 // ============================================================================
 // Pool Allocator Tests
 // ============================================================================
@@ -195,6 +245,283 @@ void test_pool_reset() {
   ASSERT(pool.free_count() == 10);
 }
 
+void test_pool_for_each_allocated() {
+  PoolOptions options;
+  options.track_occupancy = true;
+  PoolAllocator pool(32, 150, alignof(std::max_align_t), options);
+  ASSERT(pool.tracks_occupancy());
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 150; ++i) {
+    ptrs.push_back(pool.allocate());
+  }
+  for (size_t i = 0; i < ptrs.size(); i += 2) {
+    pool.deallocate(ptrs[i]);
+  }
+
+  // Free list hands chunks out in LIFO order, iteration is by address
+  std::vector<void *> visited;
+  pool.for_each_allocated([&](void *p) { visited.push_back(p); });
+  ASSERT(visited.size() == 75);
+  for (size_t i = 1; i < visited.size(); ++i) {
+    ASSERT(visited[i - 1] < visited[i]);
+  }
+
+  pool.reset();
+  size_t count = 0;
+  pool.for_each_allocated([&](void *) { ++count; });
+  ASSERT(count == 0);
+}
+
+void test_pool_for_each_allocated_parallel() {
+  PoolOptions options;
+  options.track_occupancy = true;
+  PoolAllocator pool(16, 1000, alignof(std::max_align_t), options);
+
+  for (int i = 0; i < 700; ++i) {
+    pool.allocate();
+  }
+
+  std::atomic<size_t> count{0};
+  pool.for_each_allocated_parallel(
+      [&](void *p) {
+        ASSERT(pool.owns(p));
+        count.fetch_add(1, std::memory_order_relaxed);
+      },
+      4);
+  ASSERT(count.load() == 700);
+}
+
+// ============================================================================
+// Slab Cache Tests
+// ============================================================================
+
+struct CountedObject {
+  static int constructed;
+  static int destroyed;
+  int value = 7;
+  CountedObject() { ++constructed; }
+  ~CountedObject() { ++destroyed; }
+};
+int CountedObject::constructed = 0;
+int CountedObject::destroyed = 0;
+
+void test_slab_cache_constructed_state() {
+  CountedObject::constructed = CountedObject::destroyed = 0;
+  {
+    SlabCache<CountedObject> cache(8);
+    CountedObject *a = cache.acquire();
+    ASSERT(a != nullptr && a->value == 7);
+    ASSERT(CountedObject::constructed == 8); // Whole slab built at once
+    ASSERT(cache.size() == 1 && cache.free_count() == 7);
+
+    a->value = 42;
+    cache.release(a);
+    ASSERT(CountedObject::destroyed == 0);
+
+    // Same object, state retained, no constructor call
+    CountedObject *b = cache.acquire();
+    ASSERT(b == a && b->value == 42);
+    ASSERT(CountedObject::constructed == 8);
+  }
+  ASSERT(CountedObject::destroyed == 8);
+}
+
+void test_pool_cache_line_padding() {
+  PoolOptions options;
+  options.cache_line_padding = true;
+  PoolAllocator padded(16, 32, alignof(std::max_align_t), options);
+  ASSERT(padded.chunk_size() == utils::CACHE_LINE_SIZE);
+
+  // Neighbouring chunks never share a cache line
+  char *a = static_cast<char *>(padded.allocate());
+  char *b = static_cast<char *>(padded.allocate());
+  ASSERT(utils::is_aligned(a, utils::CACHE_LINE_SIZE));
+  ASSERT(utils::is_aligned(b, utils::CACHE_LINE_SIZE));
+  ASSERT(a != b);
+
+  // Larger chunks round up to whole lines; over-aligned owned pools free
+  // the block they allocated, not the aligned start
+  PoolAllocator wide(100, 8, alignof(std::max_align_t), options);
+  ASSERT(wide.chunk_size() == 2 * utils::CACHE_LINE_SIZE);
+  PoolAllocator page_aligned(64, 8, 4096);
+  ASSERT(utils::is_aligned(page_aligned.allocate(), 4096));
+  PoolAllocator moved(std::move(page_aligned));
+  ASSERT(moved.free_count() == 7);
+
+  PoolAllocator packed(16, 32);
+  ASSERT(packed.chunk_size() == 16);
+}
+
+void test_pool_prefetch() {
+  PoolOptions options;
+  options.prefetch = true;
+  PoolAllocator pool(32, 64, alignof(std::max_align_t), options);
+
+  // Same LIFO behaviour as a plain pool, down to the last chunk (where
+  // there is no next head to prefetch)
+  std::vector<void *> chunks;
+  while (void *chunk = pool.allocate())
+    chunks.push_back(chunk);
+  ASSERT(chunks.size() == 64);
+  ASSERT(pool.free_count() == 0);
+  pool.deallocate(chunks[10]);
+  pool.deallocate(chunks[3]);
+  ASSERT(pool.allocate() == chunks[3]);
+  ASSERT(pool.allocate() == chunks[10]);
+
+  // The option survives a move
+  PoolAllocator moved(std::move(pool));
+  for (void *chunk : chunks)
+    moved.deallocate(chunk);
+  ASSERT(moved.free_count() == 64);
+  ASSERT(moved.allocate() == chunks.back());
+}
+
+void test_pool_address_ordered() {
+  // 64B chunks: one span of 64 chunks per 4KB page
+  PoolOptions options;
+  options.address_ordered = true;
+  options.track_occupancy = true;
+  PoolAllocator pool(64, 256, alignof(std::max_align_t), options);
+  ASSERT(pool.address_ordered());
+
+  // A fresh pool hands chunks out back to back
+  std::vector<char *> chunks;
+  while (char *chunk = static_cast<char *>(pool.allocate()))
+    chunks.push_back(chunk);
+  ASSERT(chunks.size() == 256);
+  for (size_t i = 1; i < chunks.size(); ++i)
+    ASSERT(chunks[i] == chunks[i - 1] + 64);
+
+  // Freed in any order, chunks come back lowest first, fullest span
+  // first: span 0 has one free chunk, span 1 two, span 2 three
+  for (size_t i : {140, 10, 71, 130, 70, 135})
+    pool.deallocate(chunks[i]);
+  ASSERT(pool.free_count() == 6);
+  for (size_t i : {10, 70, 71, 130, 135, 140})
+    ASSERT(pool.allocate() == chunks[i]);
+  ASSERT(pool.allocate() == nullptr);
+
+  // Wholly free spans are used after partly used ones
+  for (size_t i = 192; i < 256; ++i)
+    pool.deallocate(chunks[i]);
+  pool.deallocate(chunks[5]);
+  ASSERT(pool.allocate() == chunks[5]);
+  ASSERT(pool.allocate() == chunks[192]);
+
+  size_t live = 0;
+  pool.for_each_allocated([&](void *) { ++live; });
+  ASSERT(live == 256 - 63);
+
+  PoolAllocator moved(std::move(pool));
+  moved.reset();
+  ASSERT(moved.free_count() == 256 && moved.allocate() == chunks[0]);
+}
+
+void test_slab_cache_growth_and_reap() {
+  CountedObject::constructed = CountedObject::destroyed = 0;
+  SlabCache<CountedObject> cache(4, 2);
+
+  std::vector<CountedObject *> objects;
+  for (int i = 0; i < 8; ++i) {
+    objects.push_back(cache.acquire());
+    ASSERT(objects.back() != nullptr);
+  }
+  ASSERT(cache.slab_count() == 2);
+  ASSERT(cache.acquire() == nullptr); // Slab limit reached
+
+  // Free the second slab's objects only
+  for (int i = 4; i < 8; ++i) {
+    cache.release(objects[i]);
+  }
+  ASSERT(cache.reap() == 1);
+  ASSERT(cache.slab_count() == 1);
+  ASSERT(CountedObject::destroyed == 4);
+  ASSERT(cache.owns(objects[0]) && !cache.owns(objects[4]));
+  ASSERT(cache.free_count() == 0);
+
+  for (int i = 0; i < 4; ++i) {
+    cache.release(objects[i]);
+  }
+}
+
+void test_slab_cache_coloring() {
+  struct Record {
+    char data[48];
+  };
+  SlabCache<Record> cache(16); // 768 bytes used of a 4KB slab
+  ASSERT(cache.color_count() ==
+         (os::page_size() - 16 * sizeof(Record)) / utils::CACHE_LINE_SIZE + 1);
+
+  // Each slab starts its objects one cache line further in
+  for (int i = 0; i < 3; ++i)
+    ASSERT(cache.grow());
+  for (size_t i = 0; i < 3; ++i)
+    ASSERT(cache.slab_color(i) == i * utils::CACHE_LINE_SIZE);
+
+  // Object i of each slab lands on a different offset within its page
+  std::vector<Record *> firsts;
+  for (int i = 0; i < 48; ++i) {
+    Record *record = cache.acquire();
+    ASSERT(utils::is_aligned(record, alignof(Record)));
+    if (i % 16 == 0)
+      firsts.push_back(record);
+  }
+  ASSERT(cache.acquire() != nullptr); // A fourth slab
+  for (size_t i = 1; i < firsts.size(); ++i) {
+    uintptr_t line_prev = reinterpret_cast<uintptr_t>(firsts[i - 1]) % 4096;
+    uintptr_t line = reinterpret_cast<uintptr_t>(firsts[i]) % 4096;
+    ASSERT(line != line_prev);
+  }
+
+  // Large slabs with no slack are not colored
+  SlabCache<Record> packed(os::page_size() / 16);
+  ASSERT(packed.color_count() == 1);
+}
+
+void test_slab_cache_callbacks() {
+  int built = 0;
+  SlabCache<int> cache(
+      16, 0, [&](void *memory) { new (memory) int(++built); },
+      [](int *) {});
+  int *first = cache.acquire();
+  ASSERT(*first == 1); // acquire() walks the slab in address order
+  ASSERT(*cache.acquire() == 2);
+  ASSERT(built == 16);
+}
+
+void test_slab_cache_constructor_throws() {
+  int built = 0;
+  int destroyed = 0;
+  bool fail = true;
+  {
+    SlabCache<int> cache(
+        8, 0,
+        [&](void *memory) {
+          if (fail && built == 5)
+            throw std::bad_alloc();
+          new (memory) int(++built);
+        },
+        [&](int *) { ++destroyed; });
+
+    bool threw = false;
+    try {
+      cache.acquire();
+    } catch (const std::bad_alloc &) {
+      threw = true;
+    }
+    // Only the five objects that were built are torn down
+    ASSERT(threw && destroyed == 5);
+    ASSERT(cache.slab_count() == 0 && cache.free_count() == 0);
+
+    fail = false;
+    ASSERT(cache.acquire() != nullptr);
+    ASSERT(cache.slab_count() == 1 && cache.free_count() == 7);
+  }
+  ASSERT(destroyed == 5 + 8);
+}
+
 // ============================================================================
 // Free-List Allocator Tests
 // ============================================================================
@@ -246,6 +573,34 @@ void test_freelist_alignment() {
 
   void *p2 = alloc.allocate(10, 32);
   ASSERT(reinterpret_cast<uintptr_t>(p2) % 32 == 0);
+
+  // Padding beyond a byte still leads back to the right header
+  FreeListAllocator large(64 * 1024);
+  std::vector<void *> ptrs;
+  for (size_t alignment : {512, 4096, 512, 256}) {
+    void *p = large.allocate(100, alignment);
+    ASSERT(p != nullptr && reinterpret_cast<uintptr_t>(p) % alignment == 0);
+    std::memset(p, 0x5a, 100);
+    ptrs.push_back(p);
+  }
+  ASSERT(large.try_expand(ptrs[3], 400));
+  for (void *p : ptrs)
+    large.deallocate(p);
+  ASSERT(large.used_size() == 0);
+  ASSERT(large.free_block_count() == 1);
+
+  // ...including after a relocation
+  void *pinned = large.allocate(64);
+  FreeListAllocator::Handle handle = large.allocate_handle(100, 512);
+  std::memset(large.resolve(handle), 0x77, 100);
+  large.deallocate(pinned);
+  while (large.defragment(SIZE_MAX) > 0) {
+  }
+  auto *moved = static_cast<unsigned char *>(large.resolve(handle));
+  ASSERT(reinterpret_cast<uintptr_t>(moved) % 512 == 0);
+  ASSERT(moved[0] == 0x77 && moved[99] == 0x77);
+  large.deallocate_handle(handle);
+  ASSERT(large.used_size() == 0);
 }
 
 void test_freelist_reset() {
@@ -259,6 +614,1411 @@ void test_freelist_reset() {
   ASSERT(alloc.used_size() == 0);
 }
 
+void test_freelist_coalescing() {
+  FreeListAllocator alloc(4096);
+  size_t initial = alloc.largest_free_block();
+
+  void *a = alloc.allocate(100);
+  void *b = alloc.allocate(100);
+  void *c = alloc.allocate(100);
+  void *d = alloc.allocate(100);
+
+  // Free out of address order; neighbours must still merge
+  alloc.deallocate(c);
+  alloc.deallocate(a);
+  alloc.deallocate(d);
+  alloc.deallocate(b);
+  ASSERT(alloc.free_block_count() == 1);
+  ASSERT(alloc.largest_free_block() == initial);
+}
+
+void test_freelist_try_expand() {
+  FreeListAllocator alloc(4096);
+
+  void *a = alloc.allocate(64);
+  void *b = alloc.allocate(64);
+  std::memset(a, 0x11, 64);
+
+  // b is followed by the free tail, so it grows in place
+  size_t used = alloc.used_size();
+  ASSERT(alloc.try_expand(b, 1000));
+  ASSERT(alloc.used_size() > used);
+  ASSERT(alloc.reallocate(b, 1000, 1500) == b);
+
+  // Shrinking returns the surplus to the free list
+  size_t free_bytes = alloc.metrics().free_bytes;
+  ASSERT(alloc.try_expand(b, 64));
+  ASSERT(alloc.metrics().free_bytes > free_bytes);
+
+  // a is followed by b, so growing it has to move the data
+  ASSERT(!alloc.try_expand(a, 200));
+  void *moved = alloc.reallocate(a, 64, 200);
+  ASSERT(moved != nullptr && moved != a);
+  ASSERT(static_cast<unsigned char *>(moved)[63] == 0x11);
+}
+
+void test_freelist_metrics() {
+  FreeListAllocator alloc(4096);
+  auto m = alloc.metrics();
+  ASSERT(m.free_blocks == 1);
+  ASSERT(m.free_bytes == m.largest_free_block);
+  ASSERT(m.external_fragmentation == 0.0);
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 8; ++i) {
+    ptrs.push_back(alloc.allocate(64));
+  }
+  alloc.deallocate(ptrs[1]);
+  alloc.deallocate(ptrs[3]);
+  alloc.deallocate(ptrs[5]);
+
+  // Three 64-byte holes plus the tail block
+  m = alloc.metrics();
+  ASSERT(m.free_blocks == 4);
+  ASSERT(m.histogram[6] == 3);
+  ASSERT(m.largest_free_block == alloc.largest_free_block());
+  ASSERT(m.free_bytes - m.largest_free_block >= 3 * 64);
+  ASSERT(m.external_fragmentation > 0.0 && m.external_fragmentation < 1.0);
+
+  alloc.reset();
+  ASSERT(alloc.metrics().free_blocks == 1);
+  ASSERT(alloc.metrics().histogram[6] == 0);
+
+  // The maximum stays exact through churn (checked against the heap map)
+  FreeListAllocator heap(64 * 1024);
+  std::mt19937 rng(7);
+  std::vector<void *> live;
+  for (int i = 0; i < 2000; ++i) {
+    if (live.empty() || rng() % 3 != 0) {
+      if (void *p = heap.allocate(16 + rng() % 512))
+        live.push_back(p);
+    } else {
+      size_t victim = rng() % live.size();
+      heap.deallocate(live[victim]);
+      live[victim] = live.back();
+      live.pop_back();
+    }
+    if (i % 100 != 0)
+      continue;
+    std::ostringstream os;
+    heap.dump_heap_map(os);
+    std::istringstream lines(os.str());
+    std::string line;
+    size_t header = 0, largest = 0;
+    while (std::getline(lines, line)) {
+      if (line.rfind("# header_size=", 0) == 0)
+        header = std::stoul(line.substr(14));
+      size_t comma = line.find(',');
+      if (line.size() > 2 && line.compare(line.size() - 2, 2, ",F") == 0)
+        largest = std::max(largest, std::stoul(line.substr(comma + 1)) - header);
+    }
+    ASSERT(heap.largest_free_block() == largest);
+  }
+}
+
+void test_freelist_heap_map() {
+  FreeListAllocator alloc(1024);
+  void *a = alloc.allocate(64);
+  alloc.allocate_handle(64);
+  alloc.allocate(64);
+  alloc.deallocate(a);
+
+  std::ostringstream os;
+  alloc.dump_heap_map(os);
+  std::string map = os.str();
+  ASSERT(map.find("# arena_size=1024\n") != std::string::npos);
+  ASSERT(map.find("offset,size,state\n0,") != std::string::npos);
+
+  // Rows cover the arena exactly: F, R, A, F
+  std::istringstream rows(map.substr(map.find("offset")));
+  std::string line;
+  std::getline(rows, line);
+  std::string states;
+  size_t expected_offset = 0;
+  while (std::getline(rows, line)) {
+    size_t offset = std::stoul(line);
+    size_t size = std::stoul(line.substr(line.find(',') + 1));
+    ASSERT(offset == expected_offset);
+    expected_offset += size;
+    states += line.back();
+  }
+  ASSERT(expected_offset == 1024);
+  ASSERT(states == "FRAF");
+}
+
+void test_freelist_defragment() {
+  FreeListAllocator alloc(64 * 1024);
+
+  std::vector<FreeListAllocator::Handle> handles;
+  for (int i = 0; i < 200; ++i) {
+    auto h = alloc.allocate_handle(128);
+    ASSERT(h != FreeListAllocator::NULL_HANDLE);
+    std::memset(alloc.resolve(h), i, 128);
+    handles.push_back(h);
+  }
+  for (size_t i = 0; i < handles.size(); i += 2) {
+    alloc.deallocate_handle(handles[i]);
+  }
+  size_t fragmented = alloc.largest_free_block();
+  size_t free_blocks = alloc.free_block_count();
+  ASSERT(free_blocks > 50);
+
+  // A small budget makes progress without finishing
+  size_t moved = alloc.defragment(256);
+  ASSERT(moved >= 256);
+  ASSERT(alloc.free_block_count() < free_blocks);
+
+  while (alloc.defragment(4096) > 0) {
+  }
+  ASSERT(alloc.free_block_count() == 1);
+  ASSERT(alloc.largest_free_block() > fragmented + 100 * 128);
+
+  // Contents followed their handles
+  for (size_t i = 1; i < handles.size(); i += 2) {
+    unsigned char *p = static_cast<unsigned char *>(alloc.resolve(handles[i]));
+    ASSERT(p[0] == static_cast<unsigned char>(i) &&
+           p[127] == static_cast<unsigned char>(i));
+  }
+
+  // An arena of odd size: the block moved into the gap must not leave the
+  // next free header at a misaligned address
+  FreeListAllocator odd(1001);
+  auto a = odd.allocate_handle(64);
+  auto c = odd.allocate_handle(864);
+  ASSERT(a != FreeListAllocator::NULL_HANDLE &&
+         c != FreeListAllocator::NULL_HANDLE);
+  std::memset(odd.resolve(c), 0x5c, 864);
+  odd.deallocate_handle(a);
+  odd.defragment(1 << 20);
+  ASSERT(odd.free_block_count() == 1);
+  unsigned char *data = static_cast<unsigned char *>(odd.resolve(c));
+  ASSERT(data[0] == 0x5c && data[863] == 0x5c);
+  ASSERT(odd.allocate(odd.largest_free_block()) != nullptr);
+}
+
+void test_freelist_defragment_pinned() {
+  FreeListAllocator alloc(8192);
+
+  auto h1 = alloc.allocate_handle(64);
+  auto h2 = alloc.allocate_handle(64);
+  void *pinned = alloc.allocate(64);
+  auto h3 = alloc.allocate_handle(64);
+  auto h4 = alloc.allocate_handle(64);
+  std::memset(pinned, 0x5A, 64);
+
+  alloc.deallocate_handle(h1);
+  alloc.deallocate_handle(h3);
+  while (alloc.defragment(1024) > 0) {
+  }
+
+  // h2 slid below the pinned block, h4 slid up against it
+  ASSERT(alloc.resolve(h2) < pinned);
+  ASSERT(alloc.resolve(h4) > pinned);
+  ASSERT(static_cast<unsigned char *>(pinned)[63] == 0x5A);
+  ASSERT(alloc.free_block_count() == 2);
+}
+
+// ============================================================================
+// Bitmap Pool Allocator Tests
+// ============================================================================
+
+void test_bitmap_pool_basic_allocation() {
+  BitmapPoolAllocator pool(24, 100, 8);
+  ASSERT(pool.chunk_size() == 24);
+  ASSERT(pool.chunk_count() == 100);
+
+  void *p1 = pool.allocate();
+  void *p2 = pool.allocate();
+  ASSERT(p1 != nullptr && p2 != nullptr);
+  ASSERT(static_cast<char *>(p2) - static_cast<char *>(p1) == 24);
+  ASSERT(pool.owns(p1));
+  ASSERT(pool.is_allocated(0) && pool.is_allocated(1));
+  ASSERT(pool.used_size() == 48);
+
+  pool.deallocate(p1);
+  ASSERT(!pool.is_allocated(0));
+  ASSERT(pool.free_count() == 99);
+}
+
+void test_bitmap_pool_lowest_address_first() {
+  BitmapPoolAllocator pool(32, 300);
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 300; ++i) {
+    ptrs.push_back(pool.allocate());
+  }
+  ASSERT(pool.allocate() == nullptr);
+
+  // Freed slots are reused lowest address first, regardless of free order
+  pool.deallocate(ptrs[250]);
+  pool.deallocate(ptrs[70]);
+  pool.deallocate(ptrs[130]);
+  ASSERT(pool.allocate() == ptrs[70]);
+  ASSERT(pool.allocate() == ptrs[130]);
+  ASSERT(pool.allocate() == ptrs[250]);
+  ASSERT(pool.allocate() == nullptr);
+}
+
+void test_bitmap_pool_for_each_allocated() {
+  BitmapPoolAllocator pool(16, 200);
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 200; ++i) {
+    ptrs.push_back(pool.allocate());
+  }
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    if (i % 3 != 0)
+      pool.deallocate(ptrs[i]);
+  }
+
+  std::vector<void *> visited;
+  pool.for_each_allocated([&](void *p) { visited.push_back(p); });
+  ASSERT(visited.size() == 67);
+  for (size_t i = 0; i < visited.size(); ++i) {
+    ASSERT(visited[i] == ptrs[i * 3]);
+  }
+}
+
+void test_bitmap_pool_reset() {
+  BitmapPoolAllocator pool(64, 70);
+  for (int i = 0; i < 70; ++i) {
+    pool.allocate();
+  }
+  ASSERT(pool.allocate() == nullptr);
+
+  pool.reset();
+  ASSERT(pool.used_size() == 0);
+  ASSERT(pool.free_count() == 70);
+
+  size_t visited = 0;
+  pool.for_each_allocated([&](void *) { ++visited; });
+  ASSERT(visited == 0);
+}
+
+// ============================================================================
+// Large Object Allocator Tests
+// ============================================================================
+
+void test_large_object_basic() {
+  LargeObjectAllocator alloc;
+  constexpr size_t SIZE = 3 * 1024 * 1024 + 123;
+
+  char *p = static_cast<char *>(alloc.allocate(SIZE));
+  ASSERT(p != nullptr);
+  ASSERT(utils::is_aligned(p, os::page_size()));
+  std::memset(p, 0xAB, SIZE);
+  ASSERT(alloc.owns(p) && alloc.owns(p + SIZE - 1));
+  ASSERT(!alloc.owns(&alloc));
+  ASSERT(alloc.used_size() >= SIZE);
+
+  void *aligned = alloc.allocate(1024 * 1024, 2 * 1024 * 1024);
+  ASSERT(utils::is_aligned(aligned, 2 * 1024 * 1024));
+
+  alloc.deallocate(p);
+  alloc.deallocate(aligned);
+  ASSERT(alloc.mapping_count() == 0);
+}
+
+void test_large_object_cache() {
+  LargeObjectOptions options;
+  options.cache_entries = 2;
+  LargeObjectAllocator alloc(options);
+
+  void *p = alloc.allocate(1024 * 1024);
+  alloc.deallocate(p);
+  ASSERT(alloc.cached_count() == 1);
+  ASSERT(!alloc.owns(p)); // Cached mappings are not live
+
+  // A slightly smaller request reuses the cached mapping
+  void *q = alloc.allocate(1000 * 1024);
+  ASSERT(q == p && alloc.cache_hits() == 1);
+
+  // A much smaller one does not
+  void *r = alloc.allocate(64 * 1024);
+  ASSERT(r != p && alloc.cache_hits() == 1);
+
+  alloc.deallocate(q);
+  alloc.deallocate(r);
+  alloc.deallocate(alloc.allocate(4 * 1024 * 1024));
+  ASSERT(alloc.cached_count() == 2); // Oldest mapping evicted
+}
+
+void test_large_object_reallocate() {
+  LargeObjectAllocator alloc;
+  constexpr size_t OLD_SIZE = 256 * 1024;
+  constexpr size_t NEW_SIZE = 16 * 1024 * 1024;
+
+  char *p = static_cast<char *>(alloc.allocate(OLD_SIZE));
+  for (size_t i = 0; i < OLD_SIZE; i += 4096) {
+    p[i] = static_cast<char>(i / 4096);
+  }
+  char *q = static_cast<char *>(alloc.reallocate(p, OLD_SIZE, NEW_SIZE));
+  ASSERT(q != nullptr);
+  for (size_t i = 0; i < OLD_SIZE; i += 4096) {
+    ASSERT(q[i] == static_cast<char>(i / 4096));
+  }
+  q[NEW_SIZE - 1] = 1;
+  ASSERT(alloc.owns(q + NEW_SIZE - 1));
+  ASSERT(alloc.mapping_count() == 1);
+  alloc.deallocate(q);
+}
+
+void test_large_object_fallback() {
+  FreeListAllocator small(64 * 1024);
+  LargeObjectOptions options;
+  options.threshold = 16 * 1024;
+  LargeObjectAllocator alloc(options, &small);
+
+  void *p = alloc.allocate(1024);
+  ASSERT(small.owns(p) && alloc.owns(p));
+  ASSERT(alloc.mapping_count() == 0);
+
+  // Growing past the threshold moves the block into a mapping
+  void *q = alloc.reallocate(p, 1024, 128 * 1024);
+  ASSERT(!small.owns(q) && alloc.mapping_count() == 1);
+  ASSERT(small.used_size() == 0);
+  alloc.deallocate(q);
+}
+
+// ============================================================================
+// Shared Pool Allocator Tests
+// ============================================================================
+
+void test_shared_pool_basic() {
+  auto pool = SharedPoolAllocator::create(100, 8);
+  ASSERT(pool != nullptr);
+  ASSERT(pool->chunk_size() == 112); // Rounded up to max_align_t
+  ASSERT(pool->fd() >= 0);
+
+  void *chunks[8];
+  for (void *&chunk : chunks) {
+    chunk = pool->allocate(100);
+    ASSERT(chunk != nullptr && pool->owns(chunk));
+    ASSERT(pool->from_offset(pool->offset_of(chunk)) == chunk);
+  }
+  ASSERT(pool->allocate() == nullptr);
+  ASSERT(pool->allocate(200) == nullptr);
+  ASSERT(pool->free_count() == 0);
+
+  pool->deallocate(chunks[3]);
+  ASSERT(pool->allocate() == chunks[3]); // LIFO reuse
+  ASSERT(pool->from_offset(SharedPoolAllocator::null_offset) == nullptr);
+
+  pool->reset();
+  ASSERT(pool->free_count() == 8 && pool->used_size() == 0);
+}
+
+void test_shared_pool_attach() {
+  auto owner = SharedPoolAllocator::create(64, 16);
+  auto other = SharedPoolAllocator::attach(owner->fd());
+  ASSERT(other != nullptr);
+  ASSERT(other->chunk_count() == 16);
+
+  // Two mappings of one region: same offsets, different addresses
+  char *msg = static_cast<char *>(owner->allocate());
+  std::strcpy(msg, "quote");
+  SharedPoolAllocator::offset_type offset = owner->offset_of(msg);
+  char *seen = static_cast<char *>(other->from_offset(offset));
+  ASSERT(seen != msg && std::strcmp(seen, "quote") == 0);
+
+  other->deallocate(seen);
+  ASSERT(owner->free_count() == 16);
+
+  // Descriptors that do not hold a pool are rejected
+  ASSERT(SharedPoolAllocator::attach(-1) == nullptr);
+  ASSERT(SharedPoolAllocator::attach(STDIN_FILENO) == nullptr);
+
+  // Named pools are opened by name until unlinked
+  std::string name = "/allocx_test_" + std::to_string(::getpid());
+  auto named = SharedPoolAllocator::create(64, 4, name.c_str());
+  ASSERT(named != nullptr);
+  ASSERT(SharedPoolAllocator::create(64, 4, name.c_str()) == nullptr);
+  auto opened = SharedPoolAllocator::open(name.c_str());
+  ASSERT(opened != nullptr && opened->chunk_count() == 4);
+  ASSERT(SharedPoolAllocator::unlink(name.c_str()));
+  ASSERT(SharedPoolAllocator::open(name.c_str()) == nullptr);
+}
+
+void test_shared_pool_cross_process() {
+  constexpr int MESSAGES = 32;
+  auto pool = SharedPoolAllocator::create(256, 64);
+  int pipe_fds[2];
+  ASSERT(::pipe(pipe_fds) == 0);
+
+  // The child allocates and fills chunks, sending only their offsets
+  pid_t child = ::fork();
+  ASSERT(child >= 0);
+  if (child == 0) {
+    ::close(pipe_fds[0]);
+    auto producer = SharedPoolAllocator::attach(pool->fd());
+    for (int i = 0; i < MESSAGES; ++i) {
+      int *msg = static_cast<int *>(producer->allocate());
+      *msg = i * 7;
+      SharedPoolAllocator::offset_type offset = producer->offset_of(msg);
+      if (::write(pipe_fds[1], &offset, sizeof(offset)) != sizeof(offset))
+        ::_exit(1);
+    }
+    ::_exit(0);
+  }
+
+  ::close(pipe_fds[1]);
+  int received = 0;
+  SharedPoolAllocator::offset_type offset;
+  while (::read(pipe_fds[0], &offset, sizeof(offset)) == sizeof(offset)) {
+    int *msg = static_cast<int *>(pool->from_offset(offset));
+    ASSERT(msg != nullptr && *msg == received * 7);
+    pool->deallocate(msg);
+    ++received;
+  }
+  ::close(pipe_fds[0]);
+
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  ASSERT(received == MESSAGES);
+  ASSERT(pool->free_count() == 64);
+}
+
+void test_shared_pool_threads() {
+  constexpr size_t CHUNKS = 64;
+  auto pool = SharedPoolAllocator::create(sizeof(uint64_t), CHUNKS);
+  std::atomic<bool> corrupted{false};
+
+  // Each thread stamps its chunks and checks nobody else got them
+  std::vector<std::thread> threads;
+  for (uint64_t t = 1; t <= 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 20000; ++i) {
+        uint64_t *chunk = static_cast<uint64_t *>(pool->allocate());
+        if (!chunk)
+          continue;
+        *chunk = t;
+        std::this_thread::yield();
+        if (*chunk != t)
+          corrupted = true;
+        pool->deallocate(chunk);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  ASSERT(!corrupted);
+  ASSERT(pool->free_count() == CHUNKS);
+}
+
+void test_shared_pool_counts_in_range() {
+  constexpr size_t CHUNKS = 2;
+  auto pool = SharedPoolAllocator::create(sizeof(uint64_t), CHUNKS);
+  std::atomic<bool> done{false};
+  std::atomic<bool> out_of_range{false};
+
+  // An emptied pool is where a pop can be counted before its push
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 20000; ++i) {
+        void *chunk = pool->allocate();
+        if (chunk)
+          pool->deallocate(chunk);
+      }
+    });
+  }
+  std::thread watcher([&]() {
+    while (!done.load()) {
+      if (pool->free_count() > CHUNKS || pool->used_size() > pool->total_size())
+        out_of_range = true;
+    }
+  });
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  watcher.join();
+  ASSERT(!out_of_range);
+  ASSERT(pool->free_count() == CHUNKS);
+  ASSERT(pool->used_size() == 0);
+}
+
+// ============================================================================
+// Persistent Arena Tests
+// ============================================================================
+
+struct PersistentNode {
+  int value;
+  offset_ptr<PersistentNode> next;
+};
+
+void test_offset_ptr() {
+  alignas(PersistentNode) char region[4 * sizeof(PersistentNode)];
+  PersistentNode *nodes = reinterpret_cast<PersistentNode *>(region);
+  for (int i = 0; i < 4; ++i) {
+    new (&nodes[i]) PersistentNode{i, nullptr};
+    if (i > 0)
+      nodes[i - 1].next = &nodes[i];
+  }
+  ASSERT(!nodes[3].next && nodes[0].next.get() == &nodes[1]);
+
+  // Links still resolve after the bytes move to another address
+  alignas(PersistentNode) char moved[sizeof(region)];
+  std::memcpy(moved, region, sizeof(region));
+  PersistentNode *node = reinterpret_cast<PersistentNode *>(moved);
+  int sum = 0;
+  for (; node; node = node->next.get()) {
+    ASSERT(node >= reinterpret_cast<PersistentNode *>(moved));
+    sum += node->value;
+  }
+  ASSERT(sum == 0 + 1 + 2 + 3);
+
+  // Copying an offset_ptr keeps its target, not its distance
+  offset_ptr<PersistentNode> copy = nodes[0].next;
+  ASSERT(copy == nodes[0].next && copy->value == 1);
+}
+
+void test_persistent_arena_reopen() {
+  const char *path = "allocx_test.arena";
+  constexpr int NODES = 1000;
+  size_t used = 0;
+  {
+    auto arena = PersistentArena::create(path, 1024 * 1024);
+    ASSERT(arena != nullptr);
+    PersistentNode *head = nullptr;
+    for (int i = NODES - 1; i >= 0; --i) {
+      void *mem = arena->allocate(sizeof(PersistentNode), alignof(PersistentNode));
+      head = new (mem) PersistentNode{i, head};
+    }
+    arena->set_root(head);
+    ASSERT(arena->checkpoint());
+    used = arena->used_size();
+  }
+
+  auto arena = PersistentArena::open(path);
+  ASSERT(arena != nullptr);
+  ASSERT(arena->used_size() == used && arena->checkpoint_count() == 1);
+  int expected = 0;
+  for (PersistentNode *node = arena->root<PersistentNode>(); node;
+       node = node->next.get()) {
+    ASSERT(node->value == expected++);
+  }
+  ASSERT(expected == NODES);
+
+  // New allocations continue after the checkpointed objects
+  void *extra = arena->allocate(64);
+  ASSERT(arena->offset_of(extra) >= used);
+  arena.reset();
+  std::remove(path);
+}
+
+void test_persistent_arena_restore() {
+  const char *path = "allocx_test.arena";
+  auto arena = PersistentArena::create(path, 64 * 1024);
+  int *kept = static_cast<int *>(arena->allocate(sizeof(int)));
+  *kept = 1;
+  arena->set_root(kept);
+  ASSERT(arena->checkpoint());
+  size_t used = arena->used_size();
+
+  // Allocations after the checkpoint are discarded...
+  arena->set_root(arena->allocate(128));
+  arena->restore();
+  ASSERT(arena->used_size() == used && arena->root<int>() == kept);
+
+  // ...including by a restart without checkpoint(), while in-place
+  // writes to checkpointed objects persist
+  arena->allocate(256);
+  *kept = 2;
+  arena.reset();
+  arena = PersistentArena::open(path);
+  ASSERT(arena->used_size() == used && *arena->root<int>() == 2);
+
+  // The first object cannot grow over the reserved region
+  ASSERT(!arena->try_expand(arena->root<int>(), 64));
+  arena.reset();
+
+  std::remove(path);
+  ASSERT(PersistentArena::open(path) == nullptr);
+
+  // Files that are not arenas are rejected
+  std::FILE *file = std::fopen(path, "wb");
+  std::vector<char> garbage(8192, 'x');
+  std::fwrite(garbage.data(), 1, garbage.size(), file);
+  std::fclose(file);
+  ASSERT(PersistentArena::open(path) == nullptr);
+  std::remove(path);
+}
+
+// ============================================================================
+// NUMA Tests
+// ============================================================================
+
+void test_numa_topology() {
+  ASSERT(os::numa_node_count() >= 1);
+  int node = os::current_numa_node();
+  ASSERT(node >= 0 && static_cast<size_t>(node) < os::numa_node_count());
+
+  // mbind may be unavailable (e.g. seccomp); placement is best-effort
+  constexpr size_t SIZE = 1024 * 1024;
+  void *memory = os::map(SIZE);
+  if (os::set_numa_policy(memory, SIZE, os::NumaPolicy::bind, node)) {
+    std::memset(memory, 1, SIZE);
+    int placed = os::numa_node_of(memory);
+    ASSERT(placed == -1 || placed == node);
+  }
+  ASSERT(!os::set_numa_policy(memory, SIZE, os::NumaPolicy::bind,
+                              static_cast<int>(os::numa_node_count())));
+  os::unmap(memory, SIZE);
+}
+
+void test_numa_pool_selector_basic() {
+  NumaPoolSelector selector(64, 100);
+  int local = os::current_numa_node();
+  ASSERT(selector.node_count() == os::numa_node_count());
+  ASSERT(!selector.has_pool(local)); // Created lazily
+
+  void *p = selector.allocate(64);
+  ASSERT(p != nullptr && selector.owns(p));
+  ASSERT(selector.node_of(p) == local && selector.has_pool(local));
+  ASSERT(selector.used_size() == 64);
+  ASSERT(selector.allocate(65) == nullptr);
+  selector.deallocate(p);
+  ASSERT(selector.used_size() == 0);
+
+  // Exhausting the local pool spills to other nodes, then fails
+  std::vector<void *> chunks;
+  while (void *chunk = selector.allocate())
+    chunks.push_back(chunk);
+  ASSERT(chunks.size() >= 100 * selector.node_count());
+  for (void *chunk : chunks)
+    selector.deallocate(chunk);
+  ASSERT(selector.used_size() == 0);
+  ASSERT(!selector.owns(&selector));
+}
+
+void test_numa_pool_selector_threads() {
+  NumaPoolSelector selector(32, 256, os::NumaPolicy::first_touch);
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 5000; ++i) {
+        void *chunk = selector.allocate();
+        if (!chunk || selector.node_of(chunk) < 0)
+          ++failures;
+        selector.deallocate(chunk);
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  ASSERT(failures == 0);
+  ASSERT(selector.used_size() == 0);
+  ASSERT(selector.placement_applied(os::current_numa_node()));
+}
+
+// ============================================================================
+// Prefault Tests
+// ============================================================================
+
+// Number of resident pages in a page-aligned range
+size_t resident_pages(void *ptr, size_t size) {
+  size_t pages = size / os::page_size();
+  std::vector<unsigned char> residency(pages);
+  if (::mincore(ptr, size, residency.data()) != 0)
+    return 0;
+  size_t resident = 0;
+  for (unsigned char page : residency)
+    resident += page & 1;
+  return resident;
+}
+
+void test_os_prefault() {
+  constexpr size_t SIZE = 256 * 4096;
+  char *memory = static_cast<char *>(os::map(SIZE));
+  ASSERT(resident_pages(memory, SIZE) == 0);
+  memory[5] = 7;
+
+  os::prefault(memory, SIZE);
+  ASSERT(resident_pages(memory, SIZE) == SIZE / os::page_size());
+  ASSERT(memory[5] == 7 && memory[SIZE - 1] == 0);
+
+  // Warming up on another thread loses none of the owner's stores
+  char *fresh = static_cast<char *>(os::map(SIZE));
+  std::thread warmup([&]() { os::prefault(fresh, SIZE); });
+  for (size_t i = 0; i < SIZE; i += 64)
+    fresh[i] = static_cast<char>(i / 64);
+  warmup.join();
+  for (size_t i = 0; i < SIZE; i += 64)
+    ASSERT(fresh[i] == static_cast<char>(i / 64));
+
+  os::unmap(memory, SIZE);
+  os::unmap(fresh, SIZE);
+}
+
+void test_pool_prefault_options() {
+  PoolOptions options;
+  options.prefault = true;
+  options.lock_memory = true;
+  PoolAllocator pool(16 * 1024, 8, alignof(std::max_align_t), options);
+
+  // Locking is best effort (RLIMIT_MEMLOCK); allocation works either way
+  char *chunk = static_cast<char *>(pool.allocate());
+  std::memset(chunk, 0x5A, 16 * 1024);
+  ASSERT(chunk[16 * 1024 - 1] == 0x5A);
+  bool locked = pool.locked();
+  PoolAllocator moved(std::move(pool));
+  ASSERT(moved.locked() == locked && !pool.locked());
+  moved.deallocate(chunk);
+
+  PoolAllocator plain(64, 8);
+  ASSERT(!plain.locked());
+}
+
+void test_stack_prefault_options() {
+  StackOptions options;
+  options.prefault = true;
+  StackAllocator stack(1024 * 1024, options);
+  ASSERT(!stack.locked());
+  char *p = static_cast<char *>(stack.allocate(4096));
+  std::memset(p, 1, 4096);
+
+  // Warm-up of an already running allocator
+  StackAllocator cold(1024 * 1024);
+  std::thread warmup([&]() { cold.prefault(); });
+  char *q = static_cast<char *>(cold.allocate(100));
+  std::memset(q, 2, 100);
+  warmup.join();
+  ASSERT(q[99] == 2);
+}
+
+// ============================================================================
+// Trim Tests
+// ============================================================================
+
+void test_stack_trim() {
+  const size_t page = os::page_size();
+  const size_t SIZE = 64 * page;
+  void *buffer = os::map(SIZE);
+  StackAllocator stack(buffer, SIZE);
+
+  std::memset(stack.allocate(48 * page, page), 1, 48 * page);
+  stack.reset();
+  char *kept = static_cast<char *>(stack.allocate(8 * page, page));
+  std::memset(kept, 2, 8 * page);
+
+  ASSERT(stack.trim() == 56 * page);
+  ASSERT(resident_pages(buffer, SIZE) == 8);
+  ASSERT(stack.trim() == 0); // Nothing dirtied since
+  ASSERT(kept[8 * page - 1] == 2);
+
+  // A budget releases the highest pages first and resumes below them
+  StackAllocator::Marker marker = stack.get_marker();
+  std::memset(stack.allocate(32 * page, page), 3, 32 * page);
+  stack.rollback(marker);
+  ASSERT(stack.trim(4 * page) == 4 * page);
+  ASSERT(resident_pages(static_cast<char *>(buffer) + 36 * page, 4 * page) == 0);
+  ASSERT(resident_pages(static_cast<char *>(buffer) + 8 * page, 28 * page) == 28);
+  ASSERT(stack.trim() == 28 * page);
+  ASSERT(resident_pages(buffer, SIZE) == 8);
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_pool_trim() {
+  const size_t page = os::page_size();
+  const size_t SIZE = 64 * page;
+  const size_t CHUNK = 512;
+  void *buffer = os::map(SIZE);
+  PoolOptions options;
+  options.trimmable = true;
+  PoolAllocator pool(buffer, SIZE, CHUNK, alignof(std::max_align_t), options);
+  const size_t count = pool.chunk_count();
+
+  std::vector<char *> chunks;
+  while (char *chunk = static_cast<char *>(pool.allocate()))
+    chunks.push_back(chunk);
+  ASSERT(chunks.size() == count);
+  ASSERT(pool.trim() == 0); // Nothing free
+
+  // Keep one chunk on page 0 and one on page 10
+  char *low = chunks[0];
+  char *mid = chunks[10 * page / CHUNK + 3];
+  std::memset(low, 0x11, CHUNK);
+  std::memset(mid, 0x22, CHUNK);
+  for (char *chunk : chunks)
+    if (chunk != low && chunk != mid)
+      pool.deallocate(chunk);
+
+  ASSERT(pool.trim(4 * page) == 4 * page);
+  ASSERT(pool.trim() == 58 * page);
+  ASSERT(pool.trim() == 0);
+  ASSERT(resident_pages(buffer, SIZE) == 2);
+  ASSERT(pool.free_count() == count - 2);
+
+  // Every free chunk is still handed out exactly once
+  std::vector<char *> again;
+  while (char *chunk = static_cast<char *>(pool.allocate())) {
+    ASSERT(pool.owns(chunk) && chunk != low && chunk != mid);
+    std::memset(chunk, 0x33, CHUNK);
+    again.push_back(chunk);
+  }
+  ASSERT(again.size() == count - 2);
+  std::sort(again.begin(), again.end());
+  ASSERT(std::adjacent_find(again.begin(), again.end()) == again.end());
+  ASSERT(low[CHUNK - 1] == 0x11 && mid[0] == 0x22);
+
+  // Released chunks come back before reset() relinks everything
+  for (char *chunk : again)
+    pool.deallocate(chunk);
+  ASSERT(pool.trim() == 62 * page);
+  pool.reset();
+  ASSERT(pool.free_count() == count);
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_pool_address_ordered_trim() {
+  const size_t page = os::page_size();
+  const size_t SIZE = 16 * page;
+  void *buffer = os::map(SIZE);
+  PoolOptions options;
+  options.address_ordered = true;
+  PoolAllocator pool(buffer, SIZE, page / 4, page / 4, options);
+
+  std::vector<char *> chunks;
+  while (char *chunk = static_cast<char *>(pool.allocate())) {
+    std::memset(chunk, 1, page / 4);
+    chunks.push_back(chunk);
+  }
+  ASSERT(chunks.size() == 64);
+
+  // Empty pages 2 and 8..15; page 0 keeps three of its four chunks
+  pool.deallocate(chunks[0]);
+  for (size_t i = 8; i < 12; ++i)
+    pool.deallocate(chunks[i]);
+  for (size_t i = 32; i < 64; ++i)
+    pool.deallocate(chunks[i]);
+  ASSERT(pool.trim(2 * page) == 2 * page);
+  ASSERT(pool.trim() == 7 * page);
+  ASSERT(pool.trim() == 0);
+  ASSERT(resident_pages(buffer, SIZE) == 7);
+
+  // Resident free chunks are handed out before released pages
+  ASSERT(pool.allocate() == chunks[0]);
+  char *reused = static_cast<char *>(pool.allocate());
+  ASSERT(reused != nullptr && (reused - chunks[0]) % page == 0);
+  std::memset(reused, 2, page / 4);
+  ASSERT(resident_pages(buffer, SIZE) == 8);
+  pool.deallocate(reused);
+  ASSERT(pool.trim() == page);
+
+  // reset() leaves released pages alone
+  pool.reset();
+  ASSERT(pool.free_count() == 64);
+  ASSERT(resident_pages(buffer, SIZE) == 7);
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_pool_trim_incremental() {
+  const size_t page = os::page_size();
+  const size_t PAGES = 1024;
+  const size_t SIZE = PAGES * page;
+  const size_t CHUNK = page / 4;
+  void *buffer = os::map(SIZE);
+  os::prefault(buffer, SIZE);
+  PoolOptions options;
+  options.trimmable = true;
+  PoolAllocator pool(buffer, SIZE, CHUNK, alignof(std::max_align_t), options);
+
+  // A one-page budget releases one page per call, highest first
+  for (size_t i = 1; i <= 3; ++i) {
+    ASSERT(pool.trim(page) == page);
+    ASSERT(resident_pages(buffer, SIZE) == PAGES - i);
+  }
+
+  // Only page 0 is free: a budgeted call examines a bounded window, and
+  // the cursor carries the search down to page 0 over several calls
+  std::vector<void *> chunks;
+  while (void *chunk = pool.allocate())
+    chunks.push_back(chunk);
+  ASSERT(chunks.size() == pool.chunk_count());
+  for (void *chunk : chunks)
+    if (static_cast<char *>(chunk) < static_cast<char *>(buffer) + page)
+      pool.deallocate(chunk);
+  size_t calls = 1;
+  while (pool.trim(page) == 0 && calls < PAGES)
+    ++calls;
+  ASSERT(calls > 1 && calls < 8);
+  ASSERT(resident_pages(buffer, page) == 0);
+
+  // Without the per-page counts (the default) there is nothing to go on
+  PoolAllocator untracked(buffer, SIZE, CHUNK);
+  ASSERT(untracked.trim() == 0);
+  ASSERT(untracked.allocate() == buffer);
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_pool_trim_churn() {
+  const size_t page = os::page_size();
+  const size_t SIZE = 64 * page;
+  const size_t CHUNK = page * 3 / 8; // Chunks straddle page boundaries
+  void *buffer = os::map(SIZE);
+  PoolOptions options;
+  options.trimmable = true;
+  PoolAllocator pool(buffer, SIZE, CHUNK, alignof(std::max_align_t), options);
+  const size_t count = pool.chunk_count();
+
+  // Trims interleaved with allocation never hand out a chunk twice or
+  // lose one, and never release memory under a live chunk
+  std::mt19937 rng(47);
+  std::vector<unsigned char *> live;
+  size_t released = 0;
+  for (int round = 0; round < 20000; ++round) {
+    if (live.size() < count && (live.empty() || rng() % 3 != 0)) {
+      auto *chunk = static_cast<unsigned char *>(pool.allocate());
+      ASSERT(chunk != nullptr);
+      std::memset(chunk, static_cast<int>(live.size() | 1) & 0xff, CHUNK);
+      live.push_back(chunk);
+    } else {
+      size_t victim = rng() % live.size();
+      std::swap(live[victim], live.back());
+      ASSERT(live.back()[0] != 0 && live.back()[CHUNK - 1] == live.back()[0]);
+      pool.deallocate(live.back());
+      live.pop_back();
+    }
+    if (round % 97 == 0) {
+      // Drop most chunks now and then so whole pages come free
+      while (live.size() > 8) {
+        pool.deallocate(live.back());
+        live.pop_back();
+      }
+      released += pool.trim(2 * page);
+    }
+    ASSERT(pool.free_count() == count - live.size());
+  }
+  ASSERT(released > 0);
+
+  while (void *chunk = pool.allocate())
+    live.push_back(static_cast<unsigned char *>(chunk));
+  ASSERT(live.size() == count);
+  std::sort(live.begin(), live.end());
+  ASSERT(std::adjacent_find(live.begin(), live.end()) == live.end());
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_freelist_trim() {
+  const size_t page = os::page_size();
+  const size_t SIZE = 64 * page;
+  void *buffer = os::map(SIZE);
+  FreeListAllocator alloc(buffer, SIZE);
+
+  char *a = static_cast<char *>(alloc.allocate(100));
+  char *b = static_cast<char *>(alloc.allocate(40 * page));
+  char *c = static_cast<char *>(alloc.allocate(100));
+  std::memset(a, 1, 100);
+  std::memset(b, 2, 40 * page);
+  std::memset(c, 3, 100);
+  alloc.deallocate(b);
+
+  // The hole loses at most its partial first and last pages; the tail
+  // block after c is released too
+  size_t released = alloc.trim();
+  ASSERT(released >= 38 * page + 20 * page);
+  ASSERT(alloc.trim() == 0); // Already trimmed
+  ASSERT(a[99] == 1 && c[99] == 3);
+
+  // Reusing the hole faults it back in and clears its trimmed state
+  b = static_cast<char *>(alloc.allocate(40 * page));
+  std::memset(b, 4, 40 * page);
+  ASSERT(b[40 * page - 1] == 4);
+  alloc.deallocate(b);
+  ASSERT(alloc.trim() >= 38 * page);
+  alloc.deallocate(a);
+  alloc.deallocate(c);
+  ASSERT(alloc.free_block_count() == 1);
+
+  os::unmap(buffer, SIZE);
+}
+
+void test_trim_service() {
+  const size_t page = os::page_size();
+  void *buffer = os::map(64 * page);
+  PoolOptions pool_options;
+  pool_options.trimmable = true;
+  PoolAllocator pool(buffer, 64 * page, page, page, pool_options);
+  ThreadSafeAllocator<PoolAllocator> safe_pool(pool);
+
+  TrimOptions options;
+  options.interval = std::chrono::milliseconds(1);
+  options.max_bytes_per_pass = 8 * page;
+  TrimService trimmer(options);
+  trimmer.add(safe_pool);
+
+  // A busy allocator is skipped, not waited for
+  {
+    std::lock_guard<std::mutex> lock(safe_pool.mutex());
+    ASSERT(trimmer.run_once() == 0);
+  }
+  ASSERT(trimmer.busy_skips() == 1);
+  ASSERT(trimmer.run_once() == 8 * page); // Budget per pass
+
+  // Allocating and freeing while the thread trims in the background
+  ASSERT(trimmer.start() && !trimmer.start());
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 2; ++t) {
+    workers.emplace_back([&safe_pool, page, t]() {
+      for (int round = 0; round < 200; ++round) {
+        char *chunk = static_cast<char *>(safe_pool.allocate(page));
+        if (chunk) {
+          std::memset(chunk, t + 1, page);
+          ASSERT(chunk[page - 1] == t + 1);
+          safe_pool.deallocate(chunk);
+        }
+        if (round % 50 == 0)
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+  trimmer.stop();
+  ASSERT(!trimmer.running() && trimmer.passes() > 2);
+  ASSERT(trimmer.released_bytes() >= 8 * page);
+
+  trimmer.remove(pool);
+  size_t released = trimmer.released_bytes();
+  ASSERT(trimmer.run_once() == 0 && trimmer.released_bytes() == released);
+
+  size_t chunks = 0;
+  while (safe_pool.allocate(page))
+    ++chunks;
+  ASSERT(chunks == 64);
+
+  os::unmap(buffer, 64 * page);
+}
+
+// ============================================================================
+// Concurrent Stack Allocator Tests
+// ============================================================================
+
+void test_concurrent_stack_basic() {
+  ConcurrentStackAllocator alloc(64 * 1024, 4096);
+
+  void *p1 = alloc.allocate(100);
+  void *p2 = alloc.allocate(100, 32);
+  ASSERT(p1 != nullptr && p2 != nullptr);
+  ASSERT(utils::is_aligned(p2, 32));
+  ASSERT(static_cast<char *>(p2) >= static_cast<char *>(p1) + 100);
+  ASSERT(alloc.used_size() == 4096); // One sub-block reserved
+
+  void *large = alloc.allocate(10000); // Bypasses the sub-block
+  ASSERT(alloc.owns(large));
+  ASSERT(alloc.allocate(64 * 1024) == nullptr);
+
+  alloc.reset();
+  ASSERT(alloc.used_size() == 0);
+  ASSERT(alloc.allocate(100) == p1); // Stale sub-block dropped
+}
+
+void test_concurrent_stack_small_arena() {
+  // Smaller than the default sub-block: one sub-block spans the arena
+  ConcurrentStackAllocator small(32 * 1024);
+  ASSERT(small.sub_block_size() == 32 * 1024);
+  size_t count = 0;
+  while (small.allocate(16) != nullptr)
+    ++count;
+  ASSERT(count == 32 * 1024 / 16);
+  ASSERT(small.used_size() == 32 * 1024);
+
+  // Huge sizes and alignments fail instead of wrapping around
+  small.reset();
+  ASSERT(small.allocate(SIZE_MAX) == nullptr);
+  ASSERT(small.allocate(64, size_t(1) << 63) == nullptr);
+  ASSERT(small.allocate(16) != nullptr);
+}
+
+void test_concurrent_stack_tail() {
+  // 100KB with 64KB sub-blocks: the second reservation gets the 36KB tail
+  ConcurrentStackAllocator alloc(100 * 1024);
+  std::vector<char *> ptrs;
+  while (char *p = static_cast<char *>(alloc.allocate(1024))) {
+    ASSERT(alloc.owns(p) && alloc.owns(p + 1023));
+    ptrs.push_back(p);
+  }
+  ASSERT(ptrs.size() == 100);
+  ASSERT(alloc.used_size() == 100 * 1024);
+
+  // A large request that only partly fits the tail fails without overrun
+  alloc.reset();
+  ASSERT(alloc.allocate(90 * 1024) != nullptr);
+  ASSERT(alloc.allocate(40 * 1024) == nullptr);
+  ASSERT(alloc.allocate(16) == nullptr);
+}
+
+void test_concurrent_stack_threads() {
+  constexpr size_t THREADS = 4;
+  constexpr size_t PER_THREAD = 2000;
+  ConcurrentStackAllocator alloc(THREADS * PER_THREAD * 64 * 2, 4096);
+
+  for (int round = 0; round < 2; ++round) {
+    std::vector<std::vector<char *>> results(THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < PER_THREAD; ++i) {
+          char *p = static_cast<char *>(alloc.allocate(48));
+          std::memset(p, static_cast<int>(t + 1), 48);
+          results[t].push_back(p);
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    // No two threads received overlapping memory
+    for (size_t t = 0; t < THREADS; ++t) {
+      ASSERT(results[t].size() == PER_THREAD);
+      for (char *p : results[t]) {
+        ASSERT(p[0] == static_cast<char>(t + 1) &&
+               p[47] == static_cast<char>(t + 1));
+      }
+    }
+    alloc.reset(); // Quiescent point: all workers joined
+  }
+}
+
+// ============================================================================
+// Thread-Local Arena Tests
+// ============================================================================
+
+void test_thread_local_arena_per_thread() {
+  ThreadLocalArena arenas({4096, nullptr});
+
+  StackAllocator &mine = arenas.local();
+  ASSERT(&arenas.local() == &mine);
+  ASSERT(mine.total_size() == 4096);
+  ASSERT(mine.allocate(100) != nullptr);
+
+  StackAllocator *theirs = nullptr;
+  std::thread worker([&]() {
+    theirs = &arenas.local();
+    theirs->allocate(200);
+  });
+  worker.join();
+  ASSERT(theirs != &mine);
+
+  arenas.reset_all();
+  ASSERT(arenas.used_size() == 0);
+}
+
+void test_thread_local_arena_recycling() {
+  FreeListAllocator backing(64 * 1024);
+  ThreadLocalArena arenas({4096, &backing});
+
+  StackAllocator *first = nullptr;
+  StackAllocator *second = nullptr;
+  std::thread([&]() {
+    first = &arenas.local();
+    first->allocate(512);
+  }).join();
+  ASSERT(arenas.active_count() == 0);
+  std::thread([&]() { second = &arenas.local(); }).join();
+
+  // The exited thread's arena was reset and handed to the next thread
+  ASSERT(second == first);
+  ASSERT(second->used_size() == 0);
+  ASSERT(arenas.arena_count() == 1);
+  ASSERT(backing.used_size() > 0);
+}
+
+void test_tls_frame() {
+  StackAllocator &frame = tls_frame();
+  ASSERT(&tls_frame() == &frame);
+  ASSERT(&ThreadLocalArena::global().local() == &frame);
+  ASSERT(!ThreadLocalArena::configure_global({4096, nullptr}));
+
+  StackAllocator *other = nullptr;
+  std::thread([&]() { other = &tls_frame(); }).join();
+  ASSERT(other != &frame);
+}
+
+// ============================================================================
+// Buddy Allocator Tests
+// ============================================================================
+
+void test_buddy_basic_allocation() {
+  BuddyAllocator buddy(4096, 64);
+  ASSERT(buddy.total_size() == 4096);
+  ASSERT(buddy.largest_free_block() == 4096);
+
+  void *p1 = buddy.allocate(100); // Rounded to 128
+  ASSERT(p1 != nullptr);
+  ASSERT(buddy.owns(p1));
+  ASSERT(buddy.block_size(p1) == 128);
+  ASSERT(buddy.used_size() == 128);
+  ASSERT(buddy.largest_free_block() == 2048);
+
+  void *p2 = buddy.allocate(64);
+  ASSERT(p2 != nullptr);
+  ASSERT(buddy.block_size(p2) == 64);
+  ASSERT(buddy.used_size() == 192);
+}
+
+void test_buddy_natural_alignment() {
+  BuddyAllocator buddy(1 << 16, 64);
+
+  for (size_t size = 64; size <= 8192; size *= 2) {
+    void *p = buddy.allocate(size);
+    ASSERT(p != nullptr);
+    ASSERT(utils::is_aligned(p, size));
+  }
+
+  // Alignment larger than the size selects a larger block
+  void *p = buddy.allocate(64, 4096);
+  ASSERT(p != nullptr);
+  ASSERT(utils::is_aligned(p, 4096));
+}
+
+void test_buddy_merge() {
+  BuddyAllocator buddy(4096, 64);
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    void *p = buddy.allocate(64);
+    ASSERT(p != nullptr);
+    ptrs.push_back(p);
+  }
+  ASSERT(buddy.allocate(64) == nullptr);
+  ASSERT(buddy.largest_free_block() == 0);
+
+  // Free every other block: no buddies can merge
+  for (size_t i = 0; i < ptrs.size(); i += 2) {
+    buddy.deallocate(ptrs[i]);
+  }
+  ASSERT(buddy.free_block_count(0) == 32);
+  ASSERT(buddy.largest_free_block() == 64);
+
+  // Free the rest: everything merges back into one block
+  for (size_t i = 1; i < ptrs.size(); i += 2) {
+    buddy.deallocate(ptrs[i]);
+  }
+  ASSERT(buddy.used_size() == 0);
+  ASSERT(buddy.free_block_count(0) == 0);
+  ASSERT(buddy.largest_free_block() == 4096);
+  ASSERT(buddy.allocate(4096) != nullptr);
+}
+
+void test_buddy_reset() {
+  BuddyAllocator buddy(4096, 64);
+  buddy.allocate(1000);
+  buddy.allocate(500);
+  buddy.reset();
+  ASSERT(buddy.used_size() == 0);
+  ASSERT(buddy.largest_free_block() == 4096);
+}
+
+// ============================================================================
+// Handle Pool Tests
+// ============================================================================
+
+void test_handle_pool_basic() {
+  HandlePool<int> pool(4);
+  auto a = pool.create(10);
+  auto b = pool.create(20);
+  ASSERT(a != HandlePool<int>::NULL_HANDLE);
+  ASSERT(*pool.get(a) == 10 && *pool.get(b) == 20);
+  ASSERT(pool.size() == 2);
+
+  pool.create(30);
+  pool.create(40);
+  ASSERT(pool.create(50) == HandlePool<int>::NULL_HANDLE);
+  ASSERT(pool.get(HandlePool<int>::NULL_HANDLE) == nullptr);
+}
+
+void test_handle_pool_stale_handles() {
+  HandlePool<int, uint64_t> pool(2);
+  auto a = pool.create(1);
+  pool.destroy(a);
+  ASSERT(!pool.valid(a));
+  ASSERT(pool.get(a) == nullptr);
+
+  // The slot is reused with a new generation; the old handle stays stale
+  auto b = pool.create(2);
+  ASSERT((b & 0xFFFFFFFF) == (a & 0xFFFFFFFF));
+  ASSERT(b != a);
+  ASSERT(pool.get(a) == nullptr);
+  ASSERT(*pool.get(b) == 2);
+
+  pool.destroy(a); // Stale destroy is ignored
+  ASSERT(pool.size() == 1);
+}
+
+void test_handle_pool_compact() {
+  HandlePool<std::string> pool(100);
+  std::vector<HandlePool<std::string>::handle_type> handles;
+  for (int i = 0; i < 100; ++i) {
+    handles.push_back(pool.create("object " + std::to_string(i)));
+  }
+  for (size_t i = 0; i < handles.size(); ++i) {
+    if (i % 4 != 0)
+      pool.destroy(handles[i]);
+  }
+  ASSERT(pool.size() == 25);
+  ASSERT(pool.density() < 0.5);
+
+  size_t moved = pool.compact();
+  ASSERT(moved > 0);
+  ASSERT(pool.span() == 25);
+  ASSERT(pool.density() == 1.0);
+
+  // Handles survive compaction and objects were moved intact
+  for (size_t i = 0; i < handles.size(); i += 4) {
+    ASSERT(*pool.get(handles[i]) == "object " + std::to_string(i));
+  }
+  size_t visited = 0;
+  pool.for_each([&](std::string &) { ++visited; });
+  ASSERT(visited == 25);
+}
+
+// ============================================================================
+// STL Adapter Tests
+// ============================================================================
+
+void test_stl_adapter_reallocate() {
+  StackAllocator stack(4096);
+  STLAdapter<int, StackAllocator> adapter(stack);
+
+  auto result = adapter.allocate_at_least(16);
+  ASSERT(result.ptr != nullptr && result.count >= 16);
+  for (int i = 0; i < 16; ++i) {
+    result.ptr[i] = i;
+  }
+
+  // Top of the stack: grows without copying
+  ASSERT(adapter.try_expand(result.ptr, 64));
+  int *grown = adapter.reallocate(result.ptr, 64, 256);
+  ASSERT(grown == result.ptr);
+
+  // Pool chunks cannot grow past the chunk size
+  PoolAllocator pool(64, 4);
+  STLAdapter<int, PoolAllocator> pool_adapter(pool);
+  int *small = pool_adapter.allocate(8);
+  small[7] = 42;
+  ASSERT(pool_adapter.try_expand(small, 16));
+  ASSERT(!pool_adapter.try_expand(small, 32));
+  bool threw = false;
+  try {
+    pool_adapter.reallocate(small, 16, 32);
+  } catch (const std::bad_alloc &) {
+    threw = true;
+  }
+  ASSERT(threw);
+  ASSERT(small[7] == 42);
+}
+
 // ============================================================================
 // Memory Write Tests (ensure allocated memory is usable)
 // ============================================================================
@@ -308,6 +2068,127 @@ void test_freelist_memory_write() {
   alloc.deallocate(p);
 }
 
+// ============================================================================
+// Instrumentation Tests
+// ============================================================================
+
+void test_histogram_buckets() {
+  // Every bucket's upper bound must map back to the same bucket
+  for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+    uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+    ASSERT(LatencyHistogram::bucket_index(upper) == i);
+  }
+  ASSERT(LatencyHistogram::bucket_index(~uint64_t(0)) ==
+         LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+void test_histogram_percentiles() {
+  LatencyHistogram hist;
+  for (uint64_t v = 1; v <= 1000; ++v) {
+    hist.record(v);
+  }
+  ASSERT(hist.count() == 1000);
+  ASSERT(hist.min() == 1);
+  ASSERT(hist.max() == 1000);
+
+  // Log-linear buckets keep relative error within 1/16
+  uint64_t p50 = hist.percentile(50.0);
+  uint64_t p99 = hist.percentile(99.0);
+  ASSERT(p50 >= 500 && p50 <= 500 + 500 / 16);
+  ASSERT(p99 >= 990 && p99 <= 1000);
+
+  LatencyHistogram other;
+  other.record(5000);
+  hist.merge(other);
+  ASSERT(hist.count() == 1001);
+  ASSERT(hist.max() == 5000);
+  ASSERT(hist.percentile(100.0) == 5000);
+}
+
+void test_instrumented_sampling() {
+  PoolAllocator pool(64, 100);
+  InstrumentedAllocator<PoolAllocator> timed(pool, 4);
+
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    void *p = timed.allocate(64);
+    ASSERT(p != nullptr);
+    ptrs.push_back(p);
+  }
+  for (void *p : ptrs) {
+    timed.deallocate(p);
+  }
+
+  // One in four calls is timed (allocations and frees share a countdown)
+  ASSERT(timed.allocate_latency().count() == 16);
+  ASSERT(timed.deallocate_latency().count() == 16);
+  ASSERT(pool.free_count() == 100);
+
+  // Interleaved wrappers keep their own countdowns
+  PoolAllocator other_pool(64, 100);
+  InstrumentedAllocator<PoolAllocator> every_call(other_pool, 1);
+  InstrumentedAllocator<PoolAllocator> again(pool, 4);
+  for (int i = 0; i < 32; ++i) {
+    every_call.deallocate(every_call.allocate(64));
+    again.deallocate(again.allocate(64));
+  }
+  ASSERT(every_call.allocate_latency().count() == 32);
+  ASSERT(every_call.deallocate_latency().count() == 32);
+  ASSERT(again.allocate_latency().count() +
+             again.deallocate_latency().count() ==
+         16);
+
+  // Threads sharing a wrapper count down separately, each timing exactly
+  // one call in four; reads merge every thread's histograms
+  ThreadSafeAllocator<PoolAllocator> safe(other_pool);
+  InstrumentedAllocator<ThreadSafeAllocator<PoolAllocator>> shared(safe, 4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&shared]() {
+      for (int i = 0; i < 64; ++i)
+        shared.deallocate(shared.allocate(64), 64);
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  ASSERT(shared.allocate_latency().count() +
+             shared.deallocate_latency().count() ==
+         4 * 128 / 4);
+  shared.clear_latency();
+  ASSERT(shared.allocate_latency().count() == 0);
+}
+
+void test_trace_roundtrip() {
+  const char *path = "allocx_test.trace";
+  FreeListAllocator heap(4096);
+  void *p1 = nullptr;
+  {
+    TraceWriter writer(path);
+    ASSERT(writer.is_open());
+    TracingAllocator<FreeListAllocator> traced(heap, writer);
+
+    p1 = traced.allocate(100, 16);
+    void *p2 = traced.allocate(8192); // Fails, recorded with id 0
+    ASSERT(p2 == nullptr);
+    traced.deallocate(p1, 100);
+    traced.reset();
+  }
+
+  std::vector<TraceRecord> trace;
+  ASSERT(read_trace(path, trace));
+  std::remove(path);
+
+  ASSERT(trace.size() == 4);
+  ASSERT(trace[0].op == TraceOp::Allocate);
+  ASSERT(trace[0].size == 100 && trace[0].align_log2 == 4);
+  ASSERT(trace[0].ptr_id == reinterpret_cast<uintptr_t>(p1));
+  ASSERT(trace[1].op == TraceOp::Allocate && trace[1].ptr_id == 0);
+  ASSERT(trace[2].op == TraceOp::Deallocate);
+  ASSERT(trace[2].ptr_id == trace[0].ptr_id);
+  ASSERT(trace[3].op == TraceOp::Reset);
+  ASSERT(trace[0].tsc <= trace[3].tsc);
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -328,6 +2209,7 @@ int main() {
   TEST(stack_reset);
   TEST(stack_marker_rollback);
   TEST(stack_out_of_memory);
+  TEST(stack_try_expand);
   TEST(stack_memory_write);
 
   std::cout << "\nPool Allocator Tests:\n";
@@ -336,7 +2218,19 @@ int main() {
   TEST(pool_reuse);
   TEST(pool_exhaustion);
   TEST(pool_reset);
+  TEST(pool_for_each_allocated);
+  TEST(pool_for_each_allocated_parallel);
   TEST(pool_memory_write);
+  TEST(pool_cache_line_padding);
+  TEST(pool_prefetch);
+  TEST(pool_address_ordered);
+
+  std::cout << "\nSlab Cache Tests:\n";
+  TEST(slab_cache_constructed_state);
+  TEST(slab_cache_growth_and_reap);
+  TEST(slab_cache_coloring);
+  TEST(slab_cache_callbacks);
+  TEST(slab_cache_constructor_throws);
 
   std::cout << "\nFree-List Allocator Tests:\n";
   TEST(freelist_basic_allocation);
@@ -344,8 +2238,88 @@ int main() {
   TEST(freelist_variable_sizes);
   TEST(freelist_alignment);
   TEST(freelist_reset);
+  TEST(freelist_coalescing);
+  TEST(freelist_try_expand);
+  TEST(freelist_defragment);
+  TEST(freelist_defragment_pinned);
+  TEST(freelist_metrics);
+  TEST(freelist_heap_map);
   TEST(freelist_memory_write);
 
+  std::cout << "\nBitmap Pool Allocator Tests:\n";
+  TEST(bitmap_pool_basic_allocation);
+  TEST(bitmap_pool_lowest_address_first);
+  TEST(bitmap_pool_for_each_allocated);
+  TEST(bitmap_pool_reset);
+
+  std::cout << "\nHandle Pool Tests:\n";
+  TEST(handle_pool_basic);
+  TEST(handle_pool_stale_handles);
+  TEST(handle_pool_compact);
+
+  std::cout << "\nLarge Object Allocator Tests:\n";
+  TEST(large_object_basic);
+  TEST(large_object_cache);
+  TEST(large_object_reallocate);
+  TEST(large_object_fallback);
+
+  std::cout << "\nShared Pool Allocator Tests:\n";
+  TEST(shared_pool_basic);
+  TEST(shared_pool_attach);
+  TEST(shared_pool_cross_process);
+  TEST(shared_pool_threads);
+  TEST(shared_pool_counts_in_range);
+
+  std::cout << "\nPersistent Arena Tests:\n";
+  TEST(offset_ptr);
+  TEST(persistent_arena_reopen);
+  TEST(persistent_arena_restore);
+
+  std::cout << "\nNUMA Tests:\n";
+  TEST(numa_topology);
+  TEST(numa_pool_selector_basic);
+  TEST(numa_pool_selector_threads);
+
+  std::cout << "\nPrefault Tests:\n";
+  TEST(os_prefault);
+  TEST(pool_prefault_options);
+  TEST(stack_prefault_options);
+
+  std::cout << "\nTrim Tests:\n";
+  TEST(stack_trim);
+  TEST(pool_trim);
+  TEST(pool_address_ordered_trim);
+  TEST(pool_trim_incremental);
+  TEST(pool_trim_churn);
+  TEST(freelist_trim);
+  TEST(trim_service);
+
+  std::cout << "\nConcurrent Stack Allocator Tests:\n";
+  TEST(concurrent_stack_basic);
+  TEST(concurrent_stack_small_arena);
+  TEST(concurrent_stack_tail);
+  TEST(concurrent_stack_threads);
+
+  std::cout << "\nThread-Local Arena Tests:\n";
+  TEST(thread_local_arena_per_thread);
+  TEST(thread_local_arena_recycling);
+  TEST(tls_frame);
+
+  std::cout << "\nBuddy Allocator Tests:\n";
+  TEST(buddy_basic_allocation);
+  TEST(buddy_natural_alignment);
+  TEST(buddy_merge);
+  TEST(buddy_reset);
+
+  std::cout << "\nSTL Adapter Tests:\n";
+  TEST(stl_adapter_reallocate);
+
+  std::cout << "\nInstrumentation Tests:\n";
+  TEST(histogram_buckets);
+  TEST(histogram_percentiles);
+  TEST(instrumented_sampling);
+  TEST(trace_roundtrip);
+
   std::cout << "\n✓ All tests passed!\n";
   return 0;
 }
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench_report.hpp"
+
+using namespace allocx;
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// Number of orderings of n1 + n2 samples whose U statistic equals u
+double exact_u_count(size_t u, size_t n1, size_t n2,
+                     std::map<std::vector<size_t>, double> &memo) {
+  if (n1 == 0 || n2 == 0)
+    return u == 0 ? 1.0 : 0.0;
+  std::vector<size_t> key = {u, n1, n2};
+  auto it = memo.find(key);
+  if (it != memo.end())
+    return it->second;
+  double count = exact_u_count(u, n1, n2 - 1, memo);
+  if (u >= n2)
+    count += exact_u_count(u - n2, n1 - 1, n2, memo);
+  memo[key] = count;
+  return count;
+}
+
+/**
+ * @brief Two-sided Mann-Whitney U test
+ *
+ * Uses the exact null distribution for small tie-free samples and the
+ * tie-corrected normal approximation otherwise.
+ *
+ * @return p-value (1.0 when either sample is empty)
+ */
+double mann_whitney_p(const std::vector<double> &a,
+                      const std::vector<double> &b) {
+  size_t n1 = a.size();
+  size_t n2 = b.size();
+  if (n1 == 0 || n2 == 0)
+    return 1.0;
+
+  // Rank the pooled samples, averaging ranks of ties
+  std::vector<std::pair<double, int>> pooled;
+  for (double v : a)
+    pooled.emplace_back(v, 0);
+  for (double v : b)
+    pooled.emplace_back(v, 1);
+  std::sort(pooled.begin(), pooled.end());
+
+  size_t n = pooled.size();
+  double rank_sum_a = 0;
+  double tie_term = 0;
+  for (size_t i = 0; i < n;) {
+    size_t j = i;
+    while (j < n && pooled[j].first == pooled[i].first)
+      ++j;
+    double rank = (static_cast<double>(i + j) + 1) / 2; // 1-based average
+    for (size_t k = i; k < j; ++k) {
+      if (pooled[k].second == 0)
+        rank_sum_a += rank;
+    }
+    double t = static_cast<double>(j - i);
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  double u1 = rank_sum_a - static_cast<double>(n1 * (n1 + 1)) / 2;
+  double u = std::min(u1, static_cast<double>(n1 * n2) - u1);
+
+  if (tie_term == 0 && n <= 20) {
+    std::map<std::vector<size_t>, double> memo;
+    double total = 0;
+    double tail = 0;
+    for (size_t k = 0; k <= n1 * n2; ++k) {
+      double count = exact_u_count(k, n1, n2, memo);
+      total += count;
+      if (static_cast<double>(k) <= u)
+        tail += count;
+    }
+    return std::min(1.0, 2 * tail / total);
+  }
+
+  double mean = static_cast<double>(n1 * n2) / 2;
+  double variance = static_cast<double>(n1 * n2) / 12 *
+                    (static_cast<double>(n + 1) -
+                     tie_term / static_cast<double>(n * (n - 1)));
+  if (variance <= 0)
+    return 1.0;
+  double z = (mean - u - 0.5) / std::sqrt(variance); // Continuity corrected
+  return std::min(1.0, std::erfc(std::max(z, 0.0) / std::sqrt(2.0)));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+void usage() {
+  std::cerr
+      << "Usage: allocx_bench_compare <baseline.csv> <candidate.csv>\n"
+         "         [--metric NAME] [--alpha P] [--threshold PERCENT]\n"
+         "  Compares per-benchmark samples (from allocx_benchmark --repeat N\n"
+         "  --csv FILE) with a Mann-Whitney U test. Exits with status 1 when\n"
+         "  a benchmark is significantly slower by more than the threshold.\n"
+         "  Defaults: --metric avg_ns --alpha 0.05 --threshold 5\n";
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+
+  std::string metric = "avg_ns";
+  double alpha = 0.05;
+  double threshold = 5.0;
+  for (int i = 3; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--metric") == 0 && i + 1 < argc) {
+      metric = argv[++i];
+    } else if (std::strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+      alpha = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+      threshold = std::strtod(argv[++i], nullptr);
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  std::vector<bench::Sample> baseline;
+  std::vector<bench::Sample> candidate;
+  if (!bench::Report::read_csv(argv[1], baseline)) {
+    std::cerr << "Cannot read " << argv[1] << "\n";
+    return 2;
+  }
+  if (!bench::Report::read_csv(argv[2], candidate)) {
+    std::cerr << "Cannot read " << argv[2] << "\n";
+    return 2;
+  }
+
+  // Group metric values by benchmark, preserving baseline order
+  std::vector<std::string> order;
+  std::map<std::string, std::vector<double>> base_values;
+  std::map<std::string, std::vector<double>> cand_values;
+  for (const bench::Sample &sample : baseline) {
+    double value = 0;
+    if (sample.get(metric, value)) {
+      if (base_values.find(sample.benchmark) == base_values.end())
+        order.push_back(sample.benchmark);
+      base_values[sample.benchmark].push_back(value);
+    }
+  }
+  for (const bench::Sample &sample : candidate) {
+    double value = 0;
+    if (sample.get(metric, value))
+      cand_values[sample.benchmark].push_back(value);
+  }
+
+  std::cout << "Metric: " << metric << " (alpha " << alpha << ", threshold "
+            << threshold << "%)\n\n";
+  std::cout << std::left << std::setw(44) << "Benchmark" << std::right
+            << std::setw(12) << "Baseline" << std::setw(12) << "Candidate"
+            << std::setw(10) << "Change" << std::setw(10) << "p-value"
+            << "  Verdict\n";
+
+  size_t regressions = 0;
+  for (const std::string &name : order) {
+    auto it = cand_values.find(name);
+    if (it == cand_values.end()) {
+      std::cout << std::left << std::setw(44) << name << "  (missing)\n";
+      continue;
+    }
+    const std::vector<double> &a = base_values[name];
+    const std::vector<double> &b = it->second;
+
+    double base_median = median(a);
+    double cand_median = median(b);
+    double change =
+        base_median != 0 ? (cand_median - base_median) / base_median * 100 : 0;
+    double p = mann_whitney_p(a, b);
+
+    const char *verdict = "same";
+    if (a.size() < 2 || b.size() < 2) {
+      verdict = "too few runs";
+    } else if (p < alpha && std::fabs(change) >= threshold) {
+      verdict = change > 0 ? "REGRESSION" : "improvement";
+      if (change > 0)
+        ++regressions;
+    }
+
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << base_median
+              << std::setw(12) << cand_median << std::showpos << std::setw(9)
+              << change << "%" << std::noshowpos << std::setprecision(4)
+              << std::setw(10) << p << "  " << verdict << "\n";
+  }
+
+  std::cout << "\n" << regressions << " significant regression(s)\n";
+  return regressions ? 1 : 0;
+}
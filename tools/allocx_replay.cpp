@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "allocx/freelist_allocator.hpp"
+#include "allocx/latency_histogram.hpp"
+#include "allocx/pool_allocator.hpp"
+#include "allocx/stack_allocator.hpp"
+#include "allocx/trace.hpp"
+#include "allocx/utils.hpp"
+
+using namespace allocx;
+
+// ============================================================================
+// Replay Targets
+// ============================================================================
+
+// Adapts malloc to IAllocator, tracking requested bytes as "used"
+class MallocAllocator : public IAllocator {
+public:
+  void *allocate(size_t size, size_t alignment) override {
+    void *ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+      ptr = std::malloc(size);
+    } else if (posix_memalign(&ptr, alignment, size) != 0) {
+      ptr = nullptr;
+    }
+    if (ptr)
+      m_used += size;
+    return ptr;
+  }
+
+  void deallocate(void *ptr, size_t size) override {
+    std::free(ptr);
+    m_used -= size;
+  }
+
+  bool owns(void *) const override { return true; }
+  size_t total_size() const override { return 0; }
+  size_t used_size() const override { return m_used; }
+
+private:
+  size_t m_used = 0;
+};
+
+// Statistics gathered from a pre-pass over the trace
+struct TraceStats {
+  size_t allocations = 0;
+  size_t max_size = 0;
+  size_t max_alignment = 1;
+  size_t peak_live_bytes = 0;
+  size_t peak_live_count = 0;
+  size_t bytes_between_resets = 0; // Peak bytes allocated between resets
+};
+
+TraceStats analyze(const std::vector<TraceRecord> &trace) {
+  TraceStats stats;
+  std::unordered_map<uint64_t, size_t> live;
+  size_t live_bytes = 0;
+  size_t since_reset = 0;
+
+  for (const TraceRecord &rec : trace) {
+    switch (rec.op) {
+    case TraceOp::Allocate:
+      ++stats.allocations;
+      stats.max_size = std::max<size_t>(stats.max_size, rec.size);
+      stats.max_alignment =
+          std::max(stats.max_alignment, size_t(1) << rec.align_log2);
+      since_reset += rec.size + (size_t(1) << rec.align_log2);
+      stats.bytes_between_resets =
+          std::max(stats.bytes_between_resets, since_reset);
+      if (rec.ptr_id) {
+        live[rec.ptr_id] = rec.size;
+        live_bytes += rec.size;
+      }
+      break;
+    case TraceOp::Deallocate: {
+      auto it = live.find(rec.ptr_id);
+      if (it != live.end()) {
+        live_bytes -= it->second;
+        live.erase(it);
+      }
+      break;
+    }
+    case TraceOp::Reset:
+      live.clear();
+      live_bytes = 0;
+      since_reset = 0;
+      break;
+    }
+    stats.peak_live_bytes = std::max(stats.peak_live_bytes, live_bytes);
+    stats.peak_live_count = std::max(stats.peak_live_count, live.size());
+  }
+  return stats;
+}
+
+std::unique_ptr<IAllocator> make_allocator(const std::string &name,
+                                           const TraceStats &stats,
+                                           size_t arena) {
+  if (name == "malloc")
+    return std::make_unique<MallocAllocator>();
+  if (name == "stack")
+    return std::make_unique<StackAllocator>(
+        arena ? arena : stats.bytes_between_resets + 1);
+  if (name == "pool") {
+    size_t chunk = std::max<size_t>(stats.max_size, 1);
+    size_t count = arena ? arena / chunk : stats.peak_live_count + 1;
+    return std::make_unique<PoolAllocator>(
+        chunk, count, std::max(stats.max_alignment, alignof(std::max_align_t)));
+  }
+
+  // Free-list arenas default to twice the peak live footprint plus headers
+  size_t freelist_arena =
+      arena ? arena
+            : 2 * stats.peak_live_bytes + 64 * (stats.peak_live_count + 1);
+  if (name == "freelist-first")
+    return std::make_unique<FreeListAllocator>(
+        freelist_arena, FreeListAllocator::Strategy::FirstFit);
+  if (name == "freelist-best")
+    return std::make_unique<FreeListAllocator>(
+        freelist_arena, FreeListAllocator::Strategy::BestFit);
+  if (name == "freelist-worst")
+    return std::make_unique<FreeListAllocator>(
+        freelist_arena, FreeListAllocator::Strategy::WorstFit);
+  return nullptr;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+struct Live {
+  void *ptr;
+  size_t size;
+};
+
+void replay(const std::string &name, const std::vector<TraceRecord> &trace,
+            const TraceStats &stats, size_t arena) {
+  std::unique_ptr<IAllocator> alloc = make_allocator(name, stats, arena);
+  if (!alloc) {
+    std::cerr << "Unknown allocator: " << name << "\n";
+    return;
+  }
+
+  std::unordered_map<uint64_t, Live> live;
+  live.reserve(stats.peak_live_count * 2);
+  LatencyHistogram alloc_latency;
+  LatencyHistogram free_latency;
+  size_t failures = 0;
+  size_t peak_used = 0;
+
+  uint64_t replay_start = utils::read_tsc();
+  for (const TraceRecord &rec : trace) {
+    switch (rec.op) {
+    case TraceOp::Allocate: {
+      size_t alignment = size_t(1) << rec.align_log2;
+      uint64_t start = utils::read_tsc();
+      void *ptr = alloc->allocate(rec.size, alignment);
+      alloc_latency.record(utils::read_tsc() - start);
+      if (!ptr) {
+        // Only count failures the original run did not also see
+        if (rec.ptr_id)
+          ++failures;
+        break;
+      }
+      if (rec.ptr_id) {
+        live[rec.ptr_id] = Live{ptr, rec.size};
+      }
+      peak_used = std::max(peak_used, alloc->used_size());
+      break;
+    }
+    case TraceOp::Deallocate: {
+      auto it = live.find(rec.ptr_id);
+      if (it == live.end())
+        break; // Allocation failed during replay
+      uint64_t start = utils::read_tsc();
+      alloc->deallocate(it->second.ptr, it->second.size);
+      free_latency.record(utils::read_tsc() - start);
+      live.erase(it);
+      break;
+    }
+    case TraceOp::Reset:
+      if (name == "malloc") {
+        for (auto &entry : live) {
+          alloc->deallocate(entry.second.ptr, entry.second.size);
+        }
+      } else {
+        alloc->reset();
+      }
+      live.clear();
+      break;
+    }
+  }
+  uint64_t replay_ticks = utils::read_tsc() - replay_start;
+
+  // Release whatever the trace left live
+  for (auto &entry : live) {
+    alloc->deallocate(entry.second.ptr, entry.second.size);
+  }
+
+  double ticks_per_ns = utils::tsc_ticks_per_ns();
+  double seconds = static_cast<double>(replay_ticks) / ticks_per_ns / 1e9;
+  double ops = static_cast<double>(alloc_latency.count() + free_latency.count());
+
+  std::cout << "  " << name << ":\n";
+  std::cout << "    Throughput: " << (seconds > 0 ? ops / seconds / 1e6 : 0)
+            << " Mops/s\n";
+  std::cout << "    Alloc:   ";
+  alloc_latency.dump(std::cout, ticks_per_ns, "ns");
+  std::cout << "\n    Dealloc: ";
+  free_latency.dump(std::cout, ticks_per_ns, "ns");
+  std::cout << "\n    Peak footprint: " << peak_used << " bytes";
+  if (alloc->total_size())
+    std::cout << " (arena " << alloc->total_size() << " bytes)";
+  std::cout << "\n    Failed allocations: " << failures << "\n";
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+void usage() {
+  std::cerr << "Usage: allocx_replay <trace-file> [--allocator NAME]... "
+               "[--arena BYTES]\n"
+               "  NAME: malloc, stack, pool, freelist-first, freelist-best,\n"
+               "        freelist-worst, all (default)\n"
+               "  Records from all threads are replayed on one thread in "
+               "timestamp order.\n";
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+
+  std::vector<std::string> allocators;
+  size_t arena = 0;
+  for (int i = 2; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--allocator") == 0 && i + 1 < argc) {
+      allocators.push_back(argv[++i]);
+    } else if (std::strcmp(argv[i], "--arena") == 0 && i + 1 < argc) {
+      arena = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (allocators.empty() ||
+      std::find(allocators.begin(), allocators.end(), "all") !=
+          allocators.end()) {
+    allocators = {"malloc",         "stack",         "pool",
+                  "freelist-first", "freelist-best", "freelist-worst"};
+  }
+
+  std::vector<TraceRecord> trace;
+  if (!read_trace(argv[1], trace)) {
+    std::cerr << "Cannot read trace: " << argv[1] << "\n";
+    return 1;
+  }
+  std::stable_sort(trace.begin(), trace.end(),
+                   [](const TraceRecord &a, const TraceRecord &b) {
+                     return a.tsc < b.tsc;
+                   });
+
+  TraceStats stats = analyze(trace);
+  std::cout << "Trace: " << trace.size() << " records, " << stats.allocations
+            << " allocations, peak live " << stats.peak_live_bytes
+            << " bytes in " << stats.peak_live_count << " blocks\n";
+
+  for (const std::string &name : allocators) {
+    replay(name, trace, stats, arena);
+  }
+  return 0;
+}